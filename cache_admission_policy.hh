@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <seastar/core/sstring.hh>
+#include "utils/frequency_sketch.hh"
+#include "seastarx.hh"
+
+// Decides whether a partition read from the underlying source may be
+// populated into cache, where it will eventually displace other entries.
+// Items are identified by a hash of their partition key.
+class cache_admission_policy {
+public:
+    virtual ~cache_admission_policy() = default;
+    // Called on every cache access to a partition, hit or miss.
+    virtual void on_access(uint64_t hash) noexcept = 0;
+    // Called when a partition is evicted from cache because of memory pressure.
+    virtual void on_eviction(uint64_t hash) noexcept = 0;
+    // Called on a miss, after on_access(). Returns true if the partition
+    // should be populated into cache.
+    virtual bool admit(uint64_t hash) noexcept = 0;
+    // Forgets all history, e.g. when the cache is cleared.
+    virtual void clear() noexcept = 0;
+};
+
+// TinyLFU: admits a partition only if it was accessed more frequently than
+// the most recently evicted one, so that a scan touching each partition
+// once doesn't push out the frequently read ones.
+//
+// The recorded victim is forgotten whenever the frequency sketch is aged,
+// so when the cache is no longer under pressure everything is admitted again.
+class tinylfu_admission_policy final : public cache_admission_policy {
+    utils::frequency_sketch _sketch;
+    std::optional<uint64_t> _victim;
+public:
+    explicit tinylfu_admission_policy(size_t sketch_width = 1 << 16)
+        : _sketch(sketch_width) {
+    }
+    virtual void on_access(uint64_t hash) noexcept override {
+        if (_sketch.record(hash)) {
+            _victim = std::nullopt;
+        }
+    }
+    virtual void on_eviction(uint64_t hash) noexcept override {
+        _victim = hash;
+    }
+    virtual bool admit(uint64_t hash) noexcept override {
+        return !_victim || _sketch.estimate(hash) > _sketch.estimate(*_victim);
+    }
+    virtual void clear() noexcept override {
+        _sketch.clear();
+        _victim = std::nullopt;
+    }
+};
+
+// Returns the policy with the given name, or nullptr for "lru", which
+// admits everything. Throws std::invalid_argument for unknown names.
+std::unique_ptr<cache_admission_policy> make_cache_admission_policy(const sstring& name);
@@ -189,6 +189,7 @@ future<> cache_flat_mutation_reader::process_static_row(db::timeout_clock::time_
         return _read_context->get_next_fragment(timeout).then([this] (mutation_fragment_opt&& sr) {
             if (sr) {
                 assert(sr->is_static_row());
+                _read_context->on_populated(sr->memory_usage(*_schema));
                 maybe_add_to_cache(sr->as_static_row());
                 push_mutation_fragment(std::move(*sr));
             }
@@ -284,6 +285,7 @@ future<> cache_flat_mutation_reader::read_from_underlying(db::timeout_clock::tim
         [this] { return _state != state::reading_from_underlying || is_buffer_full(); },
         [this] (mutation_fragment mf) {
             _read_context->cache().on_row_miss();
+            _read_context->on_populated(mf.memory_usage(*_schema));
             maybe_add_to_cache(mf);
             add_to_buffer(std::move(mf));
         },
@@ -19,9 +19,15 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <unordered_map>
+
 #include <lz4.h>
 #include <zlib.h>
 #include <snappy-c.h>
+#include <zstd.h>
+#include <zdict.h>
+
+#include <boost/range/numeric.hpp>
 
 #include "compress.hh"
 #include "utils/class_registrator.hh"
@@ -61,6 +67,36 @@ class deflate_processor: public compressor {
     size_t compress_max_size(size_t input_len) const override;
 };
 
+class zstd_processor: public compressor {
+    class dictionary;
+
+    int _compression_level = DEFAULT_COMPRESSION_LEVEL;
+    size_t _dictionary_size = 0;
+    // Engaged only for instances returned by with_dictionary().
+    std::shared_ptr<const dictionary> _dictionary;
+public:
+    static constexpr int DEFAULT_COMPRESSION_LEVEL = 3;
+    static constexpr size_t MAX_DICTIONARY_SIZE = 64 * 1024;
+
+    static const sstring COMPRESSION_LEVEL;
+    static const sstring DICTIONARY_SIZE_IN_KB;
+
+    zstd_processor(const opt_getter&);
+
+    size_t uncompress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress_max_size(size_t input_len) const override;
+
+    std::set<sstring> option_names() const override;
+    std::map<sstring, sstring> options() const override;
+
+    size_t dictionary_size() const override;
+    bytes train_dictionary(const std::vector<temporary_buffer<char>>& samples) const override;
+    shared_ptr<compressor> with_dictionary(bytes_view dictionary) const override;
+};
+
 compressor::compressor(sstring name)
     : _name(std::move(name))
 {}
@@ -73,6 +109,18 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+size_t compressor::dictionary_size() const {
+    return 0;
+}
+
+bytes compressor::train_dictionary(const std::vector<temporary_buffer<char>>& samples) const {
+    return bytes();
+}
+
+shared_ptr<compressor> compressor::with_dictionary(bytes_view dictionary) const {
+    throw std::runtime_error(format("{} does not support dictionaries", name()));
+}
+
 shared_ptr<compressor> compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
@@ -182,8 +230,17 @@ std::map<sstring, sstring> compression_parameters::get_options() const {
     return opts;
 }
 
+static bool compressors_equal(const compressor_ptr& a, const compressor_ptr& b) {
+    if (a == b) {
+        return true;
+    }
+    // Compressors with options are instantiated through the registry,
+    // so equivalent ones need not be the same object.
+    return a && b && a->name() == b->name() && a->options() == b->options();
+}
+
 bool compression_parameters::operator==(const compression_parameters& other) const {
-    return _compressor == other._compressor
+    return compressors_equal(_compressor, other._compressor)
            && _chunk_length == other._chunk_length
            && _crc_check_chance == other._crc_check_chance;
 }
@@ -349,3 +406,175 @@ size_t snappy_processor::compress_max_size(size_t input_len) const {
     return snappy_max_compressed_length(input_len);
 }
 
+
+// Digested dictionaries are expensive to build compared to the
+// decompression of a single chunk, so they are shared by all the
+// readers and writers of a shard using the same dictionary.
+class zstd_processor::dictionary {
+    struct cdict_deleter {
+        void operator()(ZSTD_CDict* d) const { ZSTD_freeCDict(d); }
+    };
+    struct ddict_deleter {
+        void operator()(ZSTD_DDict* d) const { ZSTD_freeDDict(d); }
+    };
+    std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
+    std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+public:
+    dictionary(bytes_view dict, int compression_level)
+        : _cdict(ZSTD_createCDict(dict.data(), dict.size(), compression_level))
+        , _ddict(ZSTD_createDDict(dict.data(), dict.size())) {
+        if (!_cdict || !_ddict) {
+            throw std::bad_alloc();
+        }
+    }
+    const ZSTD_CDict* cdict() const { return _cdict.get(); }
+    const ZSTD_DDict* ddict() const { return _ddict.get(); }
+
+    static std::shared_ptr<const dictionary> get(bytes_view dict, int compression_level) {
+        using key_type = std::pair<bytes, int>;
+        struct key_hash {
+            size_t operator()(const key_type& k) const {
+                return std::hash<bytes_view>()(k.first) ^ std::hash<int>()(k.second);
+            }
+        };
+        static thread_local std::unordered_map<key_type, std::weak_ptr<const dictionary>, key_hash> cache;
+
+        auto key = key_type(bytes(dict.begin(), dict.size()), compression_level);
+        auto i = cache.find(key);
+        if (i != cache.end()) {
+            if (auto d = i->second.lock()) {
+                return d;
+            }
+        }
+        for (auto it = cache.begin(); it != cache.end();) {
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+        }
+        auto d = std::make_shared<const dictionary>(dict, compression_level);
+        cache[std::move(key)] = d;
+        return d;
+    }
+};
+
+// Compression contexts are reused across calls, as allocating them
+// costs more than compressing a small chunk.
+static ZSTD_CCtx* local_zstd_cctx() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, size_t(*)(ZSTD_CCtx*)> ctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    return ctx.get();
+}
+
+static ZSTD_DCtx* local_zstd_dctx() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, size_t(*)(ZSTD_DCtx*)> ctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    return ctx.get();
+}
+
+const sstring zstd_processor::COMPRESSION_LEVEL = "compression_level";
+const sstring zstd_processor::DICTIONARY_SIZE_IN_KB = "dictionary_size_in_kb";
+
+zstd_processor::zstd_processor(const opt_getter& opts)
+    : compressor(namespace_prefix + "ZstdCompressor") {
+    auto level = opts(COMPRESSION_LEVEL);
+    if (level) {
+        try {
+            _compression_level = std::stoi(*level);
+        } catch (const std::exception&) {
+            throw exceptions::syntax_exception(format("Invalid integer value {} for {}", *level, COMPRESSION_LEVEL));
+        }
+        if (_compression_level < ZSTD_minCLevel() || _compression_level > ZSTD_maxCLevel()) {
+            throw exceptions::configuration_exception(format("{} must be between {} and {}, got {}",
+                    COMPRESSION_LEVEL, ZSTD_minCLevel(), ZSTD_maxCLevel(), _compression_level));
+        }
+    }
+    auto dict_size = opts(DICTIONARY_SIZE_IN_KB);
+    if (dict_size) {
+        int kb;
+        try {
+            kb = std::stoi(*dict_size);
+        } catch (const std::exception&) {
+            throw exceptions::syntax_exception(format("Invalid integer value {} for {}", *dict_size, DICTIONARY_SIZE_IN_KB));
+        }
+        if (kb < 0 || size_t(kb) * 1024 > MAX_DICTIONARY_SIZE) {
+            throw exceptions::configuration_exception(format("{} must be between 0 and {}, got {}",
+                    DICTIONARY_SIZE_IN_KB, MAX_DICTIONARY_SIZE / 1024, kb));
+        }
+        _dictionary_size = size_t(kb) * 1024;
+    }
+}
+
+size_t zstd_processor::uncompress(const char* input, size_t input_len,
+                char* output, size_t output_len) const {
+    auto ret = _dictionary
+            ? ZSTD_decompress_usingDDict(local_zstd_dctx(), output, output_len, input, input_len, _dictionary->ddict())
+            : ZSTD_decompressDCtx(local_zstd_dctx(), output, output_len, input, input_len);
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("ZSTD uncompression failure: {}", ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+size_t zstd_processor::compress(const char* input, size_t input_len,
+                char* output, size_t output_len) const {
+    auto ret = _dictionary
+            ? ZSTD_compress_usingCDict(local_zstd_cctx(), output, output_len, input, input_len, _dictionary->cdict())
+            : ZSTD_compressCCtx(local_zstd_cctx(), output, output_len, input, input_len, _compression_level);
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+size_t zstd_processor::compress_max_size(size_t input_len) const {
+    return ZSTD_compressBound(input_len);
+}
+
+std::set<sstring> zstd_processor::option_names() const {
+    return { COMPRESSION_LEVEL, DICTIONARY_SIZE_IN_KB };
+}
+
+std::map<sstring, sstring> zstd_processor::options() const {
+    std::map<sstring, sstring> opts{{ COMPRESSION_LEVEL, to_sstring(_compression_level) }};
+    if (_dictionary_size) {
+        opts.emplace(DICTIONARY_SIZE_IN_KB, to_sstring(_dictionary_size / 1024));
+    }
+    return opts;
+}
+
+size_t zstd_processor::dictionary_size() const {
+    return _dictionary ? 0 : _dictionary_size;
+}
+
+bytes zstd_processor::train_dictionary(const std::vector<temporary_buffer<char>>& samples) const {
+    // Chunks are split into smaller samples, since the trainer needs
+    // many samples to find the content worth sharing among them.
+    static constexpr size_t max_sample_size = 1024;
+
+    auto total = boost::accumulate(samples, size_t(0), [] (size_t acc, const temporary_buffer<char>& b) {
+        return acc + b.size();
+    });
+    std::vector<char> buffer;
+    buffer.reserve(total);
+    std::vector<size_t> sizes;
+    for (auto& b : samples) {
+        buffer.insert(buffer.end(), b.begin(), b.end());
+        for (size_t pos = 0; pos < b.size(); pos += max_sample_size) {
+            sizes.push_back(std::min(max_sample_size, b.size() - pos));
+        }
+    }
+
+    bytes dict(bytes::initialized_later(), _dictionary_size);
+    auto ret = ZDICT_trainFromBuffer(dict.begin(), dict.size(), buffer.data(), sizes.data(), sizes.size());
+    if (ZDICT_isError(ret)) {
+        // Not enough (or not diverse enough) data; compress without a dictionary.
+        return bytes();
+    }
+    dict.resize(ret);
+    return dict;
+}
+
+shared_ptr<compressor> zstd_processor::with_dictionary(bytes_view dict) const {
+    auto c = make_shared<zstd_processor>(*this);
+    c->_dictionary = dictionary::get(dict, _compression_level);
+    return c;
+}
+
+static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>
+    zstd_registrator("org.apache.cassandra.io.compress.ZstdCompressor");
@@ -23,11 +23,14 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
 
+#include "bytes.hh"
 #include "exceptions/exceptions.hh"
 
 
@@ -64,6 +67,25 @@ class compressor {
      */
     virtual std::map<sstring, sstring> options() const;
 
+    /**
+     * Returns the size of the dictionary this compressor wants trained
+     * for every compressed file it writes, or 0 if dictionaries are not
+     * used.
+     */
+    virtual size_t dictionary_size() const;
+    /**
+     * Trains a dictionary of at most dictionary_size() bytes from chunks
+     * sampled from the beginning of the file being written. An empty
+     * result means that training failed and no dictionary should be used.
+     */
+    virtual bytes train_dictionary(const std::vector<temporary_buffer<char>>& samples) const;
+    /**
+     * Returns a compressor with the same options as this one, which uses
+     * the given (previously trained) dictionary for both compression and
+     * uncompression.
+     */
+    virtual shared_ptr<compressor> with_dictionary(bytes_view dictionary) const;
+
     /**
      * Compressor class name.
      */
@@ -279,6 +279,7 @@ scylla_tests = [
     'tests/perf/perf_hash',
     'tests/perf/perf_cql_parser',
     'tests/perf/perf_simple_query',
+    'tests/perf/perf_view_updates',
     'tests/perf/perf_fast_forward',
     'tests/perf/perf_cache_eviction',
     'tests/cache_flat_mutation_reader_test',
@@ -339,11 +340,13 @@ scylla_tests = [
     'tests/virtual_reader_test',
     'tests/view_schema_test',
     'tests/view_build_test',
+    'tests/repair_range_hash_test',
     'tests/view_complex_test',
     'tests/counter_test',
     'tests/cell_locker_test',
     'tests/row_locker_test',
     'tests/streaming_histogram_test',
+    'tests/stream_sstable_files_test',
     'tests/duration_test',
     'tests/vint_serialization_test',
     'tests/continuous_data_consumer_test',
@@ -387,6 +390,7 @@ perf_tests = [
     'tests/perf/perf_mutation_fragment',
     'tests/perf/perf_idl',
     'tests/perf/perf_vint',
+    'tests/perf/perf_bloom_filter',
 ]
 
 apps = [
@@ -507,6 +511,7 @@ scylla_core = (['database.cc',
                 'sstables/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
                 'sstables/prepended_input_stream.cc',
+                'sstables/partition_trie.cc',
                 'sstables/m_format_read_helpers.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
@@ -619,6 +624,7 @@ scylla_core = (['database.cc',
                 'db/batchlog_manager.cc',
                 'db/view/view.cc',
                 'db/view/view_update_generator.cc',
+                'db/view/view_update_coalescer.cc',
                 'db/view/row_locking.cc',
                 'index/secondary_index_manager.cc',
                 'index/secondary_index.cc',
@@ -633,6 +639,7 @@ scylla_core = (['database.cc',
                 'utils/exceptions.cc',
                 'utils/config_file.cc',
                 'utils/gz/crc_combine.cc',
+                'utils/gz/fast_crc32.cc',
                 'gms/version_generator.cc',
                 'gms/versioned_value.cc',
                 'gms/gossiper.cc',
@@ -673,6 +680,7 @@ scylla_core = (['database.cc',
                 'service/misc_services.cc',
                 'service/pager/paging_state.cc',
                 'service/pager/query_pagers.cc',
+                'service/parallel_aggregation.cc',
                 'streaming/stream_task.cc',
                 'streaming/stream_session.cc',
                 'streaming/stream_request.cc',
@@ -1119,7 +1127,7 @@ for mode in build_modes:
 
 args.user_cflags += " " + pkg_config('jsoncpp', '--cflags')
 args.user_cflags += ' -march=' + args.target
-libs = ' '.join([maybe_static(args.staticyamlcpp, '-lyaml-cpp'), '-latomic', '-llz4', '-lz', '-lsnappy', pkg_config('jsoncpp', '--libs'),
+libs = ' '.join([maybe_static(args.staticyamlcpp, '-lyaml-cpp'), '-latomic', '-llz4', '-lz', '-lsnappy', '-lzstd', pkg_config('jsoncpp', '--libs'),
                  ' -lstdc++fs', ' -lcrypt', ' -lcryptopp', ' -lpthread',
                  maybe_static(args.staticboost, '-lboost_date_time -lboost_regex -licuuc'), ])
 
@@ -57,6 +57,10 @@ class abstract_marker : public non_terminal {
 public:
     abstract_marker(int32_t bind_index, ::shared_ptr<column_specification>&& receiver);
 
+    int32_t bind_index() const {
+        return _bind_index;
+    }
+
     virtual void collect_marker_specification(::shared_ptr<variable_specifications> bound_names) override;
 
     virtual bool contains_bind_marker() const override;
@@ -147,6 +147,10 @@ class single_column_restriction::EQ final : public single_column_restriction {
         return true;
     }
 
+    const ::shared_ptr<term>& get_value() const {
+        return _value;
+    }
+
     virtual std::vector<bytes_opt> values(const query_options& options) const override {
         std::vector<bytes_opt> v;
         v.push_back(to_bytes_opt(_value->bind_and_get(options)));
@@ -298,6 +298,8 @@ statement_restrictions::statement_restrictions(database& db,
     if (_uses_secondary_indexing && !(for_view || allow_filtering)) {
         validate_secondary_index_selections(selects_only_static_columns);
     }
+
+    find_partition_key_bind_indices();
 }
 
 void statement_restrictions::add_restriction(::shared_ptr<restriction> restriction, bool for_view, bool allow_filtering) {
@@ -436,6 +438,30 @@ void statement_restrictions::process_partition_key_restrictions(bool has_queriab
 
 }
 
+void statement_restrictions::find_partition_key_bind_indices() {
+    auto pk_restrictions = dynamic_pointer_cast<single_column_partition_key_restrictions>(_partition_key_restrictions);
+    if (!pk_restrictions || !pk_restrictions->is_all_eq() || pk_restrictions->has_unrestricted_components(*_schema)) {
+        return;
+    }
+    std::vector<int32_t> bind_indices;
+    bind_indices.reserve(_schema->partition_key_size());
+    for (auto&& def : _schema->partition_key_columns()) {
+        auto it = pk_restrictions->restrictions().find(&def);
+        if (it == pk_restrictions->restrictions().end()) {
+            return;
+        }
+        // Markers of other kinds, like the ones of collections, may need
+        // the bound value to be converted.
+        auto eq = dynamic_pointer_cast<single_column_restriction::EQ>(it->second);
+        auto marker = eq ? dynamic_pointer_cast<constants::marker>(eq->get_value()) : nullptr;
+        if (!marker) {
+            return;
+        }
+        bind_indices.push_back(marker->bind_index());
+    }
+    _partition_key_bind_indices = std::move(bind_indices);
+}
+
 bool statement_restrictions::has_partition_key_unrestricted_components() const {
     return _partition_key_restrictions->has_unrestricted_components(*_schema);
 }
@@ -476,6 +502,9 @@ void statement_restrictions::process_clustering_columns_restrictions(bool has_qu
 }
 
 dht::partition_range_vector statement_restrictions::get_partition_key_ranges(const query_options& options) const {
+    if (auto range = get_bound_partition_range(options)) {
+        return {std::move(*range)};
+    }
     if (_partition_key_restrictions->empty()) {
         return {dht::partition_range::make_open_ended_both_sides()};
     }
@@ -485,6 +514,33 @@ dht::partition_range_vector statement_restrictions::get_partition_key_ranges(con
     return _partition_key_restrictions->bounds_ranges(options);
 }
 
+std::optional<dht::partition_range> statement_restrictions::get_bound_partition_range(const query_options& options) const {
+    if (_partition_key_bind_indices.empty()) {
+        return std::nullopt;
+    }
+    std::vector<bytes> components;
+    components.reserve(_partition_key_bind_indices.size());
+    auto def = _schema->partition_key_columns().begin();
+    for (auto bind_index : _partition_key_bind_indices) {
+        auto value = options.get_value_at(bind_index);
+        if (!value) {
+            return std::nullopt;
+        }
+        try {
+            def->type->validate(*value, options.get_cql_serialization_format());
+        } catch (const marshal_exception& e) {
+            throw exceptions::invalid_request_exception(e.what());
+        }
+        components.push_back(to_bytes(*value));
+        ++def;
+    }
+    auto key = components.size() == 1
+            ? partition_key::from_single_value(*_schema, std::move(components.front()))
+            : partition_key::from_exploded(*_schema, components);
+    auto token = dht::global_partitioner().get_token(*_schema, key);
+    return dht::partition_range::make_singular(dht::ring_position(std::move(token), std::move(key)));
+}
+
 std::vector<query::clustering_range> statement_restrictions::get_clustering_bounds(const query_options& options) const {
     if (_clustering_columns_restrictions->empty()) {
         return {query::clustering_range::make_open_ended_both_sides()};
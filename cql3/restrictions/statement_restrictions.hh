@@ -101,6 +101,13 @@ class statement_restrictions {
      */
     bool _is_key_range = false;
 
+    /**
+     * The bind markers the partition key columns are restricted to, in the
+     * order of the columns, if every one of them is restricted by an
+     * equality to a bind marker. Empty otherwise.
+     */
+    std::vector<int32_t> _partition_key_bind_indices;
+
 public:
     /**
      * Creates a new empty <code>StatementRestrictions</code>.
@@ -198,6 +205,12 @@ class statement_restrictions {
 private:
     void process_partition_key_restrictions(bool has_queriable_index, bool for_view, bool allow_filtering);
 
+    /**
+     * Finds the bind markers the partition key is built from, so that it
+     * can be built without evaluating the restrictions on every execution.
+     */
+    void find_partition_key_bind_indices();
+
     /**
      * Returns the partition key components that are not restricted.
      * @return the partition key components that are not restricted.
@@ -266,6 +279,15 @@ class statement_restrictions {
      */
     dht::partition_range_vector get_partition_key_ranges(const query_options& options) const;
 
+    /**
+     * Returns the range of the partition whose key is bound by the options,
+     * built straight from the bound values, without evaluating the
+     * restrictions. Returns nothing if the partition key is not restricted
+     * by equalities to bind markers only, or if some of its bound values is
+     * null or unset, in which case the restrictions have to be evaluated.
+     */
+    std::optional<dht::partition_range> get_bound_partition_range(const query_options& options) const;
+
 #if 0
     /**
      * Returns the partition key bounds.
@@ -36,8 +36,13 @@ class result_generator {
     template<typename Visitor>
     class query_result_visitor {
         const schema& _schema;
-        std::vector<bytes> _partition_key;
-        std::vector<bytes> _clustering_key;
+        // Views of the key components, which are valid until the end of the
+        // partition and of the row, respectively (see result_view::consume()).
+        // They are written to the response as they are, and the vectors are
+        // reused, so that wide results don't allocate and copy the keys of
+        // every row.
+        std::vector<bytes_view> _partition_key;
+        std::vector<bytes_view> _clustering_key;
         uint32_t _partition_row_count = 0;
         uint32_t _total_row_count = 0;
         Visitor& _visitor;
@@ -56,7 +61,10 @@ class result_generator {
             : _schema(s), _visitor(visitor), _selection(select) { }
 
         void accept_new_partition(const partition_key& key, uint32_t row_count) {
-            _partition_key = key.explode(_schema);
+            _partition_key.clear();
+            for (bytes_view component : key.components(_schema)) {
+                _partition_key.push_back(component);
+            }
             accept_new_partition(row_count);
         }
         void accept_new_partition(uint32_t row_count) {
@@ -66,8 +74,12 @@ class result_generator {
 
         void accept_new_row(const clustering_key& key, query::result_row_view static_row,
                             query::result_row_view row) {
-            _clustering_key = key.explode(_schema);
+            _clustering_key.clear();
+            for (bytes_view component : key.components(_schema)) {
+                _clustering_key.push_back(component);
+            }
             accept_new_row(static_row, row);
+            _clustering_key.clear();
         }
         void accept_new_row(query::result_row_view static_row, query::result_row_view row) {
             auto static_row_iterator = static_row.iterator();
@@ -76,11 +88,11 @@ class result_generator {
             for (auto&& def : _selection.get_columns()) {
                 switch (def->kind) {
                 case column_kind::partition_key:
-                    _visitor.accept_value(query::result_bytes_view(bytes_view(_partition_key[def->component_index()])));
+                    _visitor.accept_value(query::result_bytes_view(_partition_key[def->component_index()]));
                     break;
                 case column_kind::clustering_key:
                     if (_clustering_key.size() > def->component_index()) {
-                        _visitor.accept_value(query::result_bytes_view(bytes_view(_clustering_key[def->component_index()])));
+                        _visitor.accept_value(query::result_bytes_view(_clustering_key[def->component_index()]));
                     } else {
                         _visitor.accept_value({});
                     }
@@ -103,7 +115,7 @@ class result_generator {
                 auto static_row_iterator = static_row.iterator();
                 for (auto&& def : _selection.get_columns()) {
                     if (def->is_partition_key()) {
-                        _visitor.accept_value(query::result_bytes_view(bytes_view(_partition_key[def->component_index()])));
+                        _visitor.accept_value(query::result_bytes_view(_partition_key[def->component_index()]));
                     } else if (def->is_static()) {
                         accept_cell_value(*def, static_row_iterator);
                     } else {
@@ -112,6 +124,7 @@ class result_generator {
                 }
                 _visitor.end_row();
             }
+            _partition_key.clear();
         }
 
         uint32_t rows_read() const { return _total_row_count; }
@@ -102,6 +102,14 @@ class selectable::with_function : public selectable {
 
     virtual sstring to_string() const override;
 
+    const functions::function_name& function_name() const {
+        return _function_name;
+    }
+
+    const std::vector<shared_ptr<selectable>>& args() const {
+        return _args;
+    }
+
     virtual shared_ptr<selector::factory> new_selector_factory(database& db, schema_ptr s, std::vector<const column_definition*>& defs) override;
     class raw : public selectable::raw {
         functions::function_name _function_name;
@@ -357,7 +357,8 @@ modification_statement::create_clustering_ranges(const query_options& options, c
 
 dht::partition_range_vector
 modification_statement::build_partition_keys(const query_options& options, const json_cache_opt& json_cache) {
-    auto keys = _restrictions->get_partition_key_restrictions()->bounds_ranges(options);
+    auto range = _restrictions->get_bound_partition_range(options);
+    auto keys = range ? dht::partition_range_vector{std::move(*range)} : _restrictions->get_partition_key_restrictions()->bounds_ranges(options);
     for (auto&& k : keys) {
         validation::validate_cql_key(s, *k.start()->value().key());
     }
@@ -58,6 +58,8 @@
 #include "db/timeout_clock.hh"
 #include "db/consistency_level_validations.hh"
 #include "database.hh"
+#include "db/config.hh"
+#include "service/storage_service.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 
 namespace cql3 {
@@ -333,6 +335,10 @@ select_statement::do_execute(service::storage_proxy& proxy,
     }
 
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
+    if (_partial_aggregates && proxy.get_db().local().get_config().enable_parallelized_aggregation()
+            && service::get_local_storage_service().cluster_supports_parallelized_aggregation()) {
+        return execute_partial_aggregates(proxy, command, std::move(key_ranges), state, options);
+    }
     auto timeout_duration = options.get_timeout_config().*get_timeout_config_selector();
     auto p = service::pager::query_pagers::pager(_schema, _selection,
             state, options, command, std::move(key_ranges), _stats, restrictions_need_filtering ? _restrictions : nullptr);
@@ -629,6 +635,24 @@ select_statement::execute(service::storage_proxy& proxy,
     }
 }
 
+future<shared_ptr<cql_transport::messages::result_message>>
+select_statement::execute_partial_aggregates(service::storage_proxy& proxy,
+                                             lw_shared_ptr<query::read_command> cmd,
+                                             dht::partition_range_vector&& partition_ranges,
+                                             service::query_state& state,
+                                             const query_options& options)
+{
+    // Like for a client paging through the table, the timeout applies to every page read by the replicas.
+    auto page_timeout = options.get_timeout_config().*get_timeout_config_selector();
+    return service::query_partial_aggregates(proxy, _schema, *_partial_aggregates, std::move(cmd), std::move(partition_ranges),
+            options.get_consistency(), page_timeout, state.get_trace_state()).then([this] (std::vector<bytes_opt> row) {
+        auto rs = std::make_unique<result_set>(_selection->get_result_metadata());
+        rs->add_row(std::move(row));
+        update_stats_rows_read(rs->size());
+        return shared_ptr<cql_transport::messages::result_message>(::make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs))));
+    });
+}
+
 shared_ptr<cql_transport::messages::result_message>
 indexed_table_select_statement::process_base_query_results(
         foreign_ptr<lw_shared_ptr<query::result>> results,
@@ -1296,6 +1320,14 @@ std::unique_ptr<prepared_statement> select_statement::prepare(database& db, cql_
                 stats);
     }
 
+    if (!for_view && stmt->get_restrictions()->is_key_range() && !stmt->get_restrictions()->need_filtering()
+            && !stmt->get_restrictions()->uses_secondary_indexing() && !_parameters->is_distinct()
+            && !stmt->has_group_by() && !_per_partition_limit) {
+        if (auto aggregates = service::get_partial_aggregates(_select_clause, schema)) {
+            stmt->set_partial_aggregates(std::move(*aggregates));
+        }
+    }
+
     auto partition_key_bind_indices = bound_names->get_partition_key_bind_indexes(schema);
 
     return std::make_unique<prepared>(std::move(stmt), std::move(*bound_names), std::move(partition_key_bind_indices));
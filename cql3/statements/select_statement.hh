@@ -50,6 +50,7 @@
 #include "cql3/result_set.hh"
 #include "exceptions/unrecognized_entity_exception.hh"
 #include "service/client_state.hh"
+#include "service/parallel_aggregation.hh"
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/distributed.hh>
 #include "validation.hh"
@@ -93,6 +94,9 @@ class select_statement : public cql_statement {
 
     query::partition_slice::option_set _opts;
     cql_stats& _stats;
+    // Set if the aggregates of this statement can be computed by the
+    // replicas, see service::query_partial_aggregates().
+    std::optional<service::partial_aggregates> _partial_aggregates;
 protected :
     virtual future<::shared_ptr<cql_transport::messages::result_message>> do_execute(service::storage_proxy& proxy,
         service::query_state& state, const query_options& options);
@@ -144,7 +148,14 @@ protected :
 
     bool has_group_by() { return _group_by_cell_indices && !_group_by_cell_indices->empty(); }
 
+    void set_partial_aggregates(service::partial_aggregates aggregates) {
+        _partial_aggregates = std::move(aggregates);
+    }
+
 protected:
+    future<::shared_ptr<cql_transport::messages::result_message>> execute_partial_aggregates(service::storage_proxy& proxy,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector&& partition_ranges, service::query_state& state,
+        const query_options& options);
     uint32_t do_get_limit(const query_options& options, ::shared_ptr<term> limit) const;
     uint32_t get_limit(const query_options& options) const {
         return do_get_limit(options, _limit);
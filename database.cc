@@ -227,6 +227,9 @@ database::database(const db::config& cfg, database_config dbcfg)
     setup_metrics();
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _row_cache_tracker.set_admission_policy(make_cache_admission_policy(cfg.cache_admission_policy()));
+    _row_cache_tracker.set_scan_population_limit(uint64_t(cfg.cache_scan_population_limit_in_mb()) << 20);
+    _compaction_manager->set_parallelism(cfg.compaction_parallelism());
 
     dblog.debug("Row: max_vector_size: {}, internal_count: {}", size_t(row::max_vector_size), size_t(row::internal_count));
 }
@@ -908,6 +911,7 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
 
     cfg.view_update_concurrency_semaphore = _config.view_update_concurrency_semaphore;
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
+    cfg.view_update_coalescing_window = _config.view_update_coalescing_window;
     cfg.data_listeners = &db.data_listeners();
 
     return cfg;
@@ -1566,6 +1570,7 @@ database::make_keyspace_config(const keyspace_metadata& ksm) {
 
     cfg.view_update_concurrency_semaphore = &_view_update_concurrency_sem;
     cfg.view_update_concurrency_semaphore_limit = max_memory_pending_view_updates();
+    cfg.view_update_coalescing_window = std::chrono::milliseconds(_cfg.view_update_coalescing_window_in_ms());
     return cfg;
 }
 
@@ -80,6 +80,7 @@
 #include "db/view/view.hh"
 #include "db/view/view_update_backlog.hh"
 #include "db/view/row_locking.hh"
+#include "db/view/view_update_coalescer.hh"
 #include "lister.hh"
 #include "utils/phased_barrier.hh"
 #include "backlog_controller.hh"
@@ -342,6 +343,7 @@ class table : public enable_lw_shared_from_this<table> {
         sstables::sstables_manager* sstables_manager;
         db::timeout_semaphore* view_update_concurrency_semaphore;
         size_t view_update_concurrency_semaphore_limit;
+        std::chrono::milliseconds view_update_coalescing_window{0};
         db::data_listeners* data_listeners = nullptr;
     };
     struct no_commitlog {};
@@ -378,6 +380,14 @@ class table : public enable_lw_shared_from_this<table> {
     config _config;
     mutable stats _stats;
     mutable db::view::stats _view_stats;
+    mutable db::view::view_update_coalescer _view_update_coalescer;
+    // Base writes to the same partition sharing a read-before-write, see generate_and_propagate_batched_view_updates().
+    struct view_update_read_batch {
+        schema_ptr base;
+        mutation m;
+        shared_promise<> done;
+    };
+    mutable std::unordered_multimap<dht::token, lw_shared_ptr<view_update_read_batch>> _view_update_read_batches;
     mutable row_locker::stats _row_locker_stats;
 
     uint64_t _failed_counter_applies_to_memtable = 0;
@@ -680,6 +690,12 @@ class table : public enable_lw_shared_from_this<table> {
     flat_mutation_reader make_streaming_reader(schema_ptr schema,
             const dht::partition_range_vector& ranges) const;
 
+    // Like the above, but skips the given sstables. They are left out of the
+    // sstables of the table as of the time each range is read, so that data
+    // flushed or compacted in the meantime is still read.
+    flat_mutation_reader make_streaming_reader(schema_ptr schema,
+            const dht::partition_range_vector& ranges, std::vector<sstables::shared_sstable> excluded) const;
+
     // Single range overload.
     flat_mutation_reader make_streaming_reader(schema_ptr schema, const dht::partition_range& range,
             const query::partition_slice& slice,
@@ -708,6 +724,10 @@ class table : public enable_lw_shared_from_this<table> {
     using const_mutation_partition_ptr = std::unique_ptr<const mutation_partition>;
     using const_row_ptr = std::unique_ptr<const row>;
     memtable& active_memtable() { return _memtables->active_memtable(); }
+    // Returns true if some of the data written to the range is not in the
+    // sstables of the table yet. The range has to be kept alive until the
+    // returned future resolves.
+    future<bool> has_memtable_data(const dht::partition_range& range) const;
     const row_cache& get_row_cache() const {
         return _cache;
     }
@@ -738,6 +758,9 @@ class table : public enable_lw_shared_from_this<table> {
     // The mutation is always upgraded to current schema.
     void apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& = {});
     void apply(const mutation& m, db::rp_handle&& = {});
+    // Applies mutations without a commitlog position to the active memtable
+    // in bulk. Used by commitlog replay.
+    void apply(const std::vector<const frozen_mutation*>& ms, const schema_ptr& m_schema);
     void apply_streaming_mutation(schema_ptr, utils::UUID plan_id, const frozen_mutation&, bool fragmented);
 
     // Returns at most "cmd.limit" rows
@@ -793,6 +816,9 @@ class table : public enable_lw_shared_from_this<table> {
     // If cleanup is set to true, compaction_sstables will run on behalf of a cleanup job,
     // meaning that irrelevant keys will be discarded.
     future<> compact_sstables(sstables::compaction_descriptor descriptor, bool cleanup = false);
+    // Changes the level of sstables, which must be owned by an ongoing compaction,
+    // without rewriting their data.
+    future<> move_sstables_to_level(std::vector<sstables::shared_sstable> sstables, uint32_t level);
     // Performs a cleanup on each sstable of this column family, excluding
     // those ones that are irrelevant to this node or being compacted.
     // Cleanup is about discarding keys that are no longer relevant for a
@@ -937,7 +963,15 @@ class table : public enable_lw_shared_from_this<table> {
     }
 
 private:
-    future<row_locker::lock_holder> do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source) const;
+    future<row_locker::lock_holder> do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout,
+            mutation_source&& source, bool batch_reads) const;
+    static query::partition_slice view_update_read_slice(const schema& base, query::clustering_row_ranges&& cr_ranges);
+    future<> read_and_propagate_view_updates(const schema_ptr& base,
+            std::vector<view_ptr>&& views,
+            mutation&& m,
+            query::partition_slice&& slice,
+            const mutation_source& source) const;
+    future<> generate_and_propagate_batched_view_updates(const schema_ptr& base, mutation&& m) const;
     std::vector<view_ptr> affected_views(const schema_ptr& base, const mutation& update) const;
     future<> generate_and_propagate_view_updates(const schema_ptr& base,
             std::vector<view_ptr>&& views,
@@ -1117,6 +1151,7 @@ class keyspace {
         bool enable_metrics_reporting = false;
         db::timeout_semaphore* view_update_concurrency_semaphore = nullptr;
         size_t view_update_concurrency_semaphore_limit;
+        std::chrono::milliseconds view_update_coalescing_window{0};
     };
 private:
     std::unique_ptr<locator::abstract_replication_strategy> _replication_strategy;
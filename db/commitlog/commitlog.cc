@@ -62,6 +62,7 @@
 #include <seastar/core/queue.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/net/byteorder.hh>
+#include <lz4.h>
 
 #include "seastarx.hh"
 
@@ -73,6 +74,8 @@
 #include "utils/crc.hh"
 #include "utils/runtime.hh"
 #include "utils/flush_queue.hh"
+#include "utils/estimated_histogram.hh"
+#include "utils/buffer_input_stream.hh"
 #include "log.hh"
 #include "commitlog_entry.hh"
 #include "commitlog_extensions.hh"
@@ -132,6 +135,8 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.extensions = &cfg.extensions();
     c.reuse_segments = cfg.commitlog_reuse_segments();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
+    c.commitlog_sync_batch_max_window_in_us = cfg.commitlog_sync_batch_max_window_in_us();
+    c.use_compression = cfg.commitlog_use_compression();
 
     return c;
 }
@@ -242,6 +247,7 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t allocation_count = 0;
         uint64_t bytes_written = 0;
         uint64_t bytes_slack = 0;
+        uint64_t bytes_compressed_saved = 0;
         uint64_t segments_created = 0;
         uint64_t segments_destroyed = 0;
         uint64_t pending_flushes = 0;
@@ -250,10 +256,52 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t buffer_list_bytes = 0;
         uint64_t total_size_on_disk = 0;
         uint64_t requests_blocked_memory = 0;
+        uint64_t batch_windows = 0;
+        // Number of entries in each buffer written to disk.
+        utils::estimated_histogram batch_sizes{50};
+        // Latency of segment flushes, in microseconds.
+        utils::estimated_histogram flush_latency;
     };
 
     stats totals;
 
+    // Batch mode group commit: allocations which arrive while a segment's window
+    // is open are written out and flushed together when it closes.
+    //
+    // The window is a fraction of the observed flush latency, so that its cost
+    // stays small compared to the fsync it saves. It isn't opened when writes
+    // don't overlap, since then there is nothing to group and waiting would only
+    // add latency. Allocations blocked on the memory quota don't widen it: they
+    // wait for buffers to be written, which a longer window only delays.
+    double _avg_batch_size = 1;
+    double _avg_flush_latency_us = 0;
+
+    std::chrono::microseconds batch_window() const {
+        if (cfg.mode != sync_mode::BATCH || !cfg.commitlog_sync_batch_max_window_in_us) {
+            return std::chrono::microseconds(0);
+        }
+        auto max_window = std::chrono::microseconds(cfg.commitlog_sync_batch_max_window_in_us);
+        if (_avg_batch_size < 2) {
+            return std::chrono::microseconds(0);
+        }
+        return std::min(max_window, std::chrono::microseconds(int64_t(_avg_flush_latency_us / 2)));
+    }
+    // A window is closed early once it gathered well above the usual number of entries.
+    bool batch_window_full(uint64_t num_allocs) const {
+        return num_allocs >= 2 * _avg_batch_size;
+    }
+    void on_buffer_written(uint64_t num_allocs) {
+        if (num_allocs) {
+            totals.batch_sizes.add(num_allocs);
+            _avg_batch_size = 0.8 * _avg_batch_size + 0.2 * num_allocs;
+        }
+    }
+    void on_flush_completed(std::chrono::steady_clock::duration latency) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        totals.flush_latency.add(us);
+        _avg_flush_latency_us = 0.8 * _avg_flush_latency_us + 0.2 * us;
+    }
+
     size_t pending_allocations() const {
         return _request_controller.waiters();
     }
@@ -430,6 +478,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     sstring _file_name;
 
     uint64_t _file_pos = 0;
+    // Position in the file itself. Differs from _file_pos, which
+    // replay positions are based on, only in compressed segments.
+    uint64_t _disk_pos = 0;
     uint64_t _flush_pos = 0;
     bool _closed = false;
     bool _terminated = false;
@@ -451,6 +502,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
     std::unordered_set<table_schema_version> _known_schema_versions;
 
+    // Group commit window of batch mode, see segment_manager::batch_window().
+    std::optional<shared_promise<>> _batch_window;
+    timer<> _batch_window_timer;
+
     friend std::ostream& operator<<(std::ostream&, const segment&);
     friend class segment_manager;
 
@@ -481,6 +536,16 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     static constexpr size_t descriptor_header_size = 5 * sizeof(uint32_t);
     static constexpr uint32_t segment_magic = ('S'<<24) |('C'<< 16) | ('L' << 8) | 'C';
 
+    // Segments of this version follow each chunk header with a compression header
+    // (int: stored length + int: compression + int: checksum [stored length, compression, position]).
+    // The chunk data, starting with the first entry, is then stored in "stored length"
+    // bytes, padded to alignment. Positions (and thus replay positions) are those
+    // of the uncompressed data.
+    static constexpr uint32_t compressed_segment_version = 2;
+    static constexpr size_t compression_header_size = 3 * sizeof(uint32_t);
+    static constexpr uint32_t chunk_uncompressed = 0;
+    static constexpr uint32_t chunk_lz4 = 1;
+
     // The commit log (chained) sync marker/header size in bytes (int: length + int: checksum [segmentId, position])
     static constexpr size_t sync_marker_size = 2 * sizeof(uint32_t);
 
@@ -492,6 +557,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             : _segment_manager(std::move(m)), _desc(std::move(d)), _file(std::move(f)),
         _file_name(_segment_manager->cfg.commit_log_location + "/" + _desc.filename()), _sync_time(
                     clock_type::now()), _pending_ops(true) // want exception propagation
+        , _batch_window_timer([this] { close_batch_window(); })
     {
         ++_segment_manager->totals.segments_created;
         clogger.debug("Created new {} segment {}", active ? "active" : "reserve", *this);
@@ -570,7 +636,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                     // When we get here, nothing should add ops,
                     // and we should have waited out all pending.
                     return me->_pending_ops.close().finally([me] {
-                        return me->_file.truncate(me->_flush_pos).then([me] {
+                        return me->_file.truncate(me->is_compressed() ? me->_disk_pos : me->_flush_pos).then([me] {
                             return me->_file.close();
                         });
                     });
@@ -623,13 +689,15 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                 clogger.trace("{} already synced! ({} < {})", *this, pos, _flush_pos);
                 return make_ready_future<>();
             }
-            return _file.flush().then_wrapped([this, pos](future<> f) {
+            auto started = std::chrono::steady_clock::now();
+            return _file.flush().then_wrapped([this, pos, started](future<> f) {
                 try {
                     f.get();
                     // TODO: retry/ignore/fail/stop - optional behaviour in origin.
                     // we fast-fail the whole commit.
                     _flush_pos = std::max(pos, _flush_pos);
                     ++_segment_manager->totals.flush_count;
+                    _segment_manager->on_flush_completed(std::chrono::steady_clock::now() - started);
                     clogger.trace("{} synced to {}", *this, _flush_pos);
                 } catch (...) {
                     clogger.error("Failed to flush commits to disk: {}", std::current_exception());
@@ -646,10 +714,18 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     /**
      * Allocate a new buffer
      */
+    bool is_compressed() const {
+        return _desc.ver == compressed_segment_version;
+    }
+
+    size_t chunk_overhead_size() const {
+        return segment_overhead_size + (is_compressed() ? compression_header_size : 0);
+    }
+
     void new_buffer(size_t s) {
         assert(_buffer.empty());
 
-        auto overhead = segment_overhead_size;
+        auto overhead = chunk_overhead_size();
         if (_file_pos == 0) {
             overhead += descriptor_header_size;
         }
@@ -665,9 +741,46 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     bool buffer_is_empty() const {
-        return buffer_position() <= segment_overhead_size
-                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
+        return buffer_position() <= chunk_overhead_size()
+                        || (_file_pos == 0 && buffer_position() <= (chunk_overhead_size() + descriptor_header_size));
+    }
+    static void copy_to(fragmented_temporary_buffer::view v, char* out) {
+        for (bytes_view frag : v) {
+            out = std::copy_n(reinterpret_cast<const char*>(frag.data()), frag.size(), out);
+        }
+    }
+
+    /**
+     * Compresses the chunk data in [data_off, size) of buf into a new,
+     * aligned buffer which leaves room for the chunk headers in front of it.
+     * Returns an empty buffer if compression doesn't make the chunk
+     * occupy less disk space.
+     */
+    temporary_buffer<char> compress_chunk(const buffer_type& buf, size_t data_off, size_t size, size_t& stored) const {
+        auto len = size - data_off;
+        auto v = fragmented_temporary_buffer::view(buf);
+        v.remove_prefix(data_off);
+        v.remove_suffix(buf.size_bytes() - size);
+        temporary_buffer<char> data(len);
+        copy_to(v, data.get_write());
+
+        auto bound = LZ4_compressBound(len);
+        auto result = temporary_buffer<char>::aligned(alignment, align_up<size_t>(data_off + bound, alignment));
+#ifdef HAVE_LZ4_COMPRESS_DEFAULT
+        auto ret = LZ4_compress_default(data.get(), result.get_write() + data_off, len, bound);
+#else
+        auto ret = LZ4_compress(data.get(), result.get_write() + data_off, len);
+#endif
+        if (ret <= 0 || align_up<size_t>(data_off + ret, alignment) >= size) {
+            return { };
+        }
+        auto disk_size = align_up<size_t>(data_off + ret, alignment);
+        std::fill(result.get_write() + data_off + ret, result.get_write() + disk_size, 0);
+        result.trim(disk_size);
+        stored = ret;
+        return result;
     }
+
     /**
      * Send any buffer contents to disk and get a new tmp buffer
      */
@@ -681,11 +794,14 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         auto buf = std::exchange(_buffer, { });
         auto off = _file_pos;
         auto top = off + size;
+        auto disk_off = _disk_pos;
+        auto disk_size = size;
         auto num = _num_allocs;
 
         _file_pos = top;
         _buffer_ostream = { };
         _num_allocs = 0;
+        _segment_manager->on_buffer_written(num);
 
         auto me = shared_from_this();
         assert(me.use_count() > 1);
@@ -717,6 +833,34 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             write(out, uint32_t(_file_pos));
             write(out, crc.checksum());
 
+            if (is_compressed()) {
+                auto data_off = header_size + chunk_overhead_size();
+                auto stored = size - data_off;
+                auto compressed = compress_chunk(buf, data_off, size, stored);
+                auto compression = compressed.empty() ? chunk_uncompressed : chunk_lz4;
+
+                crc32_nbo ccrc;
+                ccrc.process(uint32_t(stored));
+                ccrc.process(compression);
+                ccrc.process(uint32_t(off + header_size));
+
+                write(out, uint32_t(stored));
+                write(out, compression);
+                write(out, ccrc.checksum());
+
+                if (!compressed.empty()) {
+                    auto headers = fragmented_temporary_buffer::view(buf);
+                    headers.remove_suffix(buf.size_bytes() - data_off);
+                    copy_to(headers, compressed.get_write());
+                    disk_size = compressed.size();
+                    std::vector<temporary_buffer<char>> frags;
+                    frags.emplace_back(std::move(compressed));
+                    buf = buffer_type(std::move(frags), disk_size);
+                    _segment_manager->totals.total_size -= size - disk_size;
+                    _segment_manager->totals.bytes_compressed_saved += size - disk_size;
+                }
+            }
+
             forget_schema_versions();
 
             clogger.trace("Writing {} entries, {} k in {} -> {}", num, size, off, off + size);
@@ -727,19 +871,21 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             write(out, uint64_t(0));
         }
 
+        _disk_pos = disk_off + disk_size;
+
         replay_position rp(_desc.id, position_type(off));
 
         // The write will be allowed to start now, but flush (below) must wait for not only this,
         // but all previous write/flush pairs.
-        return _pending_ops.run_with_ordered_post_op(rp, [this, size, off, buf = std::move(buf)]() mutable {
+        return _pending_ops.run_with_ordered_post_op(rp, [this, size, disk_size, off = disk_off, buf = std::move(buf)]() mutable {
             auto view = fragmented_temporary_buffer::view(buf);
-            view.remove_suffix(buf.size_bytes() - size);
-            assert(size == view.size_bytes());
+            view.remove_suffix(buf.size_bytes() - disk_size);
+            assert(disk_size == view.size_bytes());
             return do_with(off, view, [&] (uint64_t& off, fragmented_temporary_buffer::view& view) {
                 if (view.empty()) {
                     return make_ready_future<>();
                 }
-                return repeat([this, size, &off, &view] {
+                return repeat([this, size = disk_size, &off, &view] {
                     auto&& priority_class = service::get_local_commitlog_priority();
                     auto current = *view.begin();
                     return _file.dma_write(off, current.data(), current.size(), priority_class).then_wrapped([this, size, &off, &view](future<size_t>&& f) {
@@ -776,18 +922,45 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         });
     }
 
-    future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout) {
+    void close_batch_window() {
+        _batch_window_timer.cancel();
+        if (_batch_window) {
+            std::exchange(_batch_window, std::nullopt)->set_value();
+        }
+    }
+
+    // Only the first allocation into an empty buffer opens a window. Once it is
+    // closed, later allocations into the same buffer are written with it.
+    future<> wait_for_batch_window(bool first_in_buffer) {
+        if (!_batch_window) {
+            if (!first_in_buffer) {
+                return make_ready_future<>();
+            }
+            auto window = _segment_manager->batch_window();
+            if (window.count() == 0) {
+                return make_ready_future<>();
+            }
+            _batch_window.emplace();
+            _batch_window_timer.arm(window);
+            ++_segment_manager->totals.batch_windows;
+        }
+        return _batch_window->get_shared_future();
+    }
+
+    future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout, bool first_in_buffer) {
         /**
-         * For batch mode we force a write "immediately".
-         * However, we first wait for all previous writes/flushes
-         * to complete.
+         * For batch mode we force a write "immediately", or when the
+         * group commit window closes. However, we first wait for all
+         * previous writes/flushes to complete.
          *
          * This has the benefit of allowing several allocations to
          * queue up in a single buffer.
          */
         auto me = shared_from_this();
         auto fp = _file_pos;
-        return _pending_ops.wait_for_pending(timeout).then([me, fp, timeout] {
+        return wait_for_batch_window(first_in_buffer).then([me, timeout] {
+            return me->_pending_ops.wait_for_pending(timeout);
+        }).then([me, fp, timeout] {
             if (fp != me->_file_pos) {
                 // some other request already wrote this buffer.
                 // If so, wait for the operation at our intended file offset
@@ -889,7 +1062,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         _gate.leave();
 
         if (_segment_manager->cfg.mode == sync_mode::BATCH) {
-            return batch_cycle(timeout).then([h = std::move(h)](auto s) mutable {
+            if (_batch_window && (_segment_manager->batch_window_full(_num_allocs) || buffer_position() >= db::commitlog::segment::default_size)) {
+                close_batch_window();
+            }
+            return batch_cycle(timeout, _num_allocs == 1).then([h = std::move(h)](auto s) mutable {
                 return make_ready_future<rp_handle>(std::move(h));
             });
         } else {
@@ -910,7 +1086,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     size_t size_on_disk() const {
-        return _file_pos;
+        return _disk_pos;
     }
 
     // ensures no more of this segment is writeable, by allocating any unused section at the end and marking it discarded
@@ -1169,6 +1345,9 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_derive("slack", totals.bytes_slack,
                        sm::description("Counts a number of unused bytes written to the disk due to disk segment alignment.")),
 
+        sm::make_derive("bytes_compressed_saved", totals.bytes_compressed_saved,
+                       sm::description("Counts a number of bytes not written to the disk thanks to compression of segment chunks.")),
+
         sm::make_gauge("pending_flushes", totals.pending_flushes,
                        sm::description("Holds a number of currently pending flushes. See the related flush_limit_exceeded metric.")),
 
@@ -1192,6 +1371,19 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
 
         sm::make_gauge("memory_buffer_bytes", totals.buffer_list_bytes,
                        sm::description("Holds the total number of bytes in internal memory buffers.")),
+
+        sm::make_histogram("batch_size", sm::description("Histogram of the number of entries written to the disk together in a single write cycle. "
+                                                         "In batch mode this is the number of requests sharing a flush."),
+                       [this] { return totals.batch_sizes.get_histogram(1, 12); }),
+
+        sm::make_histogram("flush_latency", sm::description("Histogram of the latency of segment flushes in microseconds."),
+                       [this] { return totals.flush_latency.get_histogram(16, 20); }),
+
+        sm::make_gauge("batch_window", [this] { return batch_window().count(); },
+                       sm::description("Holds the current group commit window of batch mode in microseconds.")),
+
+        sm::make_derive("batch_windows", totals.batch_windows,
+                       sm::description("Counts a number of group commit windows opened in batch mode.")),
     });
 }
 
@@ -1307,7 +1499,7 @@ future<> db::commitlog::segment_manager::rename_file(sstring from, sstring to) c
 }
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment(bool active) {
-    descriptor d(next_id(), cfg.fname_prefix);
+    descriptor d(next_id(), cfg.fname_prefix, cfg.use_compression ? segment::compressed_segment_version : 1);
     auto dst = filename(d);
     auto flags = open_flags::wo;
     if (cfg.use_o_dsync) {
@@ -1821,8 +2013,12 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
         stream<fragmented_temporary_buffer, replay_position> s;
         input_stream<char> fin;
         input_stream<char> r;
+        // Decompressed data of the current chunk of a compressed segment.
+        input_stream<char> chunk_in;
         uint64_t id = 0;
         size_t pos = 0;
+        // Position in the file. Same as pos, unless the segment is compressed.
+        size_t disk_pos = 0;
         size_t next = 0;
         size_t start_off = 0;
         size_t file_size = 0;
@@ -1830,6 +2026,8 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
         bool eof = false;
         bool header = true;
         bool failed = false;
+        bool compressed = false;
+        bool in_chunk = false;
         fragmented_temporary_buffer::reader frag_reader;
 
         work(file f, descriptor din, seastar::io_priority_class read_io_prio_class, position_type o = 0)
@@ -1837,8 +2035,14 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
         }
         work(work&&) = default;
 
+        input_stream<char>& input() {
+            return in_chunk ? chunk_in : fin;
+        }
         bool advance(const fragmented_temporary_buffer& buf) {
             pos += buf.size_bytes();
+            if (!in_chunk) {
+                disk_pos += buf.size_bytes();
+            }
             if (buf.size_bytes() == 0) {
                 eof = true;
             }
@@ -1852,11 +2056,15 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
         }
         future<> skip(size_t bytes) {
             pos += bytes;
-            if (pos > file_size) {
-                eof = true;
-                pos = file_size;
+            if (!in_chunk) {
+                disk_pos += bytes;
+                if (disk_pos > file_size) {
+                    eof = true;
+                    pos -= disk_pos - file_size;
+                    disk_pos = file_size;
+                }
             }
-            return fin.skip(bytes);
+            return input().skip(bytes);
         }
         future<> stop() {
             eof = true;
@@ -1905,6 +2113,7 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
 
                 this->id = id;
                 this->next = 0;
+                this->compressed = ver == segment::compressed_segment_version;
 
                 return make_ready_future<>();
             });
@@ -1936,17 +2145,87 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
                     // if a chunk header checksum is broken, we shall just assume that all
                     // remaining is as well. We cannot trust the "next" pointer, so...
                     clogger.debug("Checksum error in segment chunk at {}.", start);
-                    corrupt_size += (file_size - pos);
+                    corrupt_size += (file_size - disk_pos);
                     return stop();
                 }
 
                 this->next = next;
 
+                if (compressed) {
+                    return read_compressed_chunk(start);
+                }
+                return read_chunk_entries();
+            });
+        }
+        future<> read_chunk_entries() {
+            if (start_off >= next) {
+                return skip(next - pos);
+            }
+            return do_until(std::bind(&work::end_of_chunk, this), std::bind(&work::read_entry, this));
+        }
+        future<> read_compressed_chunk(size_t start) {
+            return frag_reader.read_exactly(fin, segment::compression_header_size).then([this, start](fragmented_temporary_buffer buf) {
+                if (!advance(buf)) {
+                    return make_ready_future<>();
+                }
+
+                auto in = buf.get_istream();
+                auto stored = read<uint32_t>(in);
+                auto compression = read<uint32_t>(in);
+                auto checksum = read<uint32_t>(in);
+
+                crc32_nbo crc;
+                crc.process(stored);
+                crc.process(compression);
+                crc.process<uint32_t>(start);
+
+                if (crc.checksum() != checksum || compression > segment::chunk_lz4 || pos > next) {
+                    clogger.debug("Checksum error in segment chunk compression header at {}.", start);
+                    corrupt_size += (file_size - disk_pos);
+                    return stop();
+                }
+                if (compression == segment::chunk_uncompressed) {
+                    return read_chunk_entries();
+                }
+
+                auto padding = align_up<size_t>(disk_pos + stored, segment::alignment) - (disk_pos + stored);
                 if (start_off >= next) {
-                    return skip(next - pos);
+                    pos = next;
+                    disk_pos += stored + padding;
+                    return fin.skip(stored + padding);
                 }
 
-                return do_until(std::bind(&work::end_of_chunk, this), std::bind(&work::read_entry, this));
+                return frag_reader.read_exactly(fin, stored).then([this, stored, padding, start](fragmented_temporary_buffer buf) {
+                    disk_pos += buf.size_bytes();
+                    if (buf.size_bytes() < stored) {
+                        return stop();
+                    }
+
+                    temporary_buffer<char> src(stored);
+                    auto out = src.get_write();
+                    for (bytes_view frag : fragmented_temporary_buffer::view(buf)) {
+                        out = std::copy_n(reinterpret_cast<const char*>(frag.data()), frag.size(), out);
+                    }
+                    auto len = next - pos;
+                    temporary_buffer<char> data(len);
+                    auto ret = LZ4_decompress_safe(src.get(), data.get_write(), stored, len);
+                    if (ret < 0 || size_t(ret) != len) {
+                        clogger.debug("Failed to decompress segment chunk at {}. Skipping {} bytes", start, stored);
+                        corrupt_size += stored;
+                        pos = next;
+                        disk_pos += padding;
+                        return fin.skip(padding);
+                    }
+
+                    disk_pos += padding;
+                    return fin.skip(padding).then([this, data = std::move(data)] () mutable {
+                        chunk_in = make_buffer_input_stream(std::move(data));
+                        in_chunk = true;
+                        return do_until(std::bind(&work::end_of_chunk, this), std::bind(&work::read_entry, this)).finally([this] {
+                            in_chunk = false;
+                        });
+                    });
+                });
             });
         }
         future<> read_entry() {
@@ -1962,7 +2241,7 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
                 return skip(next - pos);
             }
 
-            return frag_reader.read_exactly(fin, entry_header_size).then([this](fragmented_temporary_buffer buf) {
+            return frag_reader.read_exactly(input(), entry_header_size).then([this](fragmented_temporary_buffer buf) {
                 replay_position rp(id, position_type(pos));
 
                 if (!advance(buf)) {
@@ -1986,7 +2265,7 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
                     return skip(slack);
                 }
 
-                return frag_reader.read_exactly(fin, size - entry_header_size).then([this, size, crc = std::move(crc), rp](fragmented_temporary_buffer buf) mutable {
+                return frag_reader.read_exactly(input(), size - entry_header_size).then([this, size, crc = std::move(crc), rp](fragmented_temporary_buffer buf) mutable {
                     advance(buf);
 
                     auto in = buf.get_istream();
@@ -2078,6 +2357,10 @@ uint64_t db::commitlog::get_flush_count() const {
     return _segment_manager->totals.flush_count;
 }
 
+uint64_t db::commitlog::get_num_batch_windows() const {
+    return _segment_manager->totals.batch_windows;
+}
+
 uint64_t db::commitlog::get_pending_tasks() const {
     return _segment_manager->totals.pending_flushes;
 }
@@ -131,6 +131,13 @@ class commitlog {
 
         bool reuse_segments = true;
         bool use_o_dsync = false;
+        // Upper bound of the time batch mode may delay a write to group it with
+        // concurrent ones. Zero disables grouping beyond requests already queued
+        // behind an ongoing flush.
+        uint64_t commitlog_sync_batch_max_window_in_us = 0;
+        // Compress segment chunks with LZ4. Only affects segments created
+        // from now on, segments of either kind are replayed.
+        bool use_compression = false;
 
         const db::extensions * extensions = nullptr;
     };
@@ -286,6 +293,7 @@ class commitlog {
     uint64_t get_total_size() const;
     uint64_t get_completed_tasks() const;
     uint64_t get_flush_count() const;
+    uint64_t get_num_batch_windows() const;
     uint64_t get_pending_tasks() const;
     uint64_t get_pending_flushes() const;
     uint64_t get_pending_allocations() const;
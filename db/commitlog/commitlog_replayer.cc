@@ -43,10 +43,14 @@
 #include <vector>
 #include <algorithm>
 #include <unordered_map>
+#include <chrono>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/irange.hpp>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/semaphore.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -82,25 +86,7 @@ class db::commitlog_replayer::impl {
 
     future<> init();
 
-    struct stats {
-        uint64_t invalid_mutations = 0;
-        uint64_t skipped_mutations = 0;
-        uint64_t applied_mutations = 0;
-        uint64_t corrupt_bytes = 0;
-
-        stats& operator+=(const stats& s) {
-            invalid_mutations += s.invalid_mutations;
-            skipped_mutations += s.skipped_mutations;
-            applied_mutations += s.applied_mutations;
-            corrupt_bytes += s.corrupt_bytes;
-            return *this;
-        }
-        stats operator+(const stats& s) const {
-            stats tmp = *this;
-            tmp += s;
-            return tmp;
-        }
-    };
+    using stats = commitlog_replayer::stats;
 
     // move start/stop of the thread local bookkeep to "top level"
     // and also make sure to assert on it actually being started.
@@ -111,7 +97,40 @@ class db::commitlog_replayer::impl {
         return _column_mappings.stop();
     }
 
-    future<> process(stats*, fragmented_temporary_buffer buf, replay_position rp) const;
+    // Entries are sent to the shard owning them in batches of about this size,
+    // so that the cost of the cross-shard hop is amortized.
+    static constexpr size_t max_batch_bytes = 1 << 20;
+
+    struct replay_entry {
+        commitlog_entry_reader cer;
+        // Column mapping of the entry's schema version, owned by the reading shard.
+        const column_mapping* src_cm;
+        replay_position rp;
+        size_t size;
+    };
+
+    struct replay_batch {
+        std::vector<replay_entry> entries;
+        size_t bytes = 0;
+    };
+
+    // State of replaying a single segment.
+    struct replay_state {
+        stats s;
+        // Indexed by destination shard.
+        std::vector<replay_batch> batches{smp::count};
+    };
+
+    future<> process(replay_state*, fragmented_temporary_buffer buf, replay_position rp) const;
+    future<> flush(replay_state*, unsigned shard) const;
+    future<> flush_all(replay_state*) const;
+    // Entries written with the current schema of their table are applied to
+    // its memtable in bulk, in groups of up to this many.
+    static constexpr size_t max_bulk_entries = 128;
+
+    future<stats> apply(database& db, replay_batch batch) const;
+    void apply_bulk(database& db, const std::vector<replay_entry*>& group, stats& s) const;
+    void apply_one(database& db, replay_entry& e, stats& s) const;
     future<stats> recover(sstring file, const sstring& fname_prefix) const;
 
     typedef std::unordered_map<utils::UUID, replay_position> rp_map;
@@ -137,8 +156,28 @@ class db::commitlog_replayer::impl {
         _rpm;
     shard_rp_map
         _min_pos;
+
+    // Totals of the last recover().
+    stats _last_stats;
+    std::chrono::duration<double> _last_elapsed{};
 };
 
+db::commitlog_replayer::stats& db::commitlog_replayer::stats::operator+=(const stats& s) {
+    invalid_mutations += s.invalid_mutations;
+    skipped_mutations += s.skipped_mutations;
+    applied_mutations += s.applied_mutations;
+    bulk_applied_mutations += s.bulk_applied_mutations;
+    applied_bytes += s.applied_bytes;
+    corrupt_bytes += s.corrupt_bytes;
+    return *this;
+}
+
+db::commitlog_replayer::stats db::commitlog_replayer::stats::operator+(const stats& s) const {
+    stats tmp = *this;
+    tmp += s;
+    return tmp;
+}
+
 db::commitlog_replayer::impl::impl(seastar::sharded<database>& db)
     : _db(db)
 {}
@@ -222,27 +261,154 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    auto st = make_lw_shared<replay_state>();
     auto& exts = _db.local().extensions();
 
     return db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1,
+            std::bind(&impl::process, this, st.get(), std::placeholders::_1,
                     std::placeholders::_2), p, &exts).then([](auto s) {
         auto f = s->done();
         return f.finally([s = std::move(s)] {});
-    }).then_wrapped([s](future<> f) {
+    }).then_wrapped([this, st](future<> f) {
         try {
             f.get();
         } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
+            st->s.corrupt_bytes += e.bytes();
         } catch (...) {
-            throw;
+            // Entries already decoded were valid, replay them before failing.
+            return flush_all(st.get()).then_wrapped([ep = std::current_exception()] (future<> f) {
+                f.ignore_ready_future();
+                return make_exception_future<stats>(ep);
+            });
         }
-        return make_ready_future<stats>(*s);
+        return flush_all(st.get()).then([st] {
+            return make_ready_future<stats>(st->s);
+        });
+    });
+}
+
+future<> db::commitlog_replayer::impl::flush(replay_state* st, unsigned shard) const {
+    if (st->batches[shard].entries.empty()) {
+        return make_ready_future<>();
+    }
+    auto batch = std::exchange(st->batches[shard], replay_batch());
+    return _db.invoke_on(shard, [this, batch = std::move(batch)] (database& db) mutable {
+        return apply(db, std::move(batch));
+    }).then([st] (stats s) {
+        st->s += s;
+    });
+}
+
+future<> db::commitlog_replayer::impl::flush_all(replay_state* st) const {
+    return parallel_for_each(boost::irange(0u, smp::count), [this, st] (unsigned shard) {
+        return flush(st, shard);
+    });
+}
+
+future<db::commitlog_replayer::impl::stats>
+db::commitlog_replayer::impl::apply(database& db, replay_batch batch) const {
+    std::vector<std::vector<replay_entry*>> groups;
+    // Index in groups of the group being filled for each table.
+    std::unordered_map<utils::UUID, size_t> bulk_groups;
+    for (auto& e : batch.entries) {
+        auto& fm = e.cer.mutation();
+        auto uuid = fm.column_family_id();
+        if (!db.column_family_exists(uuid) || db.find_column_family(uuid).schema()->version() != fm.schema_version()) {
+            groups.push_back({&e});
+            continue;
+        }
+        auto it = bulk_groups.find(uuid);
+        if (it == bulk_groups.end() || groups[it->second].size() == max_bulk_entries) {
+            bulk_groups[uuid] = groups.size();
+            groups.emplace_back();
+            it = bulk_groups.find(uuid);
+        }
+        groups[it->second].push_back(&e);
+    }
+    return do_with(std::move(batch), std::move(groups), stats(), [this, &db] (replay_batch&, std::vector<std::vector<replay_entry*>>& groups, stats& s) {
+        return do_for_each(groups, [this, &db, &s] (const std::vector<replay_entry*>& group) {
+            if (group.size() == 1) {
+                apply_one(db, *group.front(), s);
+            } else {
+                apply_bulk(db, group, s);
+            }
+            return make_ready_future<>();
+        }).then([&s] {
+            return s;
+        });
     });
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, fragmented_temporary_buffer buf, replay_position rp) const {
+void db::commitlog_replayer::impl::apply_bulk(database& db, const std::vector<replay_entry*>& group, stats& s) const {
+    try {
+        auto& fm = group.front()->cer.mutation();
+        auto& cf = db.find_column_family(fm.column_family_id());
+        auto schema = cf.schema();
+        // The schema may have changed since the group was formed.
+        if (schema->version() == fm.schema_version()) {
+            auto ms = boost::copy_range<std::vector<const frozen_mutation*>>(group | boost::adaptors::transformed([] (replay_entry* e) {
+                return &e->cer.mutation();
+            }));
+            cf.apply(ms, schema);
+            for (auto e : group) {
+                s.applied_bytes += e->size;
+            }
+            s.applied_mutations += group.size();
+            s.bulk_applied_mutations += group.size();
+            return;
+        }
+    } catch (...) {
+        rlogger.debug("error replaying {} entries at once, replaying them one by one: {}", group.size(), std::current_exception());
+    }
+    // Applying a mutation again is harmless, so those applied before a
+    // failure don't need to be told apart.
+    for (auto e : group) {
+        apply_one(db, *e, s);
+    }
+}
+
+void db::commitlog_replayer::impl::apply_one(database& db, replay_entry& e, stats& s) const {
+    try {
+        auto& fm = e.cer.mutation();
+        // TODO: might need better verification that the deserialized mutation
+        // is schema compatible. My guess is that just applying the mutation
+        // will not do this.
+        auto& cf = db.find_column_family(fm.column_family_id());
+
+        if (rlogger.is_enabled(logging::log_level::debug)) {
+            rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
+                    cf.schema()->ks_name(), cf.schema()->cf_name(), e.rp);
+        }
+        // Removed forwarding "new" RP. Instead give none/empty.
+        // This is what origin does, and it should be fine.
+        // The end result should be that once sstables are flushed out
+        // their "replay_position" attribute will be empty, which is
+        // lower than anything the new session will produce.
+        if (cf.schema()->version() != fm.schema_version()) {
+            auto& local_cm = _column_mappings.local().map;
+            auto cm_it = local_cm.find(fm.schema_version());
+            if (cm_it == local_cm.end()) {
+                cm_it = local_cm.emplace(fm.schema_version(), *e.src_cm).first;
+            }
+            const column_mapping& cm = cm_it->second;
+            mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
+            converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
+            fm.partition().accept(cm, v);
+            cf.apply(std::move(m));
+        } else {
+            cf.apply(fm, cf.schema());
+        }
+        s.applied_mutations++;
+        s.applied_bytes += e.size;
+    } catch (...) {
+        s.invalid_mutations++;
+        // TODO: write mutation to file like origin.
+        rlogger.warn("error replaying: {}", std::current_exception());
+    }
+}
+
+future<> db::commitlog_replayer::impl::process(replay_state* st, fragmented_temporary_buffer buf, replay_position rp) const {
+    auto s = &st->s;
     try {
 
         commitlog_entry_reader cer(buf);
@@ -275,43 +441,14 @@ future<> db::commitlog_replayer::impl::process(stats* s, fragmented_temporary_bu
         }
 
         auto shard = _db.local().shard_of(fm);
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp, shard, s] (database& db) -> future<> {
-            auto& fm = cer.mutation();
-            // TODO: might need better verification that the deserialized mutation
-            // is schema compatible. My guess is that just applying the mutation
-            // will not do this.
-            auto& cf = db.find_column_family(fm.column_family_id());
-
-            if (rlogger.is_enabled(logging::log_level::debug)) {
-                rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
-            }
-            // Removed forwarding "new" RP. Instead give none/empty.
-            // This is what origin does, and it should be fine.
-            // The end result should be that once sstables are flushed out
-            // their "replay_position" attribute will be empty, which is
-            // lower than anything the new session will produce.
-            if (cf.schema()->version() != fm.schema_version()) {
-                auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.find(fm.schema_version());
-                if (cm_it == local_cm.end()) {
-                    cm_it = local_cm.emplace(fm.schema_version(), src_cm).first;
-                }
-                const column_mapping& cm = cm_it->second;
-                mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
-                converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
-                fm.partition().accept(cm, v);
-                cf.apply(std::move(m));
-            } else {
-                cf.apply(fm, cf.schema());
-            }
-            s->applied_mutations++;
-            return make_ready_future<>();
-        }).handle_exception([s](auto ep) {
-            s->invalid_mutations++;
-            // TODO: write mutation to file like origin.
-            rlogger.warn("error replaying: {}", ep);
-        });
+        auto& batch = st->batches[shard];
+        auto size = buf.size_bytes();
+        batch.entries.push_back(replay_entry{std::move(cer), &src_cm, rp, size});
+        batch.bytes += size;
+        if (batch.bytes >= max_batch_bytes) {
+            return flush(st, shard);
+        }
+        return make_ready_future<>();
     } catch (no_such_column_family&) {
         // No such CF now? Origin just ignores this.
     } catch (...) {
@@ -358,37 +495,47 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
 
     return do_with(std::move(fname_prefix), [this, map] (sstring& fname_prefix) {
         return _impl->start().then([this, map, &fname_prefix] {
+            auto started = std::chrono::steady_clock::now();
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    // The number of segments replayed concurrently by a shard is limited
+                    // to reduce mutation congestion.
+                    auto parallelism = std::max(_impl->_db.local().get_config().commitlog_replay_parallelism(), 1u);
+                    auto sem = ::make_lw_shared<semaphore>(parallelism);
                     auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
-                        auto&f = p.second;
-                        rlogger.debug("Replaying {}", f);
-                        return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
-                            if (stats.corrupt_bytes != 0) {
-                                rlogger.warn("Corrupted file: {}. {} bytes skipped.", f, stats.corrupt_bytes);
-                            }
-                            rlogger.debug("Log replay of {} complete, {} replayed mutations ({} invalid, {} skipped)"
-                                            , f
-                                            , stats.applied_mutations
-                                            , stats.invalid_mutations
-                                            , stats.skipped_mutations
-                            );
-                            *total += stats;
+                    return parallel_for_each(range.first, range.second, [this, total, sem, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
+                        return with_semaphore(*sem, 1, [this, total, &p, &fname_prefix] {
+                            auto&f = p.second;
+                            rlogger.debug("Replaying {}", f);
+                            return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
+                                if (stats.corrupt_bytes != 0) {
+                                    rlogger.warn("Corrupted file: {}. {} bytes skipped.", f, stats.corrupt_bytes);
+                                }
+                                rlogger.debug("Log replay of {} complete, {} replayed mutations ({} invalid, {} skipped)"
+                                                , f
+                                                , stats.applied_mutations
+                                                , stats.invalid_mutations
+                                                , stats.skipped_mutations
+                                );
+                                *total += stats;
+                            });
                         });
-                    }).then([total] {
+                    }).then([total, sem] {
                         return make_ready_future<impl::stats>(*total);
                     });
                 });
-            }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
-                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
+            }, impl::stats(), std::plus<impl::stats>()).then([this, started](impl::stats totals) {
+                _impl->_last_stats = totals;
+                _impl->_last_elapsed = std::chrono::steady_clock::now() - started;
+                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped, {} in bulk) in {:.3f}s, {:.2f} MB/s, {:.0f} mutations/s"
                                 , totals.applied_mutations
                                 , totals.invalid_mutations
                                 , totals.skipped_mutations
+                                , totals.bulk_applied_mutations
+                                , get_elapsed().count()
+                                , mb_per_sec()
+                                , mutations_per_sec()
                 );
             });
         }).finally([this] {
@@ -401,3 +548,22 @@ future<> db::commitlog_replayer::recover(sstring f, sstring fname_prefix) {
     return recover(std::vector<sstring>{ f }, std::move(fname_prefix));
 }
 
+const db::commitlog_replayer::stats& db::commitlog_replayer::get_stats() const {
+    return _impl->_last_stats;
+}
+
+std::chrono::duration<double> db::commitlog_replayer::get_elapsed() const {
+    return _impl->_last_elapsed;
+}
+
+// Zero rather than NaN or infinity if no time was measured.
+double db::commitlog_replayer::mb_per_sec() const {
+    auto elapsed = get_elapsed().count();
+    return elapsed > 0 ? double(get_stats().applied_bytes) / (1024 * 1024) / elapsed : 0.0;
+}
+
+double db::commitlog_replayer::mutations_per_sec() const {
+    auto elapsed = get_elapsed().count();
+    return elapsed > 0 ? get_stats().applied_mutations / elapsed : 0.0;
+}
+
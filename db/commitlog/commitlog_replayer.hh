@@ -41,6 +41,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
@@ -56,11 +57,30 @@ class commitlog_replayer {
     commitlog_replayer(commitlog_replayer&&) noexcept;
     ~commitlog_replayer();
 
+    struct stats {
+        uint64_t invalid_mutations = 0;
+        uint64_t skipped_mutations = 0;
+        uint64_t applied_mutations = 0;
+        // Mutations applied to a memtable together with other mutations of the same table.
+        uint64_t bulk_applied_mutations = 0;
+        uint64_t applied_bytes = 0;
+        uint64_t corrupt_bytes = 0;
+
+        stats& operator+=(const stats& s);
+        stats operator+(const stats& s) const;
+    };
+
     static future<commitlog_replayer> create_replayer(seastar::sharded<database>&);
 
     future<> recover(std::vector<sstring> files, sstring fname_prefix);
     future<> recover(sstring file, sstring fname_prefix);
 
+    // Totals of the last recover(), and how long it took.
+    const stats& get_stats() const;
+    std::chrono::duration<double> get_elapsed() const;
+    double mb_per_sec() const;
+    double mutations_per_sec() const;
+
 private:
     commitlog_replayer(seastar::sharded<database>&);
 
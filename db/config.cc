@@ -171,6 +171,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , compaction_parallelism(this, "compaction_parallelism", value_status::Used, 1,
+        "Number of disjoint token sub-ranges which major compaction, cleanup, upgrade and scrub of a table are split into on every shard. The sub-ranges are compacted concurrently, each of them producing its own sstables, which form a single run of non-overlapping sstables.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -300,6 +302,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_batch_max_window_in_us(this, "commitlog_sync_batch_max_window_in_us", value_status::Used, 1000,
+        "Upper bound, in microseconds, of the time a write may be delayed in \"batch\" mode so that it is written and synced together with concurrent writes. "
+        "The actual window adapts to the observed sync latency and is not used when writes don't overlap. Set to 0 to disable.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -307,6 +312,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to re-use commitlog segments when finished instead of deleting them. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_o_dsync(this, "commitlog_use_o_dsync", value_status::Used, true,
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
+    , commitlog_use_compression(this, "commitlog_use_compression", value_status::Used, false,
+        "Whether or not to compress commitlog segments with LZ4. Reduces the amount of data written for compressible mutations at the cost of CPU. Segments written either way can be replayed regardless of this setting.\n")
+    , commitlog_replay_parallelism(this, "commitlog_replay_parallelism", value_status::Used, 2,
+        "Number of commitlog segments each shard reads concurrently when replaying the commitlog on startup. Decoded mutations are sent to the shards owning them in large batches.")
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -635,7 +644,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , api_address(this, "api_address", value_status::Used, "", "Http Rest API address")
     , api_ui_dir(this, "api_ui_dir", value_status::Used, "swagger-ui/dist/", "The directory location of the API GUI")
     , api_doc_dir(this, "api_doc_dir", value_status::Used, "api/api-doc/", "The API definition file directory")
-    , load_balance(this, "load_balance", value_status::Used, "none", "CQL request load balancing: 'none' or round-robin'")
+    , load_balance(this, "load_balance", value_status::Used, "none", "CQL request load balancing: 'none', 'round-robin' or 'owning-shard'."
+        " With 'owning-shard', a request executing a prepared statement which binds the whole partition key is executed on the shard owning the partition.")
     , consistent_rangemovement(this, "consistent_rangemovement", value_status::Used, true, "When set to true, range movements will be consistent. It means: 1) it will refuse to bootstrap a new node if other bootstrapping/leaving/moving nodes detected. 2) data will be streamed to a new node only from the node which is no longer responsible for the token range. Same as -Dcassandra.consistent.rangemovement in cassandra")
     , join_ring(this, "join_ring", value_status::Used, true, "When set to true, a node will join the token ring. When set to false, a node will not join the token ring. User can use nodetool join to initiate ring joinging later. Same as -Dcassandra.join_ring in cassandra.")
     , load_ring_state(this, "load_ring_state", value_status::Used, true, "When set to true, load tokens and host_ids previously saved. Same as -Dcassandra.load_ring_state in cassandra.")
@@ -668,11 +678,33 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_building_batch_size(this, "view_building_batch_size", value_status::Used, 128, "Number of base rows read from sstables by each view building step. Larger batches amortize the per-step overhead when building views of large tables,"
+        " at the cost of longer steps. The rows are still flushed to the views whenever they take more than 1MB of memory.")
+    , view_building_throughput_mb_per_sec(this, "view_building_throughput_mb_per_sec", value_status::Used, 0, "Throttles view building from existing base data to the specified rate, measured as the in-memory size of the base rows read, in MB per second."
+        " Setting this to zero disables throttling.")
+    , view_update_coalescing_window_in_ms(this, "view_update_coalescing_window_in_ms", value_status::Used, 0, "How long view updates generated by writes to the same base partition are held back, so that updates of the same view partition are sent as a single mutation."
+        " Set to zero to send view updates right away.")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Used, true, "Enable SSTables 'mc' format to be used as the default file format")
+    , enable_sstables_split_block_filter(this, "enable_sstables_split_block_filter", value_status::Used, false, "Write sstable bloom filters in a Scylla-specific split block layout, which costs a single cache miss per lookup."
+        " SSTables written this way cannot be read by Cassandra or by older Scylla versions. Takes effect once all nodes in the cluster enable it.")
+    , enable_sstables_partition_index(this, "enable_sstables_partition_index", value_status::Used, false, "Write a PartitionIndex component with 'mc' SSTables: a page-aligned trie over partition keys which locates a single partition without the summary."
+        " The summary of such SSTables is sampled sparsely to save memory, which makes the start of range scans slightly more expensive. Other versions ignore the component.")
+    , cache_admission_policy(this, "cache_admission_policy", value_status::Used, "lru", "Policy deciding whether data read from SSTables is populated into the row cache. Possible values are:\n"
+        "\tlru : everything is populated, the least recently used entries are evicted to make room for it.\n"
+        "\ttinylfu : a partition is populated only if it was read more often than the recently evicted ones, so that scans don't evict frequently read data.")
+    , cache_scan_population_limit_in_mb(this, "cache_scan_population_limit_in_mb", value_status::Used, 0, "A range scan which populated more than this amount of data into the row cache reads the remaining partitions missing in cache directly from SSTables,"
+        " leaving the cache to other queries. 0 means no limit. Individual queries can skip the cache with BYPASS CACHE.")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
         " It is not enough to have ever since upgraded to newer versions of Cassandra. If you EVER used a version earlier than 2.1 in the cluster where these SSTables come from, DO NOT TURN ON THIS OPTION! You will corrupt your data. You have been warned.")
     , enable_shard_aware_drivers(this, "enable_shard_aware_drivers", value_status::Used, true, "Enable native transport drivers to use connection-per-shard for better performance")
     , enable_ipv6_dns_lookup(this, "enable_ipv6_lookup", value_status::Used, false, "Use IPv6 address resolution")
+    , enable_repair_range_hashes(this, "enable_repair_range_hashes", value_status::Used, false, "Remember the combined hash of every range repaired by row level repair in system.repair_range_hashes, for as long as the data of the range doesn't change."
+        " A later repair of the range compares the remembered hashes first, and skips reading the range when they match on all replicas."
+        " Repairs started by this node then hash rows with a fixed seed instead of a random one.")
+    , enable_sstable_file_streaming(this, "enable_sstable_file_streaming", value_status::Used, false, "Stream SSTables which are entirely contained in the streamed ranges by sending their files as they are, instead of reading and rewriting every row."
+        " The receiver falls back to rewriting a received SSTable if it contains data of more than one of its shards.")
+    , enable_parallelized_aggregation(this, "enable_parallelized_aggregation", value_status::Used, false, "Compute count(*) and the count, sum, min and max of columns over a whole table on the nodes which own the data, in parallel on all of their shards, instead of reading every row on the coordinator."
+        " The coordinator merges the partial results.")
 
     , default_log_level(this, "default_log_level", value_status::Used)
     , logger_log_level(this, "logger_log_level", value_status::Used)
@@ -108,6 +108,7 @@ class config : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> compaction_parallelism;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -138,9 +139,12 @@ class config : public utils::config_file {
     named_value<uint32_t> commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_sync_batch_max_window_in_us;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments;
     named_value<bool> commitlog_use_o_dsync;
+    named_value<bool> commitlog_use_compression;
+    named_value<uint32_t> commitlog_replay_parallelism;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -275,10 +279,20 @@ class config : public utils::config_file {
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<uint32_t> view_building_batch_size;
+    named_value<uint32_t> view_building_throughput_mb_per_sec;
+    named_value<uint32_t> view_update_coalescing_window_in_ms;
     named_value<bool> enable_sstables_mc_format;
+    named_value<bool> enable_sstables_split_block_filter;
+    named_value<bool> enable_sstables_partition_index;
+    named_value<sstring> cache_admission_policy;
+    named_value<uint32_t> cache_scan_population_limit_in_mb;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
     named_value<bool> enable_shard_aware_drivers;
     named_value<bool> enable_ipv6_dns_lookup;
+    named_value<bool> enable_repair_range_hashes;
+    named_value<bool> enable_sstable_file_streaming;
+    named_value<bool> enable_parallelized_aggregation;
 
     seastar::logging_settings logging_settings(const boost::program_options::variables_map&) const;
 
@@ -518,6 +518,23 @@ static schema_ptr large_cells() {
     return large_cells;
 }
 
+static schema_ptr repair_range_hashes() {
+    static thread_local auto repair_range_hashes = [] {
+        auto id = generate_legacy_id(NAME, REPAIR_RANGE_HASHES);
+        return schema_builder(NAME, REPAIR_RANGE_HASHES, std::optional(id))
+                .with_column("table_uuid", uuid_type, column_kind::partition_key)
+                .with_column("shard", int32_type, column_kind::clustering_key)
+                .with_column("range", utf8_type, column_kind::clustering_key)
+                .with_column("shard_count", int32_type)
+                .with_column("sstables", set_type_impl::get_instance(long_type, true))
+                .with_column("hash", long_type)
+                .set_comment("combined hashes of the ranges read by row level repair")
+                .with_version(generate_schema_version(id))
+                .build();
+    }();
+    return repair_range_hashes;
+}
+
 /*static*/ schema_ptr scylla_local() {
     static thread_local auto scylla_local = [] {
         schema_builder builder(make_lw_shared(schema(generate_legacy_id(NAME, SCYLLA_LOCAL), NAME, SCYLLA_LOCAL,
@@ -1628,6 +1645,34 @@ future<std::optional<sstring>> get_scylla_local_param(const sstring& key){
     });
 }
 
+future<> save_repair_range_hash(utils::UUID table_id, const dht::token_range& range, repair_range_hash entry) {
+    sstring req = format("INSERT INTO system.{} (table_uuid, shard, range, shard_count, sstables, hash) VALUES (?, ?, ?, ?, ?, ?)", REPAIR_RANGE_HASHES);
+    auto set_type = set_type_impl::get_instance(long_type, true);
+    set_type_impl::native_type sstables(entry.sstables.begin(), entry.sstables.end());
+    return execute_cql(req, table_id, int32_t(engine().cpu_id()), format("{}", range), int32_t(smp::count),
+            make_set_value(set_type, std::move(sstables)), int64_t(entry.hash)).discard_result();
+}
+
+future<std::optional<repair_range_hash>> get_repair_range_hash(utils::UUID table_id, const dht::token_range& range) {
+    sstring req = format("SELECT shard_count, sstables, hash FROM system.{} WHERE table_uuid = ? AND shard = ? AND range = ?", REPAIR_RANGE_HASHES);
+    return execute_cql(req, table_id, int32_t(engine().cpu_id()), format("{}", range)).then([] (::shared_ptr<cql3::untyped_result_set> res) {
+        // Entries saved with a different number of shards were read from
+        // other data.
+        if (res->empty() || res->one().get_as<int32_t>("shard_count") != int32_t(smp::count)) {
+            return std::optional<repair_range_hash>();
+        }
+        auto& row = res->one();
+        repair_range_hash entry;
+        if (row.has("sstables")) {
+            auto sstables = row.get_set<int64_t>("sstables");
+            entry.sstables.assign(sstables.begin(), sstables.end());
+            std::sort(entry.sstables.begin(), entry.sstables.end());
+        }
+        entry.hash = row.get_as<int64_t>("hash");
+        return std::optional<repair_range_hash>(std::move(entry));
+    });
+}
+
 future<> update_schema_version(utils::UUID version) {
     sstring req = format("INSERT INTO system.{} (key, schema_version) VALUES (?, ?)", LOCAL);
     return execute_cql(req, sstring(LOCAL), version).discard_result();
@@ -1758,7 +1803,7 @@ std::vector<schema_ptr> all_tables() {
                     peers(), peer_events(), range_xfers(),
                     compactions_in_progress(), compaction_history(),
                     sstable_activity(), size_estimates(), large_partitions(), large_rows(), large_cells(),
-                    scylla_local(), v3::views_builds_in_progress(), v3::built_views(),
+                    scylla_local(), repair_range_hashes(), v3::views_builds_in_progress(), v3::built_views(),
                     v3::scylla_views_builds_in_progress(),
                     v3::truncated(),
     });
@@ -92,6 +92,7 @@ static constexpr auto LARGE_PARTITIONS = "large_partitions";
 static constexpr auto LARGE_ROWS = "large_rows";
 static constexpr auto LARGE_CELLS = "large_cells";
 static constexpr auto SCYLLA_LOCAL = "scylla_local";
+static constexpr auto REPAIR_RANGE_HASHES = "repair_range_hashes";
 
 namespace v3 {
 static constexpr auto BATCHES = "batches";
@@ -178,6 +179,16 @@ future<> update_hints_dropped(gms::inet_address ep, utils::UUID time_period, int
 future<> set_scylla_local_param(const sstring& key, const sstring& value);
 future<std::optional<sstring>> get_scylla_local_param(const sstring& key);
 
+// The combined hash of the rows of a range of a table on this shard, remembered
+// by row level repair, and the generations of the sstables it was read from.
+struct repair_range_hash {
+    std::vector<int64_t> sstables;
+    uint64_t hash;
+};
+
+future<> save_repair_range_hash(utils::UUID table_id, const dht::token_range& range, repair_range_hash entry);
+future<std::optional<repair_range_hash>> get_repair_range_hash(utils::UUID table_id, const dht::token_range& range);
+
 std::vector<schema_ptr> all_tables();
 void make(database& db, bool durable, bool volatile_testing_only = false);
 
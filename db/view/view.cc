@@ -42,20 +42,24 @@
 #include <deque>
 #include <functional>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/algorithm/transform.hpp>
+#include <boost/range/irange.hpp>
 #include <boost/range/adaptors.hpp>
 
 #include <seastar/core/future-util.hh>
+#include <seastar/core/sleep.hh>
 
 #include "database.hh"
 #include "clustering_bounds_comparator.hh"
 #include "cql3/statements/select_statement.hh"
 #include "cql3/util.hh"
+#include "db/config.hh"
 #include "db/view/view.hh"
 #include "db/view/view_builder.hh"
 #include "db/system_keyspace_view_types.hh"
@@ -67,6 +71,7 @@
 #include "mutation.hh"
 #include "mutation_partition.hh"
 #include "service/migration_manager.hh"
+#include "service/priority_manager.hh"
 #include "service/storage_service.hh"
 #include "view_info.hh"
 #include "view_update_checks.hh"
@@ -1002,6 +1007,50 @@ get_view_natural_endpoint(const sstring& keyspace_name,
     return view_endpoints[base_it - base_endpoints.begin()];
 }
 
+using account_failure_func = noncopyable_function<future<> (future<>&&, gms::inet_address, bool, size_t)>;
+
+static future<> send_view_update(frozen_mutation_and_schema mut, account_failure_func maybe_account_failure, gms::inet_address target,
+        db::view::stats& stats, service::allow_hints allow_hints) {
+    return service::get_local_storage_proxy().send_to_endpoint(
+            std::move(mut),
+            target,
+            { },
+            db::write_type::VIEW,
+            stats,
+            allow_hints).then_wrapped([target, maybe_account_failure = std::move(maybe_account_failure)] (future<>&& f) mutable {
+        return maybe_account_failure(std::move(f), target, false, 1);
+    });
+}
+
+// View updates of a single base partition which are paired with the same
+// remote view replica, and have no pending endpoints.
+struct view_update_batch {
+    std::vector<frozen_mutation> mutations;
+    std::vector<schema_ptr> schemas;
+    std::vector<account_failure_func> failure_accounting;
+};
+
+// Sends the batch in a single message. If that fails, the updates are sent
+// one by one, so that they are hinted if the replica is unreachable.
+static future<> send_view_updates(view_update_batch batch, gms::inet_address target, db::view::stats& stats, service::allow_hints allow_hints) {
+    stats.view_updates_batched += batch.mutations.size();
+    stats.writes += batch.mutations.size();
+    return do_with(std::move(batch), [target, &stats, allow_hints] (view_update_batch& batch) {
+        return service::get_local_storage_proxy().send_view_mutations(target, batch.mutations).then_wrapped(
+                [&batch, target, &stats, allow_hints] (future<>&& f) {
+            stats.writes -= batch.mutations.size();
+            if (!f.failed()) {
+                return make_ready_future<>();
+            }
+            vlogger.debug("Failed to send {} view updates to {} at once, sending them one by one: {}", batch.mutations.size(), target, f.get_exception());
+            return parallel_for_each(boost::irange<size_t>(0, batch.mutations.size()), [&batch, target, &stats, allow_hints] (size_t i) {
+                return send_view_update(frozen_mutation_and_schema{std::move(batch.mutations[i]), batch.schemas[i]},
+                        std::move(batch.failure_accounting[i]), target, stats, allow_hints);
+            });
+        });
+    });
+}
+
 // Take the view mutations generated by generate_view_updates(), which pertain
 // to a modification of a single base partition, and apply them to the
 // appropriate paired replicas. This is done asynchronously - we do not wait
@@ -1017,6 +1066,10 @@ future<> mutate_MV(
     auto fs = std::make_unique<std::vector<future<>>>();
     fs->reserve(view_updates.size());
     auto& partitioner = dht::global_partitioner();
+    // Updates of several view partitions paired with the same remote replica
+    // are sent in a single message, once the whole cluster understands it.
+    bool batch_remote_updates = view_updates.size() > 1 && service::get_local_storage_service().cluster_supports_view_update_batches();
+    std::unordered_map<gms::inet_address, view_update_batch> batches;
     for (frozen_mutation_and_schema& mut : view_updates) {
         auto view_token = partitioner.get_token(*mut.s, mut.fm.key(*mut.s));
         auto& keyspace_name = mut.s->ks_name();
@@ -1069,6 +1122,11 @@ future<> mutate_MV(
                     --stats.writes;
                     return maybe_account_failure(std::move(f), utils::fb_utilities::get_broadcast_address(), true, 0);
                 }));
+            } else if (batch_remote_updates && pending_endpoints.empty()) {
+                auto& batch = batches[*paired_endpoint];
+                batch.mutations.push_back(std::move(mut.fm));
+                batch.schemas.push_back(std::move(mut.s));
+                batch.failure_accounting.emplace_back(std::move(maybe_account_failure));
             } else {
                 vlogger.debug("Sending view update to endpoint {}, with pending endpoints = {}", *paired_endpoint, pending_endpoints);
                 // Note we don't wait for the asynchronous operation to complete
@@ -1120,6 +1178,15 @@ future<> mutate_MV(
             }));
         }
     }
+    for (auto& [target, batch] : batches) {
+        if (batch.mutations.size() == 1) {
+            fs->push_back(send_view_update(frozen_mutation_and_schema{std::move(batch.mutations.front()), std::move(batch.schemas.front())},
+                    std::move(batch.failure_accounting.front()), target, stats, allow_hints));
+        } else {
+            vlogger.debug("Sending {} view updates to endpoint {}", batch.mutations.size(), target);
+            fs->push_back(send_view_updates(std::move(batch), target, stats, allow_hints));
+        }
+    }
     auto f = seastar::when_all_succeed(fs->begin(), fs->end());
     return f.finally([fs = std::move(fs)] { });
 }
@@ -1127,7 +1194,8 @@ future<> mutate_MV(
 view_builder::view_builder(database& db, db::system_distributed_keyspace& sys_dist_ks, service::migration_manager& mm)
         : _db(db)
         , _sys_dist_ks(sys_dist_ks)
-        , _mm(mm) {
+        , _mm(mm)
+        , _batch_size(std::max<size_t>(db.get_config().view_building_batch_size(), 1)) {
 }
 
 future<> view_builder::start() {
@@ -1195,7 +1263,7 @@ void view_builder::initialize_reader_at_current_token(build_step& step) {
             make_lw_shared(sstables::sstable_set(step.base->get_sstable_set())),
             step.prange,
             step.pslice,
-            default_priority_class(),
+            service::get_local_view_build_read_priority(),
             no_resource_tracking(),
             nullptr,
             streamed_mutation::forwarding::no,
@@ -1496,6 +1564,11 @@ future<> view_builder::do_build_step() {
     return seastar::async([this] {
         exponential_backoff_retry r(1s, 1min);
         while (!_base_to_build_step.empty() && !_as.abort_requested()) {
+            try {
+                throttle();
+            } catch (const seastar::sleep_aborted&) {
+                return;
+            }
             auto units = get_units(_sem, 1).get0();
             try {
                 execute(_current_step->second, exponential_backoff_retry(1s, 1min));
@@ -1521,6 +1594,24 @@ future<> view_builder::do_build_step() {
     });
 }
 
+// Called in the context of a seastar::thread, before taking _sem, so that
+// bookkeeping operations aren't held back while we wait. Charges the rows read
+// by the previous steps against view_building_throughput_mb_per_sec and sleeps
+// until they are paid for. Idle time is not carried over as credit.
+void view_builder::throttle() {
+    auto bytes = std::exchange(_bytes_read, 0);
+    auto mb_per_sec = _db.get_config().view_building_throughput_mb_per_sec();
+    if (!mb_per_sec) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto cost = std::chrono::duration<double>(double(bytes) / (uint64_t(mb_per_sec) << 20));
+    _next_step_time = std::max(_next_step_time, now) + std::chrono::duration_cast<std::chrono::steady_clock::duration>(cost);
+    if (_next_step_time > now) {
+        sleep_abortable(_next_step_time - now, _as).get();
+    }
+}
+
 // Called in the context of a seastar::thread.
 class view_builder::consumer {
 public:
@@ -1556,7 +1647,7 @@ class view_builder::consumer {
     std::vector<view_ptr> _views_to_build;
     std::deque<mutation_fragment> _fragments;
     // The compact_for_query<> that feeds this consumer is already configured
-    // to feed us up to view_builder::batchsize (128) rows and not an entire
+    // to feed us up to view_builder::_batch_size rows and not an entire
     // partition. Still, if rows contain large blobs, saving 128 of them in
     // _fragments may be too much. So we want to track _fragment's memory
     // usage, and flush the _fragments if it has grown too large.
@@ -1627,11 +1718,13 @@ class view_builder::consumer {
             return stop_iteration::yes;
         }
 
-        _fragments_memory_usage += cr.memory_usage(*_step.base->schema());
+        auto memory_usage = cr.memory_usage(*_step.base->schema());
+        _fragments_memory_usage += memory_usage;
+        _builder._bytes_read += memory_usage;
         _fragments.push_back(std::move(cr));
         if (_fragments_memory_usage > batch_memory_max) {
             // Although we have not yet completed the batch of base rows that
-            // compact_for_query<> planned for us (view_builder::batchsize),
+            // compact_for_query<> planned for us (view_builder::_batch_size),
             // we've still collected enough rows to reach sizeable memory use,
             // so let's flush these rows now.
             flush_fragments();
@@ -1688,7 +1781,7 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
             *step.reader.schema(),
             gc_clock::now(),
             step.pslice,
-            batch_size,
+            _batch_size,
             query::max_partitions,
             view_builder::consumer{*this, step});
     consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
@@ -48,6 +48,12 @@ struct stats : public service::storage_proxy_stats::write_stats {
     int64_t view_updates_pushed_remote = 0;
     int64_t view_updates_failed_local = 0;
     int64_t view_updates_failed_remote = 0;
+    // Number of updates merged into another update of the same view partition.
+    int64_t view_updates_coalesced = 0;
+    // Number of updates sent to a remote view replica together with other updates.
+    int64_t view_updates_batched = 0;
+    // Number of base writes whose read-before-write was shared with another write.
+    int64_t view_update_reads_batched = 0;
 
     stats(const sstring& category) : service::storage_proxy_stats::write_stats(category, false) { }
 };
@@ -41,6 +41,7 @@
 #include <seastar/core/shared_future.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <chrono>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -64,7 +65,12 @@ namespace db::view {
  *
  * We aim to be resource-conscious. On a given shard, at any given moment, we consume at most
  * from one reader. We also strive for fairness, in that each build step inserts entries for
- * the views of a different base. Each build step reads and generates updates for batch_size rows.
+ * the views of a different base. Each build step reads and generates updates for the number of rows
+ * configured by view_building_batch_size.
+ *
+ * The base data is read straight from the sstables, bypassing the row cache and memtables, so that
+ * building a view of a large table doesn't evict the working set from cache. Reads are done under a
+ * dedicated I/O priority class, which bounds the disk bandwidth view building takes from queries.
  *
  * We lack a controller, which could potentially allow us to go faster (to execute multiple steps at
  * the same time, or consume more rows per batch), and also which would apply backpressure, so we
@@ -164,12 +170,19 @@ class view_builder final : public service::migration_listener::only_view_notific
     seastar::shared_promise<> _shards_finished_read_promise;
     // Used for testing.
     std::unordered_map<std::pair<sstring, sstring>, seastar::shared_promise<>, utils::tuple_hash> _build_notifiers;
+    // Number of rows processed by each build step.
+    size_t _batch_size;
+    // Size of the base rows read by the build steps since the last call to throttle().
+    size_t _bytes_read = 0;
+    // When the next build step may start, if view building is throttled.
+    std::chrono::steady_clock::time_point _next_step_time;
 
 public:
-    // The view builder processes the base table in steps of batch_size rows.
-    // However, if the individual rows are large, there is no real need to
-    // collect batch_size of them in memory at once. Rather, as soon as we've
-    // collected batch_memory_max bytes, we can process the rows read so far.
+    // The view builder processes the base table in steps of _batch_size rows,
+    // which defaults to batch_size. However, if the individual rows are large,
+    // there is no real need to collect that many of them in memory at once.
+    // Rather, as soon as we've collected batch_memory_max bytes, we can process
+    // the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
 
@@ -205,6 +218,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     future<> add_new_view(view_ptr, build_step&);
     future<> do_build_step();
     void execute(build_step&, exponential_backoff_retry);
+    void throttle();
     future<> maybe_mark_view_as_built(view_ptr, dht::token);
 
     struct consumer;
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "view_update_coalescer.hh"
+#include "database.hh"
+
+namespace db::view {
+
+view_update_coalescer::view_update_coalescer(stats& stats, ::cf_stats* cf_stats, std::chrono::milliseconds window)
+        : _stats(stats)
+        , _cf_stats(cf_stats)
+        , _window(window)
+        , _timer([this] { flush(); }) {
+}
+
+void view_update_coalescer::add(const dht::token& base_token, std::vector<frozen_mutation_and_schema> updates, db::timeout_semaphore_units units) {
+    if (_window == std::chrono::milliseconds::zero()) {
+        propagate(base_token, std::move(updates), std::move(units));
+        return;
+    }
+    auto& pending = _pending[base_token];
+    for (auto& update : updates) {
+        _pending_bytes += update.fm.representation().size();
+        pending.updates.push_back(std::move(update));
+    }
+    if (pending.units) {
+        pending.units->adopt(std::move(units));
+    } else {
+        pending.units.emplace(std::move(units));
+    }
+    if (_pending_bytes >= max_pending_bytes) {
+        flush();
+    } else if (!_timer.armed()) {
+        _timer.arm(_window);
+    }
+}
+
+void view_update_coalescer::flush() {
+    _timer.cancel();
+    auto pending = std::exchange(_pending, {});
+    _pending_bytes = 0;
+    for (auto& [base_token, p] : pending) {
+        auto count = p.updates.size();
+        auto updates = coalesce(std::move(p.updates));
+        _stats.view_updates_coalesced += count - updates.size();
+        propagate(base_token, std::move(updates), std::move(*p.units));
+    }
+}
+
+void view_update_coalescer::propagate(const dht::token& base_token, std::vector<frozen_mutation_and_schema> updates, db::timeout_semaphore_units units) {
+    // Like the updates themselves, errors are handled in the background.
+    mutate_MV(base_token, std::move(updates), _stats, *_cf_stats, std::move(units)).handle_exception([] (auto ignored) { });
+}
+
+std::vector<frozen_mutation_and_schema> view_update_coalescer::coalesce(std::vector<frozen_mutation_and_schema> updates) {
+    if (updates.size() < 2) {
+        return updates;
+    }
+    // Mutations of different versions of the view schema are not merged.
+    struct view_partition {
+        const schema* s;
+        dht::decorated_key dk;
+    };
+    auto less = [] (const view_partition& a, const view_partition& b) {
+        if (a.s != b.s) {
+            return a.s < b.s;
+        }
+        return a.dk.less_compare(*a.s, b.dk);
+    };
+    std::map<view_partition, size_t, decltype(less)> positions(less);
+    std::vector<frozen_mutation_and_schema> result;
+    // Updates are unfrozen only if they have to be merged with another one.
+    std::vector<std::optional<mutation>> merged;
+
+    for (auto& update : updates) {
+        auto dk = dht::global_partitioner().decorate_key(*update.s, update.fm.key(*update.s));
+        auto [it, inserted] = positions.emplace(view_partition{update.s.get(), std::move(dk)}, result.size());
+        if (inserted) {
+            result.push_back(std::move(update));
+            merged.emplace_back();
+            continue;
+        }
+        auto& m = merged[it->second];
+        if (!m) {
+            auto& first = result[it->second];
+            m.emplace(first.fm.unfreeze(first.s));
+        }
+        m->apply(update.fm.unfreeze(update.s));
+    }
+
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (merged[i]) {
+            result[i].fm = freeze(*merged[i]);
+        }
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "db/view/view.hh"
+#include "db/timeout_clock.hh"
+#include "dht/i_partitioner.hh"
+#include "frozen_mutation.hh"
+
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+
+#include <map>
+#include <optional>
+
+struct cf_stats;
+
+namespace db::view {
+
+// Coalesces the view updates generated by writes to the same base partition which
+// arrive within a short window. Updates of the same view partition are merged, so
+// that they are sent to the paired view replica as a single mutation, rather than
+// one per base write.
+//
+// Base write latency isn't affected, since view updates are propagated in the
+// background anyway. With a zero window, updates are propagated right away.
+class view_update_coalescer {
+    struct pending_updates {
+        std::vector<frozen_mutation_and_schema> updates;
+        std::optional<db::timeout_semaphore_units> units;
+    };
+    stats& _stats;
+    ::cf_stats* _cf_stats;
+    std::chrono::milliseconds _window;
+    std::map<dht::token, pending_updates> _pending;
+    size_t _pending_bytes = 0;
+    timer<lowres_clock> _timer;
+public:
+    // Pending updates are flushed early once they hold that much data.
+    static constexpr size_t max_pending_bytes = 1 << 20;
+
+    view_update_coalescer(stats& stats, ::cf_stats* cf_stats, std::chrono::milliseconds window);
+
+    void add(const dht::token& base_token, std::vector<frozen_mutation_and_schema> updates, db::timeout_semaphore_units units);
+
+    // Propagates all pending updates.
+    void flush();
+
+    // Merges the updates of the same view partition.
+    static std::vector<frozen_mutation_and_schema> coalesce(std::vector<frozen_mutation_and_schema> updates);
+private:
+    void propagate(const dht::token& base_token, std::vector<frozen_mutation_and_schema> updates, db::timeout_semaphore_units units);
+};
+
+}
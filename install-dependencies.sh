@@ -24,6 +24,7 @@ bash seastar/install-dependencies.sh
 debian_base_packages=(
     python3-pyparsing
     libsnappy-dev
+    libzstd-dev
     libjsoncpp-dev
     scylla-libthrift010-dev
     scylla-antlr35-c++-dev
@@ -39,6 +40,7 @@ fedora_packages=(
     antlr3-C++-devel
     jsoncpp-devel
     snappy-devel
+    libzstd-devel
     systemd-devel
     git
     python
@@ -77,7 +79,7 @@ centos_packages=(
     thrift-devel
     scylla-antlr35-tool
     scylla-antlr35-C++-devel
-    jsoncpp-devel snappy-devel
+    jsoncpp-devel snappy-devel libzstd-devel
     scylla-boost163-static
     scylla-python34-pyparsing20
     systemd-devel
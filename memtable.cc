@@ -744,6 +744,26 @@ memtable::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_han
     update(std::move(h));
 }
 
+void
+memtable::apply(const std::vector<const frozen_mutation*>& ms, const schema_ptr& m_schema) {
+    with_allocator(allocator(), [this, &ms, &m_schema] {
+        // If the section is retried, the mutations applied by the failed
+        // attempt are applied again, which doesn't change the result.
+        _allocating_section(*this, [&, this] {
+          with_linearized_managed_bytes([&] {
+            for (auto m : ms) {
+                auto& p = find_or_create_partition_slow(m->key(*_schema));
+                mutation_partition mp(m_schema);
+                partition_builder pb(*m_schema, mp);
+                m->partition().accept(*m_schema, pb);
+                _stats_collector.update(*m_schema, mp);
+                p.apply(*_schema, std::move(mp), *m_schema);
+            }
+          });
+        });
+    });
+}
+
 logalloc::occupancy_stats memtable::occupancy() const {
     return logalloc::region::occupancy();
 }
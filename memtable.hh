@@ -197,6 +197,10 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
     void apply(const mutation& m, db::rp_handle&& = {});
     // The mutation is upgraded to current schema.
     void apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& = {});
+    // Applies mutations of the same schema, which have no commitlog position,
+    // in a single allocating section. Used by commitlog replay.
+    // The mutations are upgraded to current schema.
+    void apply(const std::vector<const frozen_mutation*>& ms, const schema_ptr& m_schema);
 
     static memtable& from_region(logalloc::region& r) {
         return static_cast<memtable&>(r);
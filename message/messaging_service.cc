@@ -430,12 +430,14 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::READ_DATA:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
+    case messaging_verb::READ_PARTIAL_AGGREGATES:
     case messaging_verb::GOSSIP_DIGEST_ACK:
     case messaging_verb::DEFINITIONS_UPDATE:
     case messaging_verb::TRUNCATE:
     case messaging_verb::MIGRATION_REQUEST:
     case messaging_verb::SCHEMA_CHECK:
     case messaging_verb::COUNTER_MUTATION:
+    case messaging_verb::VIEW_MUTATIONS:
         return 0;
     // GET_SCHEMA_VERSION is sent from read/mutate verbs so should be
     // sent on a different connection to avoid potential deadlocks
@@ -455,6 +457,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPLICATION_FINISHED:
     case messaging_verb::REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -468,6 +471,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
+    case messaging_verb::REPAIR_GET_RANGE_HASH:
         return 2;
     case messaging_verb::MUTATION_DONE:
     case messaging_verb::MUTATION_FAILED:
@@ -695,6 +699,27 @@ void messaging_service::register_stream_mutation_fragments(std::function<future<
     register_handler(this, messaging_verb::STREAM_MUTATION_FRAGMENTS, std::move(func));
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<sstring, uint64_t, bytes>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<rpc::sink<sstring, uint64_t, bytes>, rpc::source<int32_t>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, sstring version, dht::token first_token, streaming::stream_reason reason, msg_addr id) {
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    return rpc_client->make_stream_sink<netw::serializer, sstring, uint64_t, bytes>().then([this, plan_id, schema_id, cf_id, version = std::move(version), first_token = std::move(first_token), reason, rpc_client] (rpc::sink<sstring, uint64_t, bytes> sink) mutable {
+        auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (utils::UUID, utils::UUID, utils::UUID, sstring, dht::token, streaming::stream_reason, rpc::sink<sstring, uint64_t, bytes>)>(messaging_verb::STREAM_SSTABLE_FILES);
+        return rpc_handler(*rpc_client, plan_id, schema_id, cf_id, std::move(version), std::move(first_token), reason, sink).then_wrapped([sink, rpc_client] (future<rpc::source<int32_t>> source) mutable {
+            return (source.failed() ? sink.close() : make_ready_future<>()).then([sink = std::move(sink), source = std::move(source)] () mutable {
+                return make_ready_future<rpc::sink<sstring, uint64_t, bytes>, rpc::source<int32_t>>(std::move(sink), std::move(source.get0()));
+            });
+        });
+    });
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring version, dht::token first_token, streaming::stream_reason reason, rpc::source<sstring, uint64_t, bytes> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
 template<class SinkType, class SourceType>
 future<rpc::sink<SinkType>, rpc::source<SourceType>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
@@ -977,6 +1002,16 @@ future<> messaging_service::send_counter_mutation(msg_addr id, clock_type::time_
     return send_message_timeout<void>(this, messaging_verb::COUNTER_MUTATION, std::move(id), timeout, std::move(fms), cl, std::move(trace_info));
 }
 
+void messaging_service::register_view_mutations(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms)>&& func) {
+    register_handler(this, netw::messaging_verb::VIEW_MUTATIONS, std::move(func));
+}
+void messaging_service::unregister_view_mutations() {
+    _rpc->unregister_handler(netw::messaging_verb::VIEW_MUTATIONS);
+}
+future<db::view::update_backlog> messaging_service::send_view_mutations(msg_addr id, clock_type::time_point timeout, const std::vector<frozen_mutation>& fms) {
+    return send_message_timeout<db::view::update_backlog>(this, messaging_verb::VIEW_MUTATIONS, std::move(id), timeout, fms);
+}
+
 void messaging_service::register_mutation_done(std::function<future<rpc::no_wait_type> (const rpc::client_info& cinfo, unsigned shard, response_id_type response_id, rpc::optional<db::view::update_backlog> backlog)>&& func) {
     register_handler(this, netw::messaging_verb::MUTATION_DONE, std::move(func));
 }
@@ -1007,6 +1042,20 @@ future<query::result, rpc::optional<cache_temperature>> messaging_service::send_
     return send_message_timeout<future<query::result, rpc::optional<cache_temperature>>>(this, messaging_verb::READ_DATA, std::move(id), timeout, cmd, pr, da);
 }
 
+void messaging_service::register_read_partial_aggregates(std::function<future<std::vector<bytes_opt>> (const rpc::client_info&, rpc::opt_time_point timeout, query::read_command cmd,
+        dht::partition_range_vector ranges, db::consistency_level cl, std::vector<sstring> functions, std::vector<sstring> columns,
+        uint64_t page_timeout_ms)>&& func) {
+    register_handler(this, netw::messaging_verb::READ_PARTIAL_AGGREGATES, std::move(func));
+}
+void messaging_service::unregister_read_partial_aggregates() {
+    _rpc->unregister_handler(netw::messaging_verb::READ_PARTIAL_AGGREGATES);
+}
+future<std::vector<bytes_opt>> messaging_service::send_read_partial_aggregates(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd,
+        const dht::partition_range_vector& ranges, db::consistency_level cl, const std::vector<sstring>& functions, const std::vector<sstring>& columns,
+        uint64_t page_timeout_ms) {
+    return send_message_timeout<future<std::vector<bytes_opt>>>(this, messaging_verb::READ_PARTIAL_AGGREGATES, std::move(id), timeout, cmd, ranges, cl, functions, columns, page_timeout_ms);
+}
+
 void messaging_service::register_get_schema_version(std::function<future<frozen_schema>(unsigned, table_schema_version)>&& func) {
     register_handler(this, netw::messaging_verb::GET_SCHEMA_VERSION, std::move(func));
 }
@@ -1198,4 +1247,15 @@ future<std::vector<row_level_diff_detect_algorithm>> messaging_service::send_rep
     return send_message<future<std::vector<row_level_diff_detect_algorithm>>>(this, messaging_verb::REPAIR_GET_DIFF_ALGORITHMS, std::move(id));
 }
 
+// Wrapper for REPAIR_GET_RANGE_HASH
+void messaging_service::register_repair_get_range_hash(std::function<future<std::optional<repair_hash>> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_GET_RANGE_HASH, std::move(func));
+}
+void messaging_service::unregister_repair_get_range_hash() {
+    _rpc->unregister_handler(messaging_verb::REPAIR_GET_RANGE_HASH);
+}
+future<std::optional<repair_hash>> messaging_service::send_repair_get_range_hash(msg_addr id, uint32_t repair_meta_id) {
+    return send_message<future<std::optional<repair_hash>>>(this, messaging_verb::REPAIR_GET_RANGE_HASH, std::move(id), repair_meta_id);
+}
+
 } // namespace net
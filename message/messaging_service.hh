@@ -133,7 +133,11 @@ enum class messaging_verb : int32_t {
     REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM = 36,
     REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM = 37,
     REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM = 38,
-    LAST = 39,
+    REPAIR_GET_RANGE_HASH = 39,
+    STREAM_SSTABLE_FILES = 40,
+    READ_PARTIAL_AGGREGATES = 41,
+    VIEW_MUTATIONS = 42,
+    LAST = 43,
 };
 
 } // namespace netw
@@ -277,6 +281,14 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment>& source);
     future<rpc::sink<frozen_mutation_fragment>, rpc::source<int32_t>> make_sink_and_source_for_stream_mutation_fragments(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // Transfers the component files of a single sstable. Each element of the stream is the name of
+    // a component, its total size and the next chunk of its contents. Status codes are the same as
+    // for STREAM_MUTATION_FRAGMENTS.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring version, dht::token first_token, streaming::stream_reason reason, rpc::source<sstring, uint64_t, bytes> source)>&& func);
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<sstring, uint64_t, bytes>& source);
+    future<rpc::sink<sstring, uint64_t, bytes>, rpc::source<int32_t>> make_sink_and_source_for_stream_sstable_files(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, sstring version, dht::token first_token, streaming::stream_reason reason, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
@@ -353,6 +365,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     void unregister_repair_get_diff_algorithms();
     future<std::vector<row_level_diff_detect_algorithm>> send_repair_get_diff_algorithms(msg_addr id);
 
+    // Wrapper for REPAIR_GET_RANGE_HASH
+    void register_repair_get_range_hash(std::function<future<std::optional<repair_hash>> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func);
+    void unregister_repair_get_range_hash();
+    future<std::optional<repair_hash>> send_repair_get_range_hash(msg_addr id, uint32_t repair_meta_id);
+
     // Wrapper for GOSSIP_ECHO verb
     void register_gossip_echo(std::function<future<> ()>&& func);
     void unregister_gossip_echo();
@@ -402,6 +419,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     void unregister_counter_mutation();
     future<> send_counter_mutation(msg_addr id, clock_type::time_point timeout, std::vector<frozen_mutation> fms, db::consistency_level cl, std::optional<tracing::trace_info> trace_info = std::nullopt);
 
+    // Wrapper for VIEW_MUTATIONS
+    // Applies view updates of several view partitions, all paired with the sender, see db::view::mutate_MV().
+    // Returns the view update backlog of the receiver, like MUTATION_DONE does.
+    void register_view_mutations(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms)>&& func);
+    void unregister_view_mutations();
+    future<db::view::update_backlog> send_view_mutations(msg_addr id, clock_type::time_point timeout, const std::vector<frozen_mutation>& fms);
+
     // Wrapper for MUTATION_DONE
     void register_mutation_done(std::function<future<rpc::no_wait_type> (const rpc::client_info& cinfo, unsigned shard, response_id_type response_id, rpc::optional<db::view::update_backlog> backlog)>&& func);
     void unregister_mutation_done();
@@ -418,6 +442,16 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     void unregister_read_data();
     future<query::result, rpc::optional<cache_temperature>> send_read_data(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd, const dht::partition_range& pr, query::digest_algorithm da);
 
+    // Wrapper for READ_PARTIAL_AGGREGATES
+    // Computes aggregates of the read command over the ranges at the given consistency level, see service/parallel_aggregation.hh.
+    void register_read_partial_aggregates(std::function<future<std::vector<bytes_opt>> (const rpc::client_info&, rpc::opt_time_point timeout, query::read_command cmd,
+            dht::partition_range_vector ranges, db::consistency_level cl, std::vector<sstring> functions, std::vector<sstring> columns,
+            uint64_t page_timeout_ms)>&& func);
+    void unregister_read_partial_aggregates();
+    future<std::vector<bytes_opt>> send_read_partial_aggregates(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd,
+            const dht::partition_range_vector& ranges, db::consistency_level cl, const std::vector<sstring>& functions, const std::vector<sstring>& columns,
+            uint64_t page_timeout_ms);
+
     // Wrapper for GET_SCHEMA_VERSION
     void register_get_schema_version(std::function<future<frozen_schema>(unsigned, table_schema_version)>&& func);
     void unregister_get_schema_version();
@@ -175,9 +175,11 @@ class result_view {
         for (auto&& p : _v.partitions()) {
             auto rows = p.rows();
             auto row_count = rows.size();
+            // Visitors may refer to the partition key until accept_partition_end().
+            std::optional<partition_key> key;
             if (slice.options.contains<partition_slice::option::send_partition_key>()) {
-                auto key = *p.key();
-                visitor.accept_new_partition(key, row_count);
+                key = p.key();
+                visitor.accept_new_partition(*key, row_count);
             } else {
                 visitor.accept_new_partition(row_count);
             }
@@ -136,6 +136,8 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     //
     autoupdating_underlying_reader _underlying;
     uint64_t _underlying_created = 0;
+    // Bytes read from the underlying source for population.
+    uint64_t _populated_bytes = 0;
 
     mutation_source_opt _underlying_snapshot;
     dht::partition_range _sm_range;
@@ -186,6 +188,13 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     row_cache::phase_type phase() const { return _phase; }
     const dht::decorated_key& key() const { return *_key; }
     void on_underlying_created() { ++_underlying_created; }
+    void on_populated(size_t bytes) { _populated_bytes += bytes; }
+    // Returns true if this is a scan which populated enough data already
+    // and should leave the rest of the cache alone.
+    bool should_bypass_population() const {
+        auto limit = _cache._tracker.scan_population_limit();
+        return _range_query && limit && _populated_bytes > limit;
+    }
     bool digest_requested() const { return _slice.options.contains<query::partition_slice::option::with_digest>(); }
 private:
     future<> ensure_underlying(db::timeout_clock::time_point timeout) {
@@ -194,3 +194,17 @@ class tracking_file_impl : public file_impl {
 file reader_resource_tracker::track(file f) const {
     return file(make_shared<tracking_file_impl>(f, *this));
 }
+
+size_t reader_resource_tracker::read_ahead_budget() const {
+    if (!_permit) {
+        return std::numeric_limits<size_t>::max();
+    }
+    auto& semaphore = _permit->semaphore();
+    auto available = semaphore.available_resources();
+    if (available.memory <= 0) {
+        return 0;
+    }
+    // Waiting readers will need memory once admitted, so they get a share too.
+    auto readers = size_t(std::max(semaphore.initial_resources().count - available.count, 1)) + semaphore.waiters();
+    return available.memory / readers;
+}
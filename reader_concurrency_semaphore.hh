@@ -111,6 +111,10 @@ class reader_concurrency_semaphore {
         void signal_memory(size_t memory) {
             _semaphore.signal_memory(memory);
         }
+
+        const reader_concurrency_semaphore& semaphore() const {
+            return _semaphore;
+        }
     };
 
     class inactive_read {
@@ -160,6 +164,7 @@ class reader_concurrency_semaphore {
     };
 
 private:
+    const resources _initial_resources;
     resources _resources;
 
     expiring_fifo<entry, expiry_handler, db::timeout_clock> _wait_list;
@@ -199,7 +204,8 @@ class reader_concurrency_semaphore {
             ssize_t memory,
             size_t max_queue_length = std::numeric_limits<size_t>::max(),
             std::function<std::exception_ptr()> raise_queue_overloaded_exception = default_make_queue_overloaded_exception)
-        : _resources(count, memory)
+        : _initial_resources(count, memory)
+        , _resources(count, memory)
         , _max_queue_length(max_queue_length)
         , _make_queue_overloaded_exception(raise_queue_overloaded_exception) {
     }
@@ -259,6 +265,10 @@ class reader_concurrency_semaphore {
         return _resources;
     }
 
+    resources initial_resources() const {
+        return _initial_resources;
+    }
+
     size_t waiters() const {
         return _wait_list.size();
     }
@@ -278,6 +288,14 @@ class reader_resource_tracker {
 
     file track(file f) const;
 
+    /// The amount of memory the tracked reader may use for read-ahead
+    /// without taking it from other readers of the semaphore.
+    ///
+    /// This is an equal share of the memory currently available in the
+    /// semaphore among the admitted readers and those waiting for admission,
+    /// so it shrinks as the queue grows. Untracked readers are not limited.
+    size_t read_ahead_budget() const;
+
     lw_shared_ptr<reader_concurrency_semaphore::reader_permit> get_permit() const {
         return _permit;
     }
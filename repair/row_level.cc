@@ -33,6 +33,8 @@
 #include "service/storage_service.hh"
 #include "service/priority_manager.hh"
 #include "db/view/view_update_checks.hh"
+#include "db/config.hh"
+#include "db/system_keyspace.hh"
 #include "database.hh"
 #include <seastar/util/bool_class.hh>
 #include <seastar/core/metrics_registration.hh>
@@ -211,6 +213,85 @@ static uint64_t get_random_seed() {
     return random_dist(random_engine);
 }
 
+std::vector<int64_t> repair_range_sstables(const column_family& cf, const dht::token_range& range) {
+    auto sstables = cf.get_sstable_set().select(dht::to_partition_range(range));
+    auto generations = boost::copy_range<std::vector<int64_t>>(sstables | boost::adaptors::transformed([] (const sstables::shared_sstable& sst) {
+        return sst->generation();
+    }));
+    std::sort(generations.begin(), generations.end());
+    return generations;
+}
+
+// Returns true if the data of the range is the same as when it was read from
+// the given sstables: they are all still there, and neither the memtables nor
+// the sstables added since hold data of the range. Writes to other ranges,
+// and flushes and compactions of sstables which don't overlap the range, keep
+// it unchanged.
+static future<bool> range_unchanged_since(column_family& cf, const dht::token_range& range, const std::vector<int64_t>& sstables) {
+    auto pr = dht::to_partition_range(range);
+    std::vector<sstables::shared_sstable> added;
+    size_t kept = 0;
+    for (auto& sst : cf.get_sstable_set().select(pr)) {
+        if (std::binary_search(sstables.begin(), sstables.end(), sst->generation())) {
+            kept++;
+        } else {
+            added.push_back(sst);
+        }
+    }
+    if (kept != sstables.size()) {
+        // Compaction may have purged data of the range.
+        return make_ready_future<bool>(false);
+    }
+    return do_with(std::move(pr), std::move(added), [&cf] (const dht::partition_range& pr, std::vector<sstables::shared_sstable>& added) {
+        return cf.has_memtable_data(pr).then([&cf, &pr, &added] (bool has_memtable_data) {
+            if (has_memtable_data) {
+                return make_ready_future<bool>(false);
+            }
+            return map_reduce(added.begin(), added.end(), [&cf, &pr] (const sstables::shared_sstable& sst) {
+                auto s = cf.schema();
+                return do_with(sst->read_range_rows_flat(s, pr, s->full_slice(), service::get_local_streaming_read_priority()), [] (flat_mutation_reader& reader) {
+                    return reader(db::no_timeout).then([] (mutation_fragment_opt mf) {
+                        return bool(mf);
+                    });
+                });
+            }, false, std::logical_or<bool>()).then([] (bool has_sstable_data) {
+                return !has_sstable_data;
+            });
+        });
+    });
+}
+
+future<bool> remember_repair_range_hash(column_family& cf, dht::token_range range, std::vector<int64_t> sstables, repair_hash hash) {
+    return do_with(std::move(range), std::move(sstables), [&cf, hash] (const dht::token_range& range, const std::vector<int64_t>& sstables) {
+        return range_unchanged_since(cf, range, sstables).then([&cf, &range, hash] (bool unchanged) {
+            if (!unchanged) {
+                return make_ready_future<bool>(false);
+            }
+            // The sstables added since don't hold data of the range, remember
+            // them too so that they are not checked again.
+            auto entry = db::system_keyspace::repair_range_hash{repair_range_sstables(cf, range), hash.hash};
+            return db::system_keyspace::save_repair_range_hash(cf.schema()->id(), range, std::move(entry)).then([] {
+                return true;
+            });
+        });
+    });
+}
+
+future<std::optional<repair_hash>> get_remembered_repair_range_hash(column_family& cf, dht::token_range range) {
+    return do_with(std::move(range), [&cf] (const dht::token_range& range) {
+        return db::system_keyspace::get_repair_range_hash(cf.schema()->id(), range).then([&cf, &range] (std::optional<db::system_keyspace::repair_range_hash> entry) {
+            if (!entry) {
+                return make_ready_future<std::optional<repair_hash>>();
+            }
+            return do_with(std::move(*entry), [&cf, &range] (const db::system_keyspace::repair_range_hash& entry) {
+                return range_unchanged_since(cf, range, entry.sstables).then([&entry] (bool unchanged) {
+                    return unchanged ? std::optional<repair_hash>(repair_hash(entry.hash)) : std::nullopt;
+                });
+            });
+        });
+    });
+}
+
 class decorated_key_with_hash {
 public:
     dht::decorated_key dk;
@@ -602,6 +683,15 @@ class repair_meta {
     sink_source_for_get_full_row_hashes _sink_source_for_get_full_row_hashes;
     sink_source_for_get_row_diff _sink_source_for_get_row_diff;
     sink_source_for_put_row_diff _sink_source_for_put_row_diff;
+    // Combines the hashes of all the rows read from disk
+    repair_hash _range_hash;
+    // Set once the reader has read all the rows of the range
+    bool _range_read = false;
+    // Set if this node received rows from the peers
+    bool _rows_received = false;
+    // The sstables the range was read from, if the range hash may be
+    // remembered, see remember_repair_range_hash()
+    std::optional<std::vector<int64_t>> _range_sstables;
 public:
     repair_stats& stats() {
         return _stats;
@@ -678,18 +768,54 @@ class repair_meta {
                         return netw::get_local_messaging_service().make_sink_and_source_for_repair_put_row_diff_with_rpc_stream(repair_meta_id, addr);
                 })
             {
+        if (_seed == repair_range_hash_seed && uses_local_reader()) {
+            _range_sstables = repair_range_sstables(_cf, _range);
+        }
     }
 
 public:
     future<> stop() {
+        auto remember_future = maybe_remember_range_hash();
         auto gate_future = _gate.close();
         auto writer_future = _repair_writer.wait_for_writer_done();
         auto f1 = _sink_source_for_get_full_row_hashes.close();
         auto f2 = _sink_source_for_get_row_diff.close();
         auto f3 = _sink_source_for_put_row_diff.close();
-        return when_all_succeed(std::move(gate_future), std::move(writer_future), std::move(f1), std::move(f2), std::move(f3));
+        return when_all_succeed(std::move(remember_future), std::move(gate_future), std::move(writer_future), std::move(f1), std::move(f2), std::move(f3));
+    }
+
+private:
+    bool uses_local_reader() const {
+        return _repair_master || _same_sharding_config;
     }
 
+    // If all the rows of the range were read, and this node didn't change
+    // the range, the combined hash of the rows can be remembered. A failure
+    // to do so doesn't fail the repair.
+    future<> maybe_remember_range_hash() {
+        if (!_range_sstables || !_range_read || _rows_received) {
+            return make_ready_future<>();
+        }
+        return remember_repair_range_hash(_cf, _range, std::move(*_range_sstables), _range_hash).then([this] (bool remembered) {
+            if (remembered) {
+                rlogger.debug("Remembered hash {} of range {} of {}.{}", _range_hash, _range, _schema->ks_name(), _schema->cf_name());
+            }
+        }).handle_exception([this] (std::exception_ptr ep) {
+            rlogger.warn("Failed to remember hash of range {} of {}.{}: {}", _range, _schema->ks_name(), _schema->cf_name(), ep);
+        });
+    }
+
+    future<std::optional<repair_hash>> get_range_hash() {
+        return with_gate(_gate, [this] {
+            if (_seed != repair_range_hash_seed || !uses_local_reader()) {
+                return make_ready_future<std::optional<repair_hash>>();
+            }
+            return get_remembered_repair_range_hash(_cf, _range);
+        });
+    }
+
+public:
+
     static std::unordered_map<node_repair_meta_id, lw_shared_ptr<repair_meta>>& repair_meta_map() {
         static thread_local std::unordered_map<node_repair_meta_id, lw_shared_ptr<repair_meta>> _repair_metas;
         return _repair_metas;
@@ -947,6 +1073,7 @@ class repair_meta {
 
     stop_iteration handle_mutation_fragment(mutation_fragment_opt mfopt, size_t& cur_size, std::list<repair_row>& cur_rows) {
         if (!mfopt) {
+            _range_read = true;
             return stop_iteration::yes;
         }
         mutation_fragment& mf = *mfopt;
@@ -964,6 +1091,7 @@ class repair_meta {
         auto hash = do_hash_for_mf(*_repair_reader.get_current_dk(), mf);
         repair_row r(freeze(*_schema, mf), position_in_partition(mf.position()), _repair_reader.get_current_dk(), hash);
         rlogger.trace("Reading: r.boundary={}, r.hash={}", r.boundary(), r.hash());
+        _range_hash.add(hash);
         _metrics.row_from_disk_nr++;
         _metrics.row_from_disk_bytes += r.size();
         cur_size += r.size();
@@ -1100,6 +1228,7 @@ class repair_meta {
         if (rows.empty()) {
             return make_ready_future<>();
         }
+        _rows_received = true;
         return to_repair_rows_list(rows).then([this, from, node_idx, update_buf, update_hash_set] (std::list<repair_row> row_diff) {
             return do_with(std::move(row_diff), [this, from, node_idx, update_buf, update_hash_set] (std::list<repair_row>& row_diff) {
                 if (_repair_master) {
@@ -1378,6 +1507,22 @@ class repair_meta {
         return rm->get_estimated_partitions();
     }
 
+    // RPC API
+    // Return the remembered combined hash of the whole range, if it is still valid
+    future<std::optional<repair_hash>> repair_get_range_hash(gms::inet_address remote_node) {
+        if (remote_node == _myip) {
+            return get_range_hash();
+        }
+        stats().rpc_call_nr++;
+        return netw::get_local_messaging_service().send_repair_get_range_hash(msg_addr(remote_node), _repair_meta_id);
+    }
+
+    // RPC handler
+    static future<std::optional<repair_hash>> repair_get_range_hash_handler(gms::inet_address from, uint32_t repair_meta_id) {
+        auto rm = get_repair_meta(from, repair_meta_id);
+        return rm->get_range_hash();
+    }
+
     // RPC API
     future<> repair_set_estimated_partitions(gms::inet_address remote_node, uint64_t estimated_partitions) {
         if (remote_node == _myip) {
@@ -2028,6 +2173,13 @@ future<> repair_init_messaging_service_handler(repair_service& rs, distributed<d
         ms.register_repair_get_diff_algorithms([] (const rpc::client_info& cinfo) {
             return make_ready_future<std::vector<row_level_diff_detect_algorithm>>(suportted_diff_detect_algorithms());
         });
+        ms.register_repair_get_range_hash([] (const rpc::client_info& cinfo, uint32_t repair_meta_id) {
+            auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+            auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+            return smp::submit_to(src_cpu_id % smp::count, [from, repair_meta_id] () mutable {
+                return repair_meta::repair_get_range_hash_handler(from, repair_meta_id);
+            });
+        });
     });
 }
 
@@ -2075,9 +2227,14 @@ class row_level_repair {
     // A flag indicates any error during the repair
     bool _failed = false;
 
+    // If set, compare the remembered hashes of the whole range first, and
+    // skip the range if they are all the same.
+    bool _use_range_hashes;
+
     // Seed for the repair row hashing. If we ever had a hash conflict for a row
     // and we are not using stable hash, there is chance we will fix the row in
-    // the next repair.
+    // the next repair. Range hashes can only be compared if they were computed
+    // with the same seed, so a fixed one is used with them.
     uint64_t _seed;
 
 public:
@@ -2091,7 +2248,9 @@ class row_level_repair {
         , _all_live_peer_nodes(std::move(all_live_peer_nodes))
         , _cf(_ri.db.local().find_column_family(_ri.keyspace, _cf_name))
         , _all_nodes(_all_live_peer_nodes)
-        , _seed(get_random_seed()) {
+        , _use_range_hashes(_ri.db.local().get_config().enable_repair_range_hashes()
+                && service::get_local_storage_service().cluster_supports_repair_range_hash())
+        , _seed(_use_range_hashes ? repair_range_hash_seed : get_random_seed()) {
     }
 
 private:
@@ -2106,6 +2265,20 @@ class row_level_repair {
         return is_rpc_stream_supported(algo) ?  32 * 1024 * 1024 : 256 * 1024;
     }
 
+    // Returns true if all the nodes remember the same hash of the whole range,
+    // so that there's no need to read it.
+    bool same_range_hashes(repair_meta& master) {
+        std::vector<std::optional<repair_hash>> range_hashes(_all_nodes.size());
+        parallel_for_each(boost::irange(size_t(0), _all_nodes.size()), [&, this] (size_t idx) {
+            return master.repair_get_range_hash(_all_nodes[idx]).then([&, this, idx] (std::optional<repair_hash> hash) {
+                rlogger.debug("Called master.repair_get_range_hash for node {}, got range_hash={}", _all_nodes[idx], hash);
+                range_hashes[idx] = hash;
+            });
+        }).get();
+        return range_hashes.front() && std::adjacent_find(range_hashes.begin(), range_hashes.end(),
+                std::not_equal_to<std::optional<repair_hash>>()) == range_hashes.end();
+    }
+
     // Step A: Negotiate sync boundary to use
     op_status negotiate_sync_boundary(repair_meta& master) {
         check_in_shutdown();
@@ -2348,18 +2521,25 @@ class row_level_repair {
                     return master.repair_set_estimated_partitions(node, _estimated_partitions);
                 }).get();
 
-                while (true) {
-                    auto status = negotiate_sync_boundary(master);
-                    if (status == op_status::next_round) {
-                        continue;
-                    } else if (status == op_status::all_done) {
-                        break;
-                    }
-                    status = get_missing_rows_from_follower_nodes(master);
-                    if (status == op_status::next_round) {
-                        continue;
+                if (_use_range_hashes && same_range_hashes(master)) {
+                    // All the nodes read the same rows in the range during an
+                    // earlier repair, and none of them changed it since.
+                    master.stats().range_nr_fast_path_same_range_hash++;
+                    rlogger.debug("Skip range={}, all nodes have the same range hash", _range);
+                } else {
+                    while (true) {
+                        auto status = negotiate_sync_boundary(master);
+                        if (status == op_status::next_round) {
+                            continue;
+                        } else if (status == op_status::all_done) {
+                            break;
+                        }
+                        status = get_missing_rows_from_follower_nodes(master);
+                        if (status == op_status::next_round) {
+                            continue;
+                        }
+                        send_missing_rows_to_follower_nodes(master);
                     }
-                    send_missing_rows_to_follower_nodes(master);
                 }
             } catch (std::exception& e) {
                 rlogger.info("Got error in row level repair: {}", e);
@@ -24,6 +24,7 @@
 #include <vector>
 #include "gms/inet_address.hh"
 #include "db/system_distributed_keyspace.hh"
+#include "repair/repair.hh"
 #include <seastar/core/distributed.hh>
 
 class row_level_repair_gossip_helper;
@@ -49,3 +50,23 @@ future<> repair_cf_range_row_level(repair_info& ri,
         const std::vector<gms::inet_address>& all_peer_nodes);
 
 future<> shutdown_all_row_level_repair();
+
+// Row level repair remembers the combined hash of the rows of every range it
+// reads completely, in system.repair_range_hashes. A later repair which finds
+// the same hash on all the replicas skips reading the range. Only hashes
+// computed with repair_range_hash_seed are remembered, so that the hashes of
+// different replicas can be compared.
+constexpr uint64_t repair_range_hash_seed = 0;
+
+// Returns the sorted generations of the sstables of cf on this shard which
+// overlap the range.
+std::vector<int64_t> repair_range_sstables(const column_family& cf, const dht::token_range& range);
+
+// Remembers the combined hash of the rows of the range, which were read from
+// the given sstables, if the data of the range didn't change since. Returns
+// true if the hash was remembered.
+future<bool> remember_repair_range_hash(column_family& cf, dht::token_range range, std::vector<int64_t> sstables, repair_hash hash);
+
+// Returns the remembered combined hash of the rows of the range, if the data
+// of the range didn't change since it was remembered.
+future<std::optional<repair_hash>> get_remembered_repair_range_hash(column_family& cf, dht::token_range range);
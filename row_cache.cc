@@ -124,6 +124,9 @@ cache_tracker::setup_metrics() {
         sm::make_derive("sstable_reader_recreations", sm::description("number of times sstable reader was recreated due to memtable flush"), _stats.underlying_recreations),
         sm::make_derive("sstable_partition_skips", sm::description("number of times sstable reader was fast forwarded across partitions"), _stats.underlying_partition_skips),
         sm::make_derive("sstable_row_skips", sm::description("number of times sstable reader was fast forwarded within a partition"), _stats.underlying_row_skips),
+        sm::make_derive("population_admissions", sm::description("number of partitions missing in cache which the admission policy allowed to be populated"), _stats.population_admissions),
+        sm::make_derive("population_rejections", sm::description("number of partitions missing in cache which the admission policy didn't allow to be populated"), _stats.population_rejections),
+        sm::make_derive("scan_population_bypasses", sm::description("number of partitions missing in cache which were not populated because the scan reading them populated too much data already"), _stats.scan_population_bypasses),
         sm::make_derive("pinned_dirty_memory_overload", sm::description("amount of pinned bytes that we tried to unpin over the limit. This should sit constantly at 0, and any number different than 0 is indicative of a bug"), _stats.pinned_dirty_memory_overload),
         sm::make_derive("rows_processed_from_memtable", _stats.rows_processed_from_memtable,
             sm::description("total number of rows in memtables which were processed during cache update on memtable flush")),
@@ -146,6 +149,9 @@ void cache_tracker::clear() {
             _lru.back().on_evicted(*this);
         }
     });
+    if (_admission_policy) {
+        _admission_policy->clear();
+    }
     _stats.partition_removals += partitions_before;
     _stats.row_removals += rows_before;
     allocator().invalidate_references();
@@ -188,9 +194,46 @@ void cache_tracker::on_partition_miss() {
     ++_stats.partition_misses;
 }
 
-void cache_tracker::on_partition_eviction() {
+void cache_tracker::on_partition_eviction(const dht::decorated_key& key) noexcept {
     --_stats.partitions;
     ++_stats.partition_evictions;
+    if (_admission_policy) {
+        _admission_policy->on_eviction(std::hash<dht::token>()(key.token()));
+    }
+}
+
+void cache_tracker::on_partition_access(const dht::token& token) noexcept {
+    if (_admission_policy) {
+        _admission_policy->on_access(std::hash<dht::token>()(token));
+    }
+}
+
+bool cache_tracker::admit(const dht::token& token) noexcept {
+    if (!_admission_policy) {
+        return true;
+    }
+    auto hash = std::hash<dht::token>()(token);
+    _admission_policy->on_access(hash);
+    if (_admission_policy->admit(hash)) {
+        ++_stats.population_admissions;
+        return true;
+    }
+    ++_stats.population_rejections;
+    return false;
+}
+
+void cache_tracker::set_admission_policy(std::unique_ptr<cache_admission_policy> policy) {
+    _admission_policy = std::move(policy);
+}
+
+std::unique_ptr<cache_admission_policy> make_cache_admission_policy(const sstring& name) {
+    if (name == "lru") {
+        return nullptr;
+    }
+    if (name == "tinylfu") {
+        return std::make_unique<tinylfu_admission_policy>();
+    }
+    throw std::invalid_argument(format("Unknown cache admission policy: {}", name));
 }
 
 void cache_tracker::on_row_eviction() {
@@ -210,6 +253,10 @@ void cache_tracker::on_mispopulate() {
     ++_stats.mispopulations;
 }
 
+void cache_tracker::on_scan_population_bypass() {
+    ++_stats.scan_population_bypasses;
+}
+
 void cache_tracker::on_miss_already_populated() {
     ++_stats.concurrent_misses_same_key;
 }
@@ -367,7 +414,14 @@ class single_partition_populating_reader final : public flat_mutation_reader::im
         _read_context->enter_partition(_read_context->range().start()->value().as_decorated_key(), src_and_phase.snapshot, phase);
         return _read_context->create_underlying(false, timeout).then([this, phase, timeout] {
           return _read_context->underlying().underlying()(timeout).then([this, phase] (auto&& mfopt) {
-            if (!mfopt) {
+            if (!_cache._tracker.admit(_read_context->range().start()->value().token())) {
+                if (mfopt) {
+                    _reader = read_directly_from_underlying(*_read_context);
+                    this->push_mutation_fragment(std::move(*mfopt));
+                } else {
+                    _end_of_stream = true;
+                }
+            } else if (!mfopt) {
                 if (phase == _cache.phase_of(_read_context->range().start()->value())) {
                     _cache._read_section(_cache._tracker.region(), [this] {
                         with_allocator(_cache._tracker.allocator(), [this] {
@@ -452,8 +506,9 @@ void cache_tracker::clear_continuity(cache_entry& ce) {
     ce.set_continuous(false);
 }
 
-void row_cache::on_partition_hit() {
+void row_cache::on_partition_hit(const dht::decorated_key& key) {
     _tracker.on_partition_hit();
+    _tracker.on_partition_access(key.token());
 }
 
 void row_cache::on_partition_miss() {
@@ -531,7 +586,16 @@ class range_populating_reader {
                 _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
-                if (_reader.creation_phase() == _cache.phase_of(key)) {
+                if (_read_context.should_bypass_population()) {
+                    _cache._tracker.on_scan_population_bypass();
+                    _last_key = row_cache::previous_entry_pointer(key);
+                    return make_ready_future<flat_mutation_reader_opt, mutation_fragment_opt>(
+                        read_directly_from_underlying(_read_context), std::move(mfopt));
+                } else if (!_cache._tracker.admit(key.token())) {
+                    _last_key = row_cache::previous_entry_pointer(key);
+                    return make_ready_future<flat_mutation_reader_opt, mutation_fragment_opt>(
+                        read_directly_from_underlying(_read_context), std::move(mfopt));
+                } else if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create(key,
                                                                ps.partition_tombstone(),
@@ -579,7 +643,7 @@ class scanning_and_populating_reader final : public flat_mutation_reader::impl {
 private:
     flat_mutation_reader read_from_entry(cache_entry& ce) {
         _cache.upgrade_entry(ce);
-        _cache.on_partition_hit();
+        _cache.on_partition_hit(ce.key());
         return ce.read(_cache, *_read_context);
     }
 
@@ -749,7 +813,7 @@ row_cache::make_reader(schema_ptr s,
                 if (i != _partitions.end() && !cmp(pos, i->position())) {
                     cache_entry& e = *i;
                     upgrade_entry(e);
-                    on_partition_hit();
+                    on_partition_hit(e.key());
                     return e.read(*this, *ctx);
                 } else if (i->continuous()) {
                     return make_empty_flat_reader(std::move(s));
@@ -1224,8 +1288,8 @@ void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
     auto it = row_cache::partitions_type::s_iterator_to(*this);
     std::next(it)->set_continuous(false);
     evict(tracker);
+    tracker.on_partition_eviction(_key);
     current_deleter<cache_entry>()(this);
-    tracker.on_partition_eviction();
 }
 
 void rows_entry::on_evicted(cache_tracker& tracker) noexcept {
@@ -37,6 +37,7 @@
 #include "partition_version.hh"
 #include "utils/estimated_histogram.hh"
 #include "tracing/trace_state.hh"
+#include "cache_admission_policy.hh"
 #include <seastar/core/metrics_registration.hh>
 #include "flat_mutation_reader.hh"
 #include "mutation_cleaner.hh"
@@ -222,6 +223,9 @@ class cache_tracker final {
         uint64_t reads_with_misses;
         uint64_t reads_done;
         uint64_t pinned_dirty_memory_overload;
+        uint64_t population_admissions;
+        uint64_t population_rejections;
+        uint64_t scan_population_bypasses;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -234,6 +238,8 @@ class cache_tracker final {
     lru_type _lru;
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
+    std::unique_ptr<cache_admission_policy> _admission_policy;
+    uint64_t _scan_population_limit = 0;
 private:
     void setup_metrics();
 public:
@@ -252,12 +258,18 @@ class cache_tracker final {
     void on_partition_merge();
     void on_partition_hit();
     void on_partition_miss();
-    void on_partition_eviction();
+    void on_partition_eviction(const dht::decorated_key&) noexcept;
+    // Records an access to the partition with the admission policy.
+    void on_partition_access(const dht::token&) noexcept;
+    // Decides whether a partition which missed in cache may be populated.
+    // Also records the access.
+    bool admit(const dht::token&) noexcept;
     void on_row_eviction();
     void on_row_hit();
     void on_row_miss();
     void on_miss_already_populated();
     void on_mispopulate();
+    void on_scan_population_bypass();
     void on_row_processed_from_memtable() { ++_stats.rows_processed_from_memtable; }
     void on_row_dropped_from_memtable() { ++_stats.rows_dropped_from_memtable; }
     void on_row_merged_from_memtable() { ++_stats.rows_merged_from_memtable; }
@@ -270,6 +282,13 @@ class cache_tracker final {
     uint64_t partitions() const { return _stats.partitions; }
     const stats& get_stats() const { return _stats; }
     void set_compaction_scheduling_group(seastar::scheduling_group);
+    // Replaces the admission policy. nullptr admits everything.
+    void set_admission_policy(std::unique_ptr<cache_admission_policy>);
+    // A range scan which populated more than the given amount of bytes stops
+    // populating partitions missing in cache and reads them directly from
+    // the underlying source. 0 means no limit.
+    void set_scan_population_limit(uint64_t bytes) { _scan_population_limit = bytes; }
+    uint64_t scan_population_limit() const { return _scan_population_limit; }
 };
 
 inline
@@ -389,7 +408,7 @@ class row_cache final {
     logalloc::allocating_section _read_section;
     flat_mutation_reader create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader make_scanning_reader(const dht::partition_range&, lw_shared_ptr<cache::read_context>);
-    void on_partition_hit();
+    void on_partition_hit(const dht::decorated_key&);
     void on_partition_miss();
     void on_row_hit();
     void on_row_miss();
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/range/irange.hpp>
+#include <seastar/core/do_with.hh>
+#include <seastar/core/future-util.hh>
+
+#include "service/parallel_aggregation.hh"
+#include "service/storage_proxy.hh"
+#include "service/query_state.hh"
+#include "service/client_state.hh"
+#include "service/pager/query_pagers.hh"
+#include "cql3/selection/selection.hh"
+#include "cql3/selection/raw_selector.hh"
+#include "cql3/selection/selectable.hh"
+#include "cql3/column_identifier.hh"
+#include "cql3/functions/functions.hh"
+#include "cql3/functions/aggregate_fcts.hh"
+#include "cql3/query_options.hh"
+#include "cql3/statements/select_statement.hh"
+#include "message/messaging_service.hh"
+#include "schema_registry.hh"
+#include "database.hh"
+#include "sstables/sstables.hh"
+#include "utils/fb_utilities.hh"
+#include "timeout_config.hh"
+
+namespace service {
+
+static bool is_count(const sstring& function) {
+    return function == cql3::functions::aggregate_fcts::COUNT_ROWS_FUNCTION_NAME || function == "count";
+}
+
+std::optional<partial_aggregates> get_partial_aggregates(const std::vector<::shared_ptr<cql3::selection::raw_selector>>& select_clause, schema_ptr s) {
+    if (select_clause.empty()) {
+        return std::nullopt;
+    }
+    partial_aggregates aggregates;
+    for (auto&& selectable : cql3::selection::raw_selector::to_selectables(select_clause, s)) {
+        auto fn = dynamic_pointer_cast<cql3::selection::selectable::with_function>(selectable);
+        if (!fn) {
+            return std::nullopt;
+        }
+        // Unqualified names are resolved to native functions first.
+        auto& name = fn->function_name();
+        if (!name.keyspace.empty() && name.keyspace != db::system_keyspace_name()) {
+            return std::nullopt;
+        }
+        if (name.name == cql3::functions::aggregate_fcts::COUNT_ROWS_FUNCTION_NAME && fn->args().empty()) {
+            aggregates.functions.push_back(name.name);
+            aggregates.columns.push_back(sstring());
+            continue;
+        }
+        if ((name.name != "count" && name.name != "sum" && name.name != "min" && name.name != "max") || fn->args().size() != 1) {
+            return std::nullopt;
+        }
+        auto column = dynamic_pointer_cast<cql3::column_identifier>(fn->args().front());
+        if (!column) {
+            return std::nullopt;
+        }
+        // Aggregates of counters are left to the regular read path.
+        auto def = s->get_column_definition(column->name());
+        if (!def || (def->is_counter() && !is_count(name.name))) {
+            return std::nullopt;
+        }
+        aggregates.functions.push_back(name.name);
+        aggregates.columns.push_back(column->text());
+    }
+    return aggregates;
+}
+
+static ::shared_ptr<cql3::selection::selection> make_selection(database& db, schema_ptr s, const partial_aggregates& aggregates) {
+    std::vector<::shared_ptr<cql3::selection::raw_selector>> raw_selectors;
+    raw_selectors.reserve(aggregates.functions.size());
+    for (size_t i = 0; i < aggregates.functions.size(); ++i) {
+        ::shared_ptr<cql3::selection::selectable::raw> selectable;
+        if (aggregates.columns[i].empty()) {
+            selectable = cql3::selection::selectable::with_function::raw::make_count_rows_function();
+        } else {
+            selectable = ::make_shared<cql3::selection::selectable::with_function::raw>(
+                    cql3::functions::function_name::native_function(aggregates.functions[i]),
+                    std::vector<::shared_ptr<cql3::selection::selectable::raw>>{::make_shared<cql3::column_identifier::raw>(aggregates.columns[i], true)});
+        }
+        raw_selectors.push_back(::make_shared<cql3::selection::raw_selector>(std::move(selectable), nullptr));
+    }
+    return cql3::selection::selection::from_selectors(db, std::move(s), raw_selectors);
+}
+
+// Merges partial results of the selection. Empty partial results, of
+// nodes or shards which had nothing to read, are skipped.
+static std::vector<bytes_opt> merge_partial_aggregates(const partial_aggregates& aggregates, const cql3::selection::selection& selection,
+        const std::vector<std::vector<bytes_opt>>& partials) {
+    auto sf = cql_serialization_format::internal();
+    auto& names = selection.get_result_metadata()->get_names();
+    std::vector<bytes_opt> ret;
+    ret.reserve(aggregates.functions.size());
+    for (size_t i = 0; i < aggregates.functions.size(); ++i) {
+        auto& function = aggregates.functions[i];
+        auto reducer = cql3::functions::function_name::native_function(is_count(function) ? "sum" : function);
+        auto fn = dynamic_pointer_cast<cql3::functions::aggregate_function>(cql3::functions::functions::find(reducer, {names[i]->type}));
+        if (!fn) {
+            throw std::runtime_error(format("Cannot merge partial results of {}({})", function, aggregates.columns[i]));
+        }
+        auto aggregate = fn->new_aggregate();
+        for (auto& partial : partials) {
+            if (!partial.empty()) {
+                aggregate->add_input(sf, {partial[i]});
+            }
+        }
+        ret.push_back(aggregate->compute(sf));
+    }
+    return ret;
+}
+
+static future<std::vector<bytes_opt>> query_partial_aggregates_on_this_shard(schema_ptr s, const partial_aggregates& aggregates,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector ranges, db::consistency_level cl,
+        db::timeout_clock::duration page_timeout) {
+    struct context {
+        query_state state{client_state::for_internal_calls()};
+        cql3::query_options options;
+        cql3::cql_stats stats;
+        ::shared_ptr<cql3::selection::selection> selection;
+        context(db::consistency_level cl, ::shared_ptr<cql3::selection::selection> selection)
+            : options(cl, infinite_timeout_config, std::vector<cql3::raw_value>{})
+            , selection(std::move(selection)) {
+        }
+    };
+    auto ctx = make_lw_shared<context>(cl, make_selection(get_local_storage_proxy().get_db().local(), s, aggregates));
+    auto p = pager::query_pagers::pager(s, ctx->selection, ctx->state, ctx->options, cmd, std::move(ranges), ctx->stats);
+    auto now = cmd->timestamp;
+    return do_with(cql3::selection::result_set_builder(*ctx->selection, now, cql_serialization_format::internal()),
+            [ctx, p, now, page_timeout] (cql3::selection::result_set_builder& builder) {
+        return do_until([p] { return p->is_exhausted(); }, [p, &builder, now, page_timeout] {
+            auto timeout = db::timeout_clock::now() + page_timeout;
+            return p->fetch_page(builder, cql3::statements::select_statement::DEFAULT_COUNT_PAGE_SIZE, now, timeout);
+        }).then([ctx, &builder] {
+            auto rs = builder.build();
+            return rs->rows().empty() ? std::vector<bytes_opt>() : rs->rows().front();
+        });
+    });
+}
+
+future<std::vector<bytes_opt>> query_partial_aggregates_on_this_node(schema_ptr s, partial_aggregates aggregates,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector ranges, db::consistency_level cl,
+        db::timeout_clock::duration page_timeout) {
+    std::vector<dht::partition_range_vector> ranges_per_shard(smp::count);
+    for (auto& range : ranges) {
+        dht::ring_position_range_sharder sharder(std::move(range));
+        while (auto r = sharder.next(*s)) {
+            ranges_per_shard[r->shard].push_back(std::move(r->ring_range));
+        }
+    }
+    return do_with(std::move(ranges_per_shard), std::move(aggregates), global_schema_ptr(s), std::vector<std::vector<bytes_opt>>(smp::count),
+            [s, cmd, cl, page_timeout] (std::vector<dht::partition_range_vector>& ranges_per_shard, const partial_aggregates& aggregates,
+                    global_schema_ptr& gs, std::vector<std::vector<bytes_opt>>& partials) {
+        return parallel_for_each(boost::irange(0u, smp::count), [&, cmd, cl, page_timeout] (unsigned shard) {
+            if (ranges_per_shard[shard].empty()) {
+                return make_ready_future<>();
+            }
+            return smp::submit_to(shard, [&, cmd = *cmd, ranges = std::move(ranges_per_shard[shard]), cl, page_timeout] () mutable {
+                get_local_storage_proxy()._stats.replica_partial_aggregate_reads++;
+                return query_partial_aggregates_on_this_shard(gs, aggregates, make_lw_shared<query::read_command>(std::move(cmd)), std::move(ranges), cl, page_timeout);
+            }).then([&partials, shard] (std::vector<bytes_opt> partial) {
+                partials[shard] = std::move(partial);
+            });
+        }).then([s, &aggregates, &partials] {
+            auto selection = make_selection(get_local_storage_proxy().get_db().local(), s, aggregates);
+            return merge_partial_aggregates(aggregates, *selection, partials);
+        });
+    });
+}
+
+// Estimates the number of pages a replica shard reads for the ranges from the
+// sstables of this shard, which hold about the same share of the data.
+static uint64_t estimate_pages(column_family& cf, const dht::partition_range_vector& ranges) {
+    uint64_t rows = 0;
+    auto sstables = cf.get_sstables();
+    for (auto& range : ranges) {
+        auto token_range = range.transform(std::mem_fn(&dht::ring_position::token));
+        for (auto& sst : *sstables) {
+            auto keys = sst->estimated_keys_for_range(token_range);
+            // The row count is only recorded by the mc format.
+            auto rows_count = uint64_t(std::max<int64_t>(sst->get_stats_metadata().rows_count, 0));
+            auto total_keys = sst->get_estimated_key_count();
+            rows += total_keys ? keys * std::max<uint64_t>(1, rows_count / total_keys) : keys;
+        }
+    }
+    return rows / cql3::statements::select_statement::DEFAULT_COUNT_PAGE_SIZE + 1;
+}
+
+static db::timeout_clock::time_point scan_timeout(db::timeout_clock::duration page_timeout, uint64_t pages) {
+    auto now = db::timeout_clock::now();
+    if (page_timeout.count() <= 0 || uint64_t((db::no_timeout - now) / page_timeout) <= pages) {
+        return db::no_timeout;
+    }
+    return now + page_timeout * int64_t(pages);
+}
+
+future<std::vector<bytes_opt>> query_partial_aggregates(storage_proxy& proxy, schema_ptr s, const partial_aggregates& aggregates,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector ranges, db::consistency_level cl,
+        db::timeout_clock::duration page_timeout, tracing::trace_state_ptr trace_state) {
+    auto& cf = proxy.get_db().local().find_column_family(s);
+    auto& ks = proxy.get_db().local().find_keyspace(s->ks_name());
+    std::unordered_map<gms::inet_address, dht::partition_range_vector> ranges_per_endpoint;
+    query_ranges_to_vnodes_generator ranges_to_vnodes(s, std::move(ranges));
+    while (!ranges_to_vnodes.empty()) {
+        for (auto& vnode : ranges_to_vnodes(1024)) {
+            auto token = vnode.end() ? vnode.end()->value().token() : dht::maximum_token();
+            auto endpoints = proxy.get_live_sorted_endpoints(ks, token);
+            // Without live replicas, the read done by this node will fail
+            // the same way a regular read does.
+            auto endpoint = endpoints.empty() ? utils::fb_utilities::get_broadcast_address() : endpoints.front();
+            ranges_per_endpoint[endpoint].push_back(std::move(vnode));
+        }
+    }
+    tracing::trace(trace_state, "Computing partial aggregates on {} nodes", ranges_per_endpoint.size());
+    return do_with(std::move(ranges_per_endpoint), std::vector<std::vector<bytes_opt>>(),
+            [s, &cf, &aggregates, cmd, cl, page_timeout, trace_state] (auto& ranges_per_endpoint, std::vector<std::vector<bytes_opt>>& partials) {
+        return parallel_for_each(ranges_per_endpoint, [s, &cf, &aggregates, cmd, cl, page_timeout, trace_state, &partials] (auto& endpoint_and_ranges) {
+            auto& endpoint = endpoint_and_ranges.first;
+            // The replica applies the page timeout to every page it reads, the
+            // request as a whole gets as many page timeouts as it may read pages.
+            auto f = endpoint == utils::fb_utilities::get_broadcast_address()
+                    ? query_partial_aggregates_on_this_node(s, aggregates, cmd, std::move(endpoint_and_ranges.second), cl, page_timeout)
+                    : netw::get_local_messaging_service().send_read_partial_aggregates(netw::messaging_service::msg_addr{endpoint, 0},
+                            scan_timeout(page_timeout, estimate_pages(cf, endpoint_and_ranges.second)), *cmd,
+                            endpoint_and_ranges.second, cl, aggregates.functions, aggregates.columns,
+                            std::chrono::duration_cast<std::chrono::milliseconds>(page_timeout).count());
+            return f.then([&partials, endpoint, trace_state] (std::vector<bytes_opt> partial) {
+                tracing::trace(trace_state, "Got partial aggregates from /{}", endpoint);
+                partials.push_back(std::move(partial));
+            });
+        }).then([s, &aggregates, &partials] {
+            auto selection = make_selection(get_local_storage_proxy().get_db().local(), s, aggregates);
+            return merge_partial_aggregates(aggregates, *selection, partials);
+        });
+    });
+}
+
+}
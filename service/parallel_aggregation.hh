@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <seastar/core/future.hh>
+#include <seastar/core/sstring.hh>
+#include "bytes.hh"
+#include "schema_fwd.hh"
+#include "query-request.hh"
+#include "dht/i_partitioner.hh"
+#include "db/consistency_level_type.hh"
+#include "db/timeout_clock.hh"
+#include "tracing/trace_state.hh"
+#include "seastarx.hh"
+
+namespace cql3::selection {
+
+class raw_selector;
+
+}
+
+namespace service {
+
+class storage_proxy;
+
+// Selectors of an aggregate query whose result can be computed in parts by
+// the nodes owning the data: count(*), and the native count, sum, min and
+// max of a column. Partial results are merged by summing the counts, and by
+// applying sum, min or max again to the other ones.
+struct partial_aggregates {
+    std::vector<sstring> functions;
+    // The column every function is applied to, empty for count(*).
+    std::vector<sstring> columns;
+};
+
+// Returns the selectors of the SELECT clause if all of them can be computed
+// in parts.
+std::optional<partial_aggregates> get_partial_aggregates(const std::vector<::shared_ptr<cql3::selection::raw_selector>>& select_clause, schema_ptr s);
+
+// Computes the aggregates of the read command over the ranges. The ranges
+// are split into vnodes, and the vnodes are grouped by their closest live
+// replica. Every replica then reads its group at the consistency level, in
+// parallel on all of its shards, and returns partial results which are
+// merged here.
+// The page timeout applies to every page read by the replicas, like it does
+// for a client paging through the table. A request to a replica times out
+// after the page timeout times the estimated number of pages it reads.
+future<std::vector<bytes_opt>> query_partial_aggregates(storage_proxy& proxy, schema_ptr s, const partial_aggregates& aggregates,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector ranges, db::consistency_level cl,
+        db::timeout_clock::duration page_timeout, tracing::trace_state_ptr trace_state);
+
+// The part of query_partial_aggregates() executed by every replica.
+future<std::vector<bytes_opt>> query_partial_aggregates_on_this_node(schema_ptr s, partial_aggregates aggregates,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector ranges, db::consistency_level cl,
+        db::timeout_clock::duration page_timeout);
+
+}
@@ -34,6 +34,7 @@ class priority_manager {
     ::io_priority_class _stream_write_priority;
     ::io_priority_class _sstable_query_read;
     ::io_priority_class _compaction_priority;
+    ::io_priority_class _view_build_read_priority;
 
 public:
     const ::io_priority_class&
@@ -66,6 +67,11 @@ class priority_manager {
         return _compaction_priority;
     }
 
+    const ::io_priority_class&
+    view_build_read_priority() {
+        return _view_build_read_priority;
+    }
+
     priority_manager()
         : _commitlog_priority(engine().register_one_priority_class("commitlog", 1000))
         , _mt_flush_priority(engine().register_one_priority_class("memtable_flush", 1000))
@@ -73,6 +79,7 @@ class priority_manager {
         , _stream_write_priority(engine().register_one_priority_class("streaming_write", 200))
         , _sstable_query_read(engine().register_one_priority_class("query", 1000))
         , _compaction_priority(engine().register_one_priority_class("compaction", 1000))
+        , _view_build_read_priority(engine().register_one_priority_class("view_build_read", 200))
 
     {}
 };
@@ -107,4 +114,9 @@ const inline ::io_priority_class&
 get_local_compaction_priority() {
     return get_local_priority_manager().compaction_priority();
 }
+
+const inline ::io_priority_class&
+get_local_view_build_read_priority() {
+    return get_local_priority_manager().view_build_read_priority();
+}
 }
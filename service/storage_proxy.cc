@@ -85,6 +85,7 @@
 #include <seastar/core/execution_stage.hh>
 #include "db/timeout_clock.hh"
 #include "multishard_mutation_query.hh"
+#include "service/parallel_aggregation.hh"
 #include "database.hh"
 
 namespace bi = boost::intrusive;
@@ -903,6 +904,9 @@ storage_proxy::storage_proxy(distributed<database>& db, storage_proxy::config cf
         sm::make_total_operations("reads", _stats.replica_digest_reads,
                        sm::description("number of remote digest read requests this Node received"), {storage_proxy_stats::split_stats::op_type_label("digest")}),
 
+        sm::make_total_operations("reads", _stats.replica_partial_aggregate_reads,
+                       sm::description("number of shard-wide partial aggregate scans this Node executed"), {storage_proxy_stats::split_stats::op_type_label("partial_aggregates")}),
+
         sm::make_total_operations("cross_shard_ops", _stats.replica_cross_shard_ops,
                        sm::description("number of operations that crossed a shard boundary")),
 
@@ -1518,6 +1522,15 @@ future<> storage_proxy::send_to_endpoint(
             allow_hints);
 }
 
+future<> storage_proxy::send_view_mutations(gms::inet_address target, const std::vector<frozen_mutation>& fms) {
+    // Same near-infinite timeout as view updates sent by send_to_endpoint().
+    auto timeout = clock_type::now() + 5min;
+    return netw::get_local_messaging_service().send_view_mutations(netw::messaging_service::msg_addr{target, 0}, timeout, fms).then(
+            [this, target] (db::view::update_backlog backlog) {
+        maybe_update_view_backlog_of(target, std::move(backlog));
+    });
+}
+
 /**
  * Send the mutations to the right targets, write it locally if it corresponds or writes a hint when the node
  * is not available.
@@ -3354,6 +3367,19 @@ void storage_proxy::init_messaging_service() {
             });
         });
     });
+    ms.register_view_mutations([] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> fms) {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        return do_with(std::move(fms), [src_addr, timeout = *t] (std::vector<frozen_mutation>& fms) {
+            return parallel_for_each(fms, [src_addr, timeout] (frozen_mutation& fm) {
+                return get_schema_for_write(fm.schema_version(), src_addr).then([&fm, timeout] (schema_ptr s) {
+                    return get_local_shared_storage_proxy()->mutate_locally(s, fm, timeout);
+                });
+            }).then([] {
+                // Like MUTATION_DONE, let the sender throttle on our view update backlog.
+                return get_local_shared_storage_proxy()->get_view_update_backlog();
+            });
+        });
+    });
     ms.register_mutation([] (const rpc::client_info& cinfo, rpc::opt_time_point t, frozen_mutation in, std::vector<gms::inet_address> forward, gms::inet_address reply_to, unsigned shard, storage_proxy::response_id_type response_id, rpc::optional<std::optional<tracing::trace_info>> trace_info) {
         tracing::trace_state_ptr trace_state_ptr;
         auto src_addr = netw::messaging_service::get_source(cinfo);
@@ -3548,6 +3574,16 @@ void storage_proxy::init_messaging_service() {
             });
         });
     });
+    ms.register_read_partial_aggregates([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, dht::partition_range_vector ranges,
+            db::consistency_level cl, std::vector<sstring> functions, std::vector<sstring> columns, uint64_t page_timeout_ms) {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        auto cmd_ptr = make_lw_shared<query::read_command>(std::move(cmd));
+        return get_schema_for_read(cmd_ptr->schema_version, std::move(src_addr)).then([cmd_ptr, ranges = std::move(ranges), cl, page_timeout_ms,
+                aggregates = partial_aggregates{std::move(functions), std::move(columns)}] (schema_ptr s) mutable {
+            auto page_timeout = std::chrono::duration_cast<db::timeout_clock::duration>(std::chrono::milliseconds(page_timeout_ms));
+            return query_partial_aggregates_on_this_node(std::move(s), std::move(aggregates), cmd_ptr, std::move(ranges), cl, page_timeout);
+        });
+    });
     ms.register_truncate([this](sstring ksname, sstring cfname) {
         return do_with(utils::make_joinpoint([] { return db_clock::now();}),
                         [this, ksname, cfname](auto& tsf) {
@@ -3570,11 +3606,13 @@ void storage_proxy::init_messaging_service() {
 void storage_proxy::uninit_messaging_service() {
     auto& ms = netw::get_local_messaging_service();
     ms.unregister_mutation();
+    ms.unregister_view_mutations();
     ms.unregister_mutation_done();
     ms.unregister_mutation_failed();
     ms.unregister_read_data();
     ms.unregister_read_mutation_data();
     ms.unregister_read_digest();
+    ms.unregister_read_partial_aggregates();
     ms.unregister_truncate();
 }
 
@@ -79,6 +79,7 @@ namespace service {
 class abstract_write_response_handler;
 class abstract_read_executor;
 class mutation_holder;
+struct partial_aggregates;
 
 using replicas_per_token_range = std::unordered_map<dht::token_range, std::vector<utils::UUID>>;
 
@@ -246,7 +247,6 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     bool hints_enabled(db::write_type type) noexcept;
     db::hints::manager& hints_manager_for(db::write_type type);
     std::vector<gms::inet_address> get_live_endpoints(keyspace& ks, const dht::token& token);
-    std::vector<gms::inet_address> get_live_sorted_endpoints(keyspace& ks, const dht::token& token);
     db::read_repair_decision new_read_repair_decision(const schema& s);
     ::shared_ptr<abstract_read_executor> get_read_executor(lw_shared_ptr<query::read_command> cmd,
             schema_ptr schema,
@@ -348,6 +348,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     }
     void init_messaging_service();
 
+    // Live replicas of the token, closest first.
+    std::vector<gms::inet_address> get_live_sorted_endpoints(keyspace& ks, const dht::token& token);
+
     // Applies mutation on this node.
     // Resolves with timed_out_error when timeout is reached.
     future<> mutate_locally(const mutation& m, clock_type::time_point timeout = clock_type::time_point::max());
@@ -400,6 +403,11 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<> send_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target, std::vector<gms::inet_address> pending_endpoints, db::write_type type, write_stats& stats, allow_hints allow_hints = allow_hints::yes);
     future<> send_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target, std::vector<gms::inet_address> pending_endpoints, db::write_type type, allow_hints allow_hints = allow_hints::yes);
 
+    // Applies view updates on the view replica they are paired with, in a single message.
+    // Unlike send_to_endpoint(), nothing is hinted if that fails. The mutations must be
+    // kept alive until the returned future resolves.
+    future<> send_view_mutations(gms::inet_address target, const std::vector<frozen_mutation>& fms);
+
     /**
      * Performs the truncate operatoin, which effectively deletes all data from
      * the column family cfname
@@ -466,6 +474,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     friend class abstract_write_response_handler;
     friend class speculating_read_executor;
     friend class view_update_backlog_broker;
+    friend future<std::vector<bytes_opt>> query_partial_aggregates_on_this_node(schema_ptr s, partial_aggregates aggregates,
+            lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector ranges, db::consistency_level cl,
+            db::timeout_clock::duration page_timeout);
 };
 
 extern distributed<storage_proxy> _the_storage_proxy;
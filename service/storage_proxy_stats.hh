@@ -133,6 +133,8 @@ struct stats : public write_stats {
     uint64_t replica_data_reads = 0;
     uint64_t replica_digest_reads = 0;
     uint64_t replica_mutation_data_reads = 0;
+    // number of shards which computed partial aggregates as a replica
+    uint64_t replica_partial_aggregate_reads = 0;
 
     uint64_t replica_cross_shard_ops = 0;
 
@@ -111,6 +111,11 @@ static const sstring CORRECT_STATIC_COMPACT_IN_MC = "CORRECT_STATIC_COMPACT_IN_M
 static const sstring UNBOUNDED_RANGE_TOMBSTONES_FEATURE = "UNBOUNDED_RANGE_TOMBSTONES";
 static const sstring VIEW_VIRTUAL_COLUMNS = "VIEW_VIRTUAL_COLUMNS";
 static const sstring DIGEST_INSENSITIVE_TO_EXPIRY = "DIGEST_INSENSITIVE_TO_EXPIRY";
+static const sstring SPLIT_BLOCK_BLOOM_FILTER = "SPLIT_BLOCK_BLOOM_FILTER";
+static const sstring REPAIR_RANGE_HASH = "REPAIR_RANGE_HASH";
+static const sstring STREAM_SSTABLE_FILES = "STREAM_SSTABLE_FILES";
+static const sstring PARALLELIZED_AGGREGATION = "PARALLELIZED_AGGREGATION";
+static const sstring VIEW_UPDATE_BATCHES = "VIEW_UPDATE_BATCHES";
 
 static const sstring SSTABLE_FORMAT_PARAM_NAME = "sstable_format";
 
@@ -164,6 +169,11 @@ storage_service::storage_service(distributed<database>& db, gms::gossiper& gossi
         , _unbounded_range_tombstones_feature(_feature_service, UNBOUNDED_RANGE_TOMBSTONES_FEATURE)
         , _view_virtual_columns(_feature_service, VIEW_VIRTUAL_COLUMNS)
         , _digest_insensitive_to_expiry(_feature_service, DIGEST_INSENSITIVE_TO_EXPIRY)
+        , _split_block_bloom_filter(_feature_service, SPLIT_BLOCK_BLOOM_FILTER)
+        , _repair_range_hash_feature(_feature_service, REPAIR_RANGE_HASH)
+        , _stream_sstable_files_feature(_feature_service, STREAM_SSTABLE_FILES)
+        , _parallelized_aggregation_feature(_feature_service, PARALLELIZED_AGGREGATION)
+        , _view_update_batches_feature(_feature_service, VIEW_UPDATE_BATCHES)
         , _la_feature_listener(*this, _feature_listeners_sem, sstables::sstable_version_types::la)
         , _mc_feature_listener(*this, _feature_listeners_sem, sstables::sstable_version_types::mc)
         , _replicate_action([this] { return do_replicate_to_all_cores(); })
@@ -218,6 +228,11 @@ void storage_service::enable_all_features() {
         std::ref(_unbounded_range_tombstones_feature),
         std::ref(_view_virtual_columns),
         std::ref(_digest_insensitive_to_expiry),
+        std::ref(_split_block_bloom_filter),
+        std::ref(_repair_range_hash_feature),
+        std::ref(_stream_sstable_files_feature),
+        std::ref(_parallelized_aggregation_feature),
+        std::ref(_view_update_batches_feature),
     })
     {
         if (features.count(f.name())) {
@@ -322,6 +337,10 @@ std::set<sstring> storage_service::get_config_supported_features_set() {
         CORRECT_STATIC_COMPACT_IN_MC,
         VIEW_VIRTUAL_COLUMNS,
         DIGEST_INSENSITIVE_TO_EXPIRY,
+        REPAIR_RANGE_HASH,
+        STREAM_SSTABLE_FILES,
+        PARALLELIZED_AGGREGATION,
+        VIEW_UPDATE_BATCHES,
     };
 
     // Do not respect config in the case database is not started
@@ -332,6 +351,9 @@ std::set<sstring> storage_service::get_config_supported_features_set() {
         if (config.enable_sstables_mc_format()) {
             features.insert(MC_SSTABLE_FEATURE);
         }
+        if (config.enable_sstables_split_block_filter()) {
+            features.insert(SPLIT_BLOCK_BLOOM_FILTER);
+        }
         if (config.experimental()) {
             // push additional experimental features
         }
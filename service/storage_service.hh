@@ -332,6 +332,11 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     gms::feature _unbounded_range_tombstones_feature;
     gms::feature _view_virtual_columns;
     gms::feature _digest_insensitive_to_expiry;
+    gms::feature _split_block_bloom_filter;
+    gms::feature _repair_range_hash_feature;
+    gms::feature _stream_sstable_files_feature;
+    gms::feature _parallelized_aggregation_feature;
+    gms::feature _view_update_batches_feature;
 
     sstables::sstable_version_types _sstables_format = sstables::sstable_version_types::ka;
     seastar::semaphore _feature_listeners_sem = {1};
@@ -2350,6 +2355,23 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     const gms::feature& cluster_supports_digest_insensitive_to_expiry() const {
         return _digest_insensitive_to_expiry;
     }
+    const gms::feature& cluster_supports_split_block_bloom_filter() const {
+        return _split_block_bloom_filter;
+    }
+    bool cluster_supports_repair_range_hash() const {
+        return bool(_repair_range_hash_feature);
+    }
+    bool cluster_supports_stream_sstable_files() const {
+        return bool(_stream_sstable_files_feature);
+    }
+
+    bool cluster_supports_parallelized_aggregation() const {
+        return bool(_parallelized_aggregation_feature);
+    }
+
+    bool cluster_supports_view_update_batches() const {
+        return bool(_view_update_batches_feature);
+    }
     // Returns schema features which all nodes in the cluster advertise as supported.
     db::schema_features cluster_schema_features() const;
 private:
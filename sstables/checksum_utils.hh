@@ -25,6 +25,7 @@
 #include <seastar/util/gcc6-concepts.hh>
 #include "libdeflate/libdeflate.h"
 #include "utils/gz/crc_combine.hh"
+#include "utils/gz/fast_crc32.hh"
 
 GCC6_CONCEPT(
 template<typename Checksum>
@@ -107,6 +108,32 @@ struct libdeflate_crc32_checksummer {
     static constexpr bool prefer_combine() { return false; }
 };
 
+struct fast_crc32_checksummer {
+    static uint32_t init_checksum() {
+        return 0;
+    }
+
+    static uint32_t checksum(const char* input, size_t input_len) {
+        return checksum(init_checksum(), input, input_len);
+    }
+
+    static uint32_t checksum(uint32_t prev, const char* input, size_t input_len) {
+        return fast_crc32(prev, input, input_len);
+    }
+
+    static uint32_t checksum_combine(uint32_t first, uint32_t second, size_t input_len2) {
+        return fast_crc32_combine(first, second, input_len2);
+    }
+
+    static constexpr bool prefer_combine() { return false; }
+};
+
+#if defined(__x86_64__)
+using default_crc32_checksummer = fast_crc32_checksummer;
+#else
+using default_crc32_checksummer = libdeflate_crc32_checksummer;
+#endif
+
 template<typename Checksum>
 inline uint32_t checksum_combine_or_feed(uint32_t first, uint32_t second, const char* input, size_t input_len) {
     if constexpr (Checksum::prefer_combine()) {
@@ -117,14 +144,14 @@ inline uint32_t checksum_combine_or_feed(uint32_t first, uint32_t second, const
 }
 
 struct crc32_utils {
-    static uint32_t init_checksum() { return libdeflate_crc32_checksummer::init_checksum(); }
+    static uint32_t init_checksum() { return default_crc32_checksummer::init_checksum(); }
 
     static uint32_t checksum(const char* input, size_t input_len) {
-        return libdeflate_crc32_checksummer::checksum(input, input_len);
+        return default_crc32_checksummer::checksum(input, input_len);
     }
 
     static uint32_t checksum(uint32_t prev, const char* input, size_t input_len) {
-        return libdeflate_crc32_checksummer::checksum(prev, input, input_len);
+        return default_crc32_checksummer::checksum(prev, input, input_len);
     }
 
     static uint32_t checksum_combine(uint32_t first, uint32_t second, size_t input_len2) {
@@ -318,6 +318,9 @@ class compaction {
     std::vector<unsigned long> _ancestors;
     db::replay_position _rp;
     encoding_stats_collector _stats_collector;
+    // Set once compaction may have dropped data because of purged tombstones,
+    // or dropped fully expired sstables without reading them.
+    bool _may_have_purged_tombstones = false;
 protected:
     compaction(column_family& cf, std::vector<shared_sstable> sstables, uint64_t max_sstable_size, uint32_t sstable_level)
         : _cf(cf)
@@ -393,6 +396,7 @@ class compaction {
             // Do not actually compact a sstable that is fully expired and can be safely
             // dropped without ressurrecting old data.
             if (fully_expired.count(sst)) {
+                _may_have_purged_tombstones = true;
                 continue;
             }
 
@@ -536,9 +540,12 @@ class regular_compaction : public compaction {
     std::optional<compaction_weight_registration> _weight_registration;
     mutable compaction_read_monitor_generator _monitor_generator;
     std::deque<compaction_write_monitor> _active_write_monitors = {};
-    utils::UUID _run_identifier = utils::make_random_uuid();
+    utils::UUID _run_identifier;
+    // token range of input which is compacted, outputs don't overlap with other ranges.
+    dht::partition_range _range;
 public:
-    regular_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator, replacer_fn replacer)
+    regular_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator, replacer_fn replacer,
+            dht::partition_range range = query::full_partition_range)
         : compaction(cf, std::move(descriptor.sstables), descriptor.max_sstable_bytes, descriptor.level)
         , _creator(std::move(creator))
         , _replacer(std::move(replacer))
@@ -547,6 +554,8 @@ class regular_compaction : public compaction {
         , _selector(_set.make_incremental_selector())
         , _weight_registration(std::move(descriptor.weight_registration))
         , _monitor_generator(_cf.get_compaction_manager(), _cf)
+        , _run_identifier(descriptor.run_identifier)
+        , _range(std::move(range))
     {
         _info->run_identifier = _run_identifier;
     }
@@ -554,7 +563,7 @@ class regular_compaction : public compaction {
     flat_mutation_reader make_sstable_reader() const override {
         return ::make_local_shard_sstable_reader(_schema,
                 _compacting,
-                query::full_partition_range,
+                _range,
                 _schema->full_slice(),
                 service::get_local_compaction_priority(),
                 no_resource_tracking(),
@@ -581,7 +590,12 @@ class regular_compaction : public compaction {
 
     virtual std::function<api::timestamp_type(const dht::decorated_key&)> max_purgeable_func() override {
         return [this] (const dht::decorated_key& dk) {
-            return get_max_purgeable_timestamp(_cf, *_selector, _compacting_for_max_purgeable_func, dk);
+            // Only called when the partition has a tombstone old enough to be purged.
+            auto max_purgeable = get_max_purgeable_timestamp(_cf, *_selector, _compacting_for_max_purgeable_func, dk);
+            if (max_purgeable != api::min_timestamp) {
+                _may_have_purged_tombstones = true;
+            }
+            return max_purgeable;
         };
     }
 
@@ -643,6 +657,9 @@ class regular_compaction : public compaction {
         // That's almost fine - C0 includes all the data from the now-missing B0. But the problem is that A is still *full* -
         // we didn't delete parts of A. So in particular, A now has that old data and the tombstone which was supposed to delete it is gone.
         // Data was ressurected.
+        // If no tombstone was purged so far, everything the exhausted sstables hold is in the output, so
+        // none of them has to be kept. This is what allows releasing fragments of overlapping sstable runs,
+        // which would otherwise be held back by the overlapping fragments of the other runs until the end.
         auto non_candidates_begin = _sstables.begin();
         auto non_candidates_end = exhausted;
 
@@ -655,10 +672,12 @@ class regular_compaction : public compaction {
             });
         };
 
-        do {
-            non_candidates_end = exhausted;
-            exhausted = std::partition(exhausted, _sstables.end(), overlap_with_any_non_candidate);
-        } while (non_candidates_end != exhausted);
+        if (_may_have_purged_tombstones) {
+            do {
+                non_candidates_end = exhausted;
+                exhausted = std::partition(exhausted, _sstables.end(), overlap_with_any_non_candidate);
+            } while (non_candidates_end != exhausted);
+        }
 
         if (exhausted != _sstables.end()) {
             // The goal is that exhausted sstables will be deleted as soon as possible,
@@ -710,8 +729,9 @@ class regular_compaction : public compaction {
 
 class cleanup_compaction final : public regular_compaction {
 public:
-    cleanup_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator, replacer_fn replacer)
-        : regular_compaction(cf, std::move(descriptor), std::move(creator), std::move(replacer))
+    cleanup_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator, replacer_fn replacer,
+            dht::partition_range range = query::full_partition_range)
+        : regular_compaction(cf, std::move(descriptor), std::move(creator), std::move(replacer), std::move(range))
     {
         _info->type = compaction_type::Cleanup;
     }
@@ -896,11 +916,202 @@ static std::unique_ptr<compaction> make_compaction(bool cleanup, Params&&... par
     }
 }
 
+// Splits the token span of sstables into at most count disjoint ranges of similar width,
+// which together cover the whole ring.
+static std::vector<dht::partition_range> split_into_subranges(const std::vector<shared_sstable>& sstables, unsigned count) {
+    auto first = sstables.front()->get_first_decorated_key().token();
+    auto last = sstables.front()->get_last_decorated_key().token();
+    for (auto& sst : sstables) {
+        first = std::min(first, sst->get_first_decorated_key().token());
+        last = std::max(last, sst->get_last_decorated_key().token());
+    }
+
+    std::vector<dht::token> boundaries;
+    std::function<void(const dht::token&, const dht::token&, unsigned)> split = [&] (const dht::token& left, const dht::token& right, unsigned n) {
+        if (n <= 1) {
+            return;
+        }
+        auto mid = dht::global_partitioner().midpoint(left, right);
+        split(left, mid, n / 2);
+        boundaries.push_back(mid);
+        split(mid, right, n - n / 2);
+    };
+    split(first, last, count);
+    // Narrow spans yield repeated boundaries, which would produce empty ranges.
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    std::vector<dht::partition_range> ranges;
+    std::optional<dht::partition_range::bound> start;
+    for (auto& t : boundaries) {
+        ranges.emplace_back(start, dht::partition_range::bound(dht::ring_position::ending_at(t), true));
+        start = dht::partition_range::bound(dht::ring_position::ending_at(t), false);
+    }
+    ranges.emplace_back(start, std::nullopt);
+    return ranges;
+}
+
+// Each sub-range is compacted by its own compaction into sstables of the descriptor's run.
+// An input sstable exhausted by one sub-range may still be read by another one, so
+// sstables are replaced in the column family only when all sub-ranges are done.
+static future<compaction_info>
+compact_sstables_in_parallel(sstables::compaction_descriptor descriptor, column_family& cf, std::function<shared_sstable()> creator, replacer_fn replacer, bool cleanup) {
+    struct parallel_compaction_state {
+        sstables::compaction_descriptor descriptor;
+        std::vector<dht::partition_range> ranges;
+        std::vector<compaction_info> infos;
+        std::vector<shared_sstable> new_sstables;
+    };
+    auto state = make_lw_shared<parallel_compaction_state>();
+    state->ranges = split_into_subranges(descriptor.sstables, descriptor.parallelism);
+    state->descriptor = std::move(descriptor);
+    clogger.debug("Compacting {} sstables of {}.{} in {} sub-ranges", state->descriptor.sstables.size(),
+            cf.schema()->ks_name(), cf.schema()->cf_name(), state->ranges.size());
+
+    return parallel_for_each(state->ranges, [state, &cf, creator, cleanup] (dht::partition_range& range) {
+        auto descriptor = sstables::compaction_descriptor(state->descriptor.sstables, state->descriptor.level, state->descriptor.max_sstable_bytes);
+        descriptor.run_identifier = state->descriptor.run_identifier;
+        auto collect_new_sstables = [state] (std::vector<shared_sstable> removed, std::vector<shared_sstable> added) {
+            std::move(added.begin(), added.end(), std::back_inserter(state->new_sstables));
+        };
+        auto c = make_compaction(cleanup, cf, std::move(descriptor), creator, std::move(collect_new_sstables), range);
+        return compaction::run(std::move(c)).then([state] (compaction_info info) {
+            state->infos.push_back(std::move(info));
+        });
+    }).then_wrapped([state, &cf, replacer = std::move(replacer)] (future<> f) {
+        if (f.failed()) {
+            // Sstables written by sub-ranges which completed never made it into the column family.
+            for (auto& sst : state->new_sstables) {
+                sst->mark_for_deletion();
+            }
+            return make_exception_future<compaction_info>(f.get_exception());
+        }
+        if (state->descriptor.weight_registration) {
+            cf.get_compaction_manager().on_compaction_complete(*state->descriptor.weight_registration);
+        }
+        replacer(std::move(state->descriptor.sstables), state->new_sstables);
+
+        auto info = std::move(state->infos.front());
+        for (auto it = state->infos.begin() + 1; it != state->infos.end(); ++it) {
+            info.end_size += it->end_size;
+            info.total_keys_written += it->total_keys_written;
+            info.ended_at = std::max(info.ended_at, it->ended_at);
+            std::move(it->new_sstables.begin(), it->new_sstables.end(), std::back_inserter(info.new_sstables));
+        }
+        return make_ready_future<compaction_info>(std::move(info));
+    });
+}
+
+// An input sstable which overlaps neither with the other inputs nor with the sstables
+// already in the output level would be rewritten as it is, only with a different level.
+// Unless compaction could purge some of its data, it's cheaper to just change its level,
+// as that avoids parsing and serializing all of its partitions again.
+// The inputs which are compacted may be written to the output level as sstables covering
+// anything from their smallest first key to their largest last key, so a moved sstable
+// must lie entirely outside of that span, not only outside of each of them.
+static std::vector<shared_sstable> get_sstables_to_move(const sstables::compaction_descriptor& descriptor, column_family& cf) {
+    auto& s = *cf.schema();
+    auto gc_before = gc_clock::now() - s.gc_grace_seconds();
+    auto level = uint32_t(descriptor.level);
+    auto overlaps = [&s] (const shared_sstable& a, const shared_sstable& b) {
+        return a->get_first_decorated_key().tri_compare(s, b->get_last_decorated_key()) <= 0
+            && b->get_first_decorated_key().tri_compare(s, a->get_last_decorated_key()) <= 0;
+    };
+    std::unordered_set<shared_sstable> inputs(descriptor.sstables.begin(), descriptor.sstables.end());
+    auto can_move = [&] (const shared_sstable& sst) {
+        if (sst->get_sstable_level() >= level || sst->data_size() > descriptor.max_sstable_bytes) {
+            return false;
+        }
+        if (sst->estimate_droppable_tombstone_ratio(gc_before) > 0) {
+            return false;
+        }
+        if (boost::algorithm::any_of(descriptor.sstables, [&] (const shared_sstable& other) { return other != sst && overlaps(sst, other); })) {
+            return false;
+        }
+        auto range = dht::partition_range::make(dht::ring_position(sst->get_first_decorated_key()),
+                                                dht::ring_position(sst->get_last_decorated_key()));
+        auto overlapping = cf.get_sstable_set().select(range);
+        return !boost::algorithm::any_of(overlapping, [&] (const shared_sstable& other) { return !inputs.count(other) && other->get_sstable_level() == level; });
+    };
+
+    std::vector<shared_sstable> ret;
+    std::vector<shared_sstable> compacted;
+    for (auto& sst : descriptor.sstables) {
+        if (can_move(sst)) {
+            ret.push_back(sst);
+        } else {
+            compacted.push_back(sst);
+        }
+    }
+
+    // A candidate inside the span of the compacted inputs is compacted too, which may
+    // widen the span, so repeat until no candidate falls inside of it.
+    bool changed = !compacted.empty();
+    while (changed && !ret.empty()) {
+        changed = false;
+        auto first = compacted.front()->get_first_decorated_key();
+        auto last = compacted.front()->get_last_decorated_key();
+        for (auto& sst : compacted) {
+            if (sst->get_first_decorated_key().tri_compare(s, first) < 0) {
+                first = sst->get_first_decorated_key();
+            }
+            if (sst->get_last_decorated_key().tri_compare(s, last) > 0) {
+                last = sst->get_last_decorated_key();
+            }
+        }
+        auto e = boost::range::remove_if(ret, [&] (const shared_sstable& sst) {
+            bool inside = sst->get_first_decorated_key().tri_compare(s, last) <= 0
+                    && first.tri_compare(s, sst->get_last_decorated_key()) <= 0;
+            if (inside) {
+                compacted.push_back(sst);
+                changed = true;
+            }
+            return inside;
+        });
+        ret.erase(e, ret.end());
+    }
+    return ret;
+}
+
 future<compaction_info>
 compact_sstables(sstables::compaction_descriptor descriptor, column_family& cf, std::function<shared_sstable()> creator, replacer_fn replacer, bool cleanup) {
     if (descriptor.sstables.empty()) {
         throw std::runtime_error(format("Called compaction with empty set on behalf of {}.{}", cf.schema()->ks_name(), cf.schema()->cf_name()));
     }
+    if (descriptor.allow_sstable_moves && !cleanup) {
+        descriptor.allow_sstable_moves = false;
+        auto to_move = get_sstables_to_move(descriptor, cf);
+        if (!to_move.empty()) {
+            for (auto& sst : to_move) {
+                clogger.info("Moving {}:level={:d} to level {:d} of {}.{}", sst->get_filename(), sst->get_sstable_level(), descriptor.level,
+                        cf.schema()->ks_name(), cf.schema()->cf_name());
+            }
+            auto level = descriptor.level;
+            return cf.move_sstables_to_level(to_move, level).then([descriptor = std::move(descriptor), to_move, &cf,
+                    creator = std::move(creator), replacer = std::move(replacer)] () mutable {
+                std::unordered_set<shared_sstable> moved(to_move.begin(), to_move.end());
+                auto e = boost::range::remove_if(descriptor.sstables, [&moved] (const shared_sstable& sst) { return moved.count(sst); });
+                descriptor.sstables.erase(e, descriptor.sstables.end());
+                if (!descriptor.sstables.empty()) {
+                    return compact_sstables(std::move(descriptor), cf, std::move(creator), std::move(replacer), false);
+                }
+                compaction_info info;
+                info.cf = &cf;
+                info.ks_name = cf.schema()->ks_name();
+                info.cf_name = cf.schema()->cf_name();
+                info.sstables = to_move.size();
+                info.ended_at = std::chrono::duration_cast<std::chrono::milliseconds>(db_clock::now().time_since_epoch()).count();
+                info.run_identifier = descriptor.run_identifier;
+                for (auto& sst : to_move) {
+                    info.start_size += sst->bytes_on_disk();
+                }
+                info.end_size = info.start_size;
+                return make_ready_future<compaction_info>(std::move(info));
+            });
+        }
+    }
+    if (descriptor.parallelism > 1) {
+        return compact_sstables_in_parallel(std::move(descriptor), cf, std::move(creator), std::move(replacer), cleanup);
+    }
     auto c = make_compaction(cleanup, cf, std::move(descriptor), std::move(creator), std::move(replacer));
     return compaction::run(std::move(c));
 }
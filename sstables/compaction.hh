@@ -36,13 +36,25 @@ namespace sstables {
         // List of sstables to be compacted.
         std::vector<sstables::shared_sstable> sstables;
         // Level of sstable(s) created by compaction procedure.
-        int level;
+        int level = 0;
         // Threshold size for sstable(s) to be created.
-        uint64_t max_sstable_bytes;
+        uint64_t max_sstable_bytes = std::numeric_limits<uint64_t>::max();
         // Holds ownership of a weight assigned to this compaction iff it's a regular one.
         std::optional<compaction_weight_registration> weight_registration;
         // Calls compaction manager's task for this compaction to release reference to exhausted sstables.
         std::function<void(const std::vector<shared_sstable>& exhausted_sstables)> release_exhausted;
+        // Run which sstable(s) created by compaction procedure will belong to.
+        utils::UUID run_identifier = utils::make_random_uuid();
+        // Number of disjoint token sub-ranges the job is split into, which are compacted
+        // concurrently. Each sub-range produces its own non-overlapping output sstable(s),
+        // all of them belonging to the same run.
+        unsigned parallelism = 1;
+        // True iff the job was picked by a strategy only to purge the droppable
+        // tombstones of a single sstable.
+        bool tombstone_compaction = false;
+        // If set, input sstables which would be rewritten as they are, only with a
+        // higher level, are moved to the output level instead.
+        bool allow_sstable_moves = false;
 
         compaction_descriptor() = default;
 
@@ -136,6 +148,9 @@ namespace sstables {
     // If cleanup is true, mutation that doesn't belong to current node will be
     // cleaned up, log messages will inform the user that compact_sstables runs for
     // cleaning operation, and compaction history will not be updated.
+    // If descriptor.parallelism is greater than 1, the token span of the input is split
+    // into that many sub-ranges which are compacted concurrently, and old sstables are
+    // replaced only once all of them are done.
     future<compaction_info> compact_sstables(sstables::compaction_descriptor descriptor, column_family& cf,
         std::function<shared_sstable()> creator, replacer_fn replacer, bool cleanup = false);
 
@@ -28,6 +28,7 @@
 #include "exceptions.hh"
 #include <cmath>
 #include <boost/range/algorithm/count_if.hpp>
+#include <boost/range/algorithm/remove_if.hpp>
 
 static logging::logger cmlog("compaction_manager");
 using namespace std::chrono_literals;
@@ -152,11 +153,25 @@ int compaction_manager::trim_to_compact(column_family* cf, sstables::compaction_
 
     uint64_t total_size = get_total_size(descriptor.sstables);
     int min_threshold = cf->schema()->min_compaction_threshold();
+    // Whole sstable runs are trimmed, as the incremental strategy compacts
+    // runs and must not be given only some of the fragments of one.
+    std::unordered_set<utils::UUID> runs;
+    for (auto& sst : descriptor.sstables) {
+        runs.insert(sst->run_identifier());
+    }
 
-    while (descriptor.sstables.size() > size_t(min_threshold)) {
+    while (runs.size() > size_t(min_threshold)) {
         if (_weight_tracker.count(weight)) {
-            total_size -= descriptor.sstables.back()->data_size();
-            descriptor.sstables.pop_back();
+            auto run = descriptor.sstables.back()->run_identifier();
+            auto e = boost::range::remove_if(descriptor.sstables, [&] (const sstables::shared_sstable& sst) {
+                if (sst->run_identifier() != run) {
+                    return false;
+                }
+                total_size -= sst->data_size();
+                return true;
+            });
+            descriptor.sstables.erase(e, descriptor.sstables.end());
+            runs.erase(run);
             weight = calculate_weight(total_size);
         } else {
             break;
@@ -262,6 +277,7 @@ future<> compaction_manager::submit_major_compaction(column_family* cf) {
             // those are eligible for major compaction.
             sstables::compaction_strategy cs = cf->get_compaction_strategy();
             sstables::compaction_descriptor descriptor = cs.get_major_compaction_job(*cf, get_candidates(*cf));
+            descriptor.parallelism = _parallelism;
             auto compacting = compacting_sstable_registration(this, descriptor.sstables);
 
             cmlog.info0("User initiated compaction started on behalf of {}.{}", cf->schema()->ks_name(), cf->schema()->cf_name());
@@ -378,6 +394,8 @@ void compaction_manager::register_metrics() {
     _metrics.add_group("compaction_manager", {
         sm::make_gauge("compactions", [this] { return _stats.active_tasks; },
                        sm::description("Holds the number of currently active compactions.")),
+        sm::make_derive("tombstone_compactions", [this] { return _stats.tombstone_compactions; },
+                       sm::description("Holds the number of single-sstable compactions started to purge droppable tombstones.")),
     });
 }
 
@@ -526,6 +544,9 @@ void compaction_manager::submit(column_family* cf) {
 
             _stats.pending_tasks--;
             _stats.active_tasks++;
+            if (descriptor.tombstone_compaction) {
+                _stats.tombstone_compactions++;
+            }
             task->compaction_running = true;
             return cf.run_compaction(std::move(descriptor)).then_wrapped([this, task, compacting = std::move(compacting)] (future<> f) mutable {
                 _stats.active_tasks--;
@@ -583,6 +604,7 @@ future<> compaction_manager::rewrite_sstables(column_family* cf, bool is_cleanup
         }
         column_family& cf = *task->compacting_cf;
         sstables::compaction_descriptor descriptor = sstables::compaction_descriptor(get_func(cf));
+        descriptor.parallelism = _parallelism;
         auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
         // Releases reference to cleaned sstable such that respective used disk space can be freed.
         descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
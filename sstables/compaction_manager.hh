@@ -52,6 +52,8 @@ class compaction_manager {
         int64_t completed_tasks = 0;
         uint64_t active_tasks = 0; // Number of compaction going on.
         int64_t errors = 0;
+        // Number of jobs started only to purge the droppable tombstones of a single sstable.
+        uint64_t tombstone_compactions = 0;
     };
 private:
     struct task {
@@ -144,6 +146,8 @@ class compaction_manager {
     compaction_backlog_manager _backlog_manager;
     seastar::scheduling_group _scheduling_group;
     size_t _available_memory;
+    // Number of token sub-ranges which major compaction and cleanup are split into.
+    unsigned _parallelism = 1;
 
     using get_candidates_func = std::function<std::vector<sstables::shared_sstable>(const column_family&)>;
 
@@ -201,6 +205,17 @@ class compaction_manager {
         return _stats;
     }
 
+    // Sets the number of disjoint token sub-ranges which user initiated compactions,
+    // i.e. major compaction, cleanup, upgrade and scrub, are split into and compacted
+    // concurrently.
+    void set_parallelism(unsigned parallelism) {
+        _parallelism = std::max(parallelism, 1u);
+    }
+
+    unsigned parallelism() const {
+        return _parallelism;
+    }
+
     void register_compaction(lw_shared_ptr<sstables::compaction_info> c) {
         _compactions.push_back(c);
     }
@@ -56,6 +56,7 @@
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "sstables/compaction_backlog_manager.hh"
 #include "sstables/size_tiered_backlog_tracker.hh"
 #include "mutation_source_metadata.hh"
@@ -440,6 +441,11 @@ std::unique_ptr<sstable_set_impl> leveled_compaction_strategy::make_sstable_set(
     return std::make_unique<partitioned_sstable_set>(std::move(schema));
 }
 
+std::unique_ptr<sstable_set_impl> incremental_compaction_strategy::make_sstable_set(schema_ptr schema) const {
+    // Fragments of a run don't overlap, so a read only touches one fragment per run.
+    return std::make_unique<partitioned_sstable_set>(std::move(schema), false);
+}
+
 std::unique_ptr<sstable_set_impl> make_partitioned_sstable_set(schema_ptr schema, bool use_level_metadata) {
     return std::make_unique<partitioned_sstable_set>(std::move(schema), use_level_metadata);
 }
@@ -448,7 +454,7 @@ compaction_descriptor compaction_strategy_impl::get_major_compaction_job(column_
     return compaction_descriptor(std::move(candidates));
 }
 
-bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before) {
+bool compaction_strategy_impl::worth_dropping_tombstones(column_family& cf, const shared_sstable& sst, gc_clock::time_point gc_before) {
     if (_disable_tombstone_compaction) {
         return false;
     }
@@ -459,7 +465,51 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     if (db_clock::now()-_tombstone_compaction_interval < sst->data_file_write_time()) {
         return false;
     }
-    return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
+    auto droppable_ratio = sst->estimate_droppable_tombstone_ratio(gc_before);
+    if (droppable_ratio < _tombstone_threshold) {
+        return false;
+    }
+    if (_unchecked_tombstone_compaction) {
+        return true;
+    }
+
+    // A tombstone can only be purged if it doesn't shadow data in other sstables, so
+    // discount the keys which overlapping sstables are estimated to also contain.
+    // Without that, the compaction could end up rewriting the same tombstones over
+    // and over without purging any of them.
+    auto& s = *cf.schema();
+    auto range = dht::partition_range::make(dht::ring_position(sst->get_first_decorated_key()),
+                                            dht::ring_position(sst->get_last_decorated_key()));
+    auto overlapping = cf.get_sstable_set().select(range);
+    auto token_range = dht::token_range::make(sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token());
+    // The keys of the sstable which others may also contain are estimated by
+    // the keys of the sstable in the parts of its range which others cover,
+    // so that how many keys the other sstables hold doesn't matter.
+    std::vector<dht::token_range> overlapping_ranges;
+    for (auto& other : overlapping) {
+        if (other == sst) {
+            continue;
+        }
+        auto other_range = dht::token_range::make(other->get_first_decorated_key().token(), other->get_last_decorated_key().token());
+        if (auto r = token_range.intersection(other_range, dht::token_comparator())) {
+            overlapping_ranges.push_back(std::move(*r));
+        }
+    }
+    uint64_t keys = sst->get_estimated_key_count();
+    uint64_t overlapping_keys = 0;
+    for (auto& r : dht::token_range::deoverlap(std::move(overlapping_ranges), dht::token_comparator())) {
+        overlapping_keys += sst->estimated_keys_for_range(r);
+    }
+    if (!overlapping_keys) {
+        return true;
+    }
+    if (!keys || overlapping_keys >= keys) {
+        clogger.debug("{}.{}: sstable {} is fully overlapped by other sstables, not worth dropping tombstones",
+            s.ks_name(), s.cf_name(), sst->get_filename());
+        return false;
+    }
+    auto remaining_ratio = double(keys - overlapping_keys) / keys;
+    return droppable_ratio * remaining_ratio >= _tombstone_threshold;
 }
 
 std::vector<resharding_descriptor>
@@ -816,6 +866,19 @@ size_tiered_compaction_strategy::size_tiered_compaction_strategy(const size_tier
     , _backlog_tracker(std::make_unique<size_tiered_backlog_tracker>())
 {}
 
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+    , _backlog_tracker(std::make_unique<size_tiered_backlog_tracker>())
+{
+    using namespace cql3::statements;
+    auto tmp_value = compaction_strategy_impl::get_value(options, FRAGMENT_SIZE_OPTION);
+    _fragment_size_in_mb = property_definitions::to_int(FRAGMENT_SIZE_OPTION, tmp_value, DEFAULT_FRAGMENT_SIZE_IN_MB);
+    if (_fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} value ({}) must be positive", FRAGMENT_SIZE_OPTION, _fragment_size_in_mb));
+    }
+}
+
 compaction_strategy::compaction_strategy(::shared_ptr<compaction_strategy_impl> impl)
     : _compaction_strategy_impl(std::move(impl)) {}
 compaction_strategy::compaction_strategy() = default;
@@ -895,6 +958,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = make_shared<time_window_compaction_strategy>(time_window_compaction_strategy(options));
         break;
+    case compaction_strategy_type::incremental:
+        impl = make_shared<incremental_compaction_strategy>(incremental_compaction_strategy(options));
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -42,11 +42,14 @@ class compaction_strategy_impl {
 protected:
     const sstring TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     const sstring TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
+    const sstring UNCHECKED_TOMBSTONE_COMPACTION_OPTION = "unchecked_tombstone_compaction";
 
     bool _use_clustering_key_filter = false;
     bool _disable_tombstone_compaction = false;
     float _tombstone_threshold = DEFAULT_TOMBSTONE_THRESHOLD;
     db_clock::duration _tombstone_compaction_interval = DEFAULT_TOMBSTONE_COMPACTION_INTERVAL();
+    // If set, tombstone compaction doesn't check whether the sstable overlaps with others.
+    bool _unchecked_tombstone_compaction = false;
 public:
     static std::optional<sstring> get_value(const std::map<sstring, sstring>& options, const sstring& name) {
         auto it = options.find(name);
@@ -67,6 +70,14 @@ class compaction_strategy_impl {
         auto interval = property_definitions::to_long(TOMBSTONE_COMPACTION_INTERVAL_OPTION, tmp_value, DEFAULT_TOMBSTONE_COMPACTION_INTERVAL().count());
         _tombstone_compaction_interval = db_clock::duration(std::chrono::seconds(interval));
 
+        tmp_value = get_value(options, UNCHECKED_TOMBSTONE_COMPACTION_OPTION);
+        if (tmp_value) {
+            if (*tmp_value != "true" && *tmp_value != "false") {
+                throw exceptions::configuration_exception(format("{} must be either 'true' or 'false', not {}", UNCHECKED_TOMBSTONE_COMPACTION_OPTION, *tmp_value));
+            }
+            _unchecked_tombstone_compaction = *tmp_value == "true";
+        }
+
         // FIXME: validate options.
     }
 public:
@@ -91,8 +102,10 @@ class compaction_strategy_impl {
     }
 
     // Check if a given sstable is entitled for tombstone compaction based on its
-    // droppable tombstone histogram and gc_before.
-    bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before);
+    // droppable tombstone histogram and gc_before. Unless unchecked_tombstone_compaction
+    // is set, keys which other sstables of the column family may also contain are
+    // not counted as droppable, as their tombstones may still shadow data there.
+    bool worth_dropping_tombstones(column_family& cf, const shared_sstable& sst, gc_clock::time_point gc_before);
 
     virtual compaction_backlog_tracker& get_backlog_tracker() = 0;
 
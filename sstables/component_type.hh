@@ -37,6 +37,7 @@ enum class component_type {
     TemporaryTOC,
     TemporaryStatistics,
     Scylla,
+    PartitionIndex,
     Unknown,
 };
 
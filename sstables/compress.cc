@@ -250,6 +250,10 @@ class local_compression {
                     size_t output_len) const;
     size_t compress_max_size(size_t input_len) const;
 
+    size_t dictionary_size() const;
+    bytes train_dictionary(const std::vector<temporary_buffer<char>>& samples) const;
+    local_compression with_dictionary(bytes_view dictionary) const;
+
     operator bool() const {
         return _compressor != nullptr;
     }
@@ -260,23 +264,7 @@ local_compression::local_compression(compressor_ptr p)
 {}
 
 local_compression::local_compression(const compression& c)
-    : _compressor([&c] {
-        sstring n(c.name.value.begin(), c.name.value.end());
-        return compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
-            if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
-                return to_sstring(c.chunk_len);
-            }
-            if (key == compression_parameters::SSTABLE_COMPRESSION) {
-                return n;
-            }
-            for (auto& o : c.options.elements) {
-                if (key == sstring(o.key.value.begin(), o.key.value.end())) {
-                    return sstring(o.value.value.begin(), o.value.value.end());
-                }
-            }
-            return std::nullopt;
-        });
-    }())
+    : _compressor(c.get_compressor())
 {}
 
 size_t local_compression::uncompress(const char* input,
@@ -296,6 +284,49 @@ size_t local_compression::compress(const char* input, size_t input_len,
 size_t local_compression::compress_max_size(size_t input_len) const {
     return _compressor ? _compressor->compress_max_size(input_len) : 0;
 }
+size_t local_compression::dictionary_size() const {
+    return _compressor ? _compressor->dictionary_size() : 0;
+}
+bytes local_compression::train_dictionary(const std::vector<temporary_buffer<char>>& samples) const {
+    return _compressor->train_dictionary(samples);
+}
+local_compression local_compression::with_dictionary(bytes_view dictionary) const {
+    return local_compression(_compressor->with_dictionary(dictionary));
+}
+
+compressor_ptr compression::make_compressor() const {
+    sstring n(name.value.begin(), name.value.end());
+    auto c = compressor::create(n, [this, &n](const sstring& key) -> compressor::opt_string {
+        if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
+            return to_sstring(chunk_len);
+        }
+        if (key == compression_parameters::SSTABLE_COMPRESSION) {
+            return n;
+        }
+        for (auto& o : options.elements) {
+            if (key == sstring(o.key.value.begin(), o.key.value.end())) {
+                return sstring(o.value.value.begin(), o.value.value.end());
+            }
+        }
+        return std::nullopt;
+    });
+    if (c && !_dictionary.empty()) {
+        c = c->with_dictionary(_dictionary);
+    }
+    return c;
+}
+
+void compression::load_compressor() {
+    _compressor = make_compressor();
+    _compressor_shard = engine().cpu_id();
+}
+
+compressor_ptr compression::get_compressor() const {
+    if (_compressor && _compressor_shard == engine().cpu_id()) {
+        return _compressor;
+    }
+    return make_compressor();
+}
 
 void compression::set_compressor(compressor_ptr c) {
     if (c) {
@@ -493,6 +524,11 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // When the compressor wants a dictionary, the first chunks are held
+    // back until enough of them were seen to train it.
+    size_t _training_sample_size;
+    size_t _training_bytes = 0;
+    std::vector<temporary_buffer<char>> _training_samples;
 public:
     compressed_file_data_sink_impl(file f, sstables::compression* cm, sstables::local_compression lc, file_output_stream_options options)
             : _out(make_file_output_stream(std::move(f), options))
@@ -500,10 +536,51 @@ class compressed_file_data_sink_impl : public data_sink_impl {
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _training_sample_size(std::min(_compression.dictionary_size() * dictionary_training_ratio, max_dictionary_training_sample_size))
     {}
 
+    // zstd recommends about 100 times more samples than the dictionary size,
+    // but training is not preemptible, so the sample is also capped to keep
+    // the stall it causes short.
+    static constexpr size_t dictionary_training_ratio = 100;
+    static constexpr size_t max_dictionary_training_sample_size = 1 << 20;
+
     future<> put(net::packet data) { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_training_sample_size) {
+            _training_bytes += buf.size();
+            _training_samples.push_back(std::move(buf));
+            if (_training_bytes < _training_sample_size) {
+                return make_ready_future<>();
+            }
+            return flush_training_samples();
+        }
+        return do_put(std::move(buf));
+    }
+    virtual future<> close() override {
+        auto f = _training_sample_size ? flush_training_samples() : make_ready_future<>();
+        return f.then([this] {
+            // Readers of the sstable just written reuse its metadata.
+            _compression_metadata->load_compressor();
+            return _out.close();
+        });
+    }
+private:
+    future<> flush_training_samples() {
+        auto dict = _compression.train_dictionary(_training_samples);
+        if (!dict.empty()) {
+            _compression = _compression.with_dictionary(dict);
+            _compression_metadata->set_dictionary(std::move(dict));
+        }
+        _training_sample_size = 0;
+        return do_with(std::exchange(_training_samples, {}), [this] (std::vector<temporary_buffer<char>>& samples) {
+            return do_for_each(samples, [this] (temporary_buffer<char>& buf) {
+                return do_put(std::move(buf));
+            });
+        });
+    }
+
+    future<> do_put(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -543,9 +620,6 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
-    virtual future<> close() override {
-        return _out.close();
-    }
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
@@ -307,6 +307,16 @@ struct compression {
     // Variables *not* found in the "Compression Info" file (added by update()):
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
+    // Trained compression dictionary, if the compressor uses one. It is
+    // stored in the Scylla component rather than in "Compression Info".
+    bytes _dictionary;
+    // The compressor, bound to the dictionary, built once by load_compressor()
+    // rather than by every reader. It can only be used by the shard which
+    // built it, as compressors are not shared across shards.
+    compressor_ptr _compressor;
+    unsigned _compressor_shard = 0;
+
+    compressor_ptr make_compressor() const;
 public:
     // Set the compressor algorithm, please check the definition of enum compressor.
     void set_compressor(compressor_ptr c);
@@ -364,6 +374,21 @@ struct compression {
         _full_checksum = checksum;
     }
 
+    const bytes& dictionary() const {
+        return _dictionary;
+    }
+
+    void set_dictionary(bytes dictionary) {
+        _dictionary = std::move(dictionary);
+    }
+
+    // Builds the compressor, bound to the dictionary if there is one. To be
+    // called once the compression parameters and dictionary are known.
+    void load_compressor();
+    // Returns the compressor built by load_compressor(), or a new one if it
+    // wasn't built on this shard.
+    compressor_ptr get_compressor() const;
+
     friend class sstable;
 };
 
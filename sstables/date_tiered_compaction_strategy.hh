@@ -421,8 +421,8 @@ class date_tiered_compaction_strategy : public compaction_strategy_impl {
         }
 
         // filter out sstables which droppable tombstone ratio isn't greater than the defined threshold.
-        auto e = boost::range::remove_if(candidates, [this, &gc_before] (const sstables::shared_sstable& sst) -> bool {
-            return !worth_dropping_tombstones(sst, gc_before);
+        auto e = boost::range::remove_if(candidates, [this, &cfs, &gc_before] (const sstables::shared_sstable& sst) -> bool {
+            return !worth_dropping_tombstones(cfs, sst, gc_before);
         });
         candidates.erase(e, candidates.end());
         if (candidates.empty()) {
@@ -433,7 +433,9 @@ class date_tiered_compaction_strategy : public compaction_strategy_impl {
         auto it = std::min_element(candidates.begin(), candidates.end(), [] (auto& i, auto& j) {
             return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
         });
-        return sstables::compaction_descriptor({ *it });
+        auto desc = sstables::compaction_descriptor({ *it });
+        desc.tombstone_compaction = true;
+        return desc;
     }
 
     virtual int64_t estimated_pending_compactions(column_family& cf) const override {
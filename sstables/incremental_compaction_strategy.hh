@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstable_set.hh"
+#include <boost/range/numeric.hpp>
+
+namespace sstables {
+
+// Size-tiered compaction of sstable runs, rather than of single sstables.
+//
+// Every compaction writes its output as a run of fragments of at most
+// sstable_size_in_mb each. Runs of similar size are bucketed and compacted
+// together, like sstables are by size-tiered compaction. Fragments of a run
+// don't overlap and are consumed in token order, so compaction can release
+// input fragments it's done with while it's still running (see
+// regular_compaction::maybe_replace_exhausted_sstables()). The temporary
+// space overhead is then bounded by a few fragments per input run, rather
+// than by the size of the whole input.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr int32_t DEFAULT_FRAGMENT_SIZE_IN_MB = 1000;
+    const sstring FRAGMENT_SIZE_OPTION = "sstable_size_in_mb";
+
+    int32_t _fragment_size_in_mb = DEFAULT_FRAGMENT_SIZE_IN_MB;
+    size_tiered_compaction_strategy_options _options;
+    compaction_backlog_tracker _backlog_tracker;
+
+    uint64_t fragment_size() const {
+        return uint64_t(_fragment_size_in_mb) * 1024 * 1024;
+    }
+
+    // Group sstables by the run they belong to.
+    static std::vector<sstable_run> get_runs(const std::vector<shared_sstable>& sstables);
+
+    // Group runs of similar size into buckets.
+    std::vector<std::vector<sstable_run>> get_buckets(std::vector<sstable_run> runs) const;
+
+    // Maybe return a bucket of runs to compact
+    std::vector<sstable_run> most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold) const;
+
+    compaction_descriptor make_descriptor(const std::vector<sstable_run>& runs) const;
+public:
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(column_family& cf) const override;
+
+    virtual compaction_strategy_type type() const {
+        return compaction_strategy_type::incremental;
+    }
+
+    // A run which is still being written by a compaction isn't a candidate,
+    // as its size isn't known yet.
+    virtual bool ignore_partial_runs() const override {
+        return true;
+    }
+
+    virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const override;
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+};
+
+inline std::vector<sstable_run>
+incremental_compaction_strategy::get_runs(const std::vector<shared_sstable>& sstables) {
+    std::unordered_map<utils::UUID, sstable_run> runs;
+    for (auto& sst : sstables) {
+        runs[sst->run_identifier()].insert(sst);
+    }
+    return boost::copy_range<std::vector<sstable_run>>(runs | boost::adaptors::map_values);
+}
+
+inline std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(std::vector<sstable_run> runs) const {
+    std::vector<std::pair<sstable_run, uint64_t>> sorted_runs;
+    sorted_runs.reserve(runs.size());
+    for (auto& run : runs) {
+        auto size = run.data_size();
+        sorted_runs.emplace_back(std::move(run), size);
+    }
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    std::map<uint64_t, std::vector<sstable_run>> buckets;
+
+    for (auto& pair : sorted_runs) {
+        bool found = false;
+        uint64_t size = pair.second;
+
+        // Same criteria as size_tiered_compaction_strategy::get_buckets(), applied to whole runs.
+        for (auto it = buckets.begin(); it != buckets.end(); it++) {
+            uint64_t old_average_size = it->first;
+
+            if ((size > (old_average_size * _options.bucket_low) && size < (old_average_size * _options.bucket_high)) ||
+                    (size < _options.min_sstable_size && old_average_size < _options.min_sstable_size)) {
+                auto bucket = std::move(it->second);
+                uint64_t total_size = bucket.size() * old_average_size;
+                uint64_t new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                bucket.push_back(std::move(pair.first));
+                buckets.erase(it);
+                buckets.insert({ new_average_size, std::move(bucket) });
+
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            std::vector<sstable_run> new_bucket;
+            new_bucket.push_back(std::move(pair.first));
+            buckets.insert({ size, std::move(new_bucket) });
+        }
+    }
+
+    return boost::copy_range<std::vector<std::vector<sstable_run>>>(buckets | boost::adaptors::map_values);
+}
+
+inline std::vector<sstable_run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets,
+        size_t min_threshold, size_t max_threshold) const {
+    std::optional<std::pair<std::vector<sstable_run>, uint64_t>> smallest;
+
+    for (auto& bucket : buckets) {
+        bucket.resize(std::min(bucket.size(), max_threshold));
+        if (bucket.size() < min_threshold) {
+            continue;
+        }
+        auto avg = boost::accumulate(bucket | boost::adaptors::transformed(std::mem_fn(&sstable_run::data_size)), uint64_t(0)) / bucket.size();
+        // Compacting smallest runs first, like size-tiered compaction does.
+        if (!smallest || avg < smallest->second) {
+            smallest.emplace(std::move(bucket), avg);
+        }
+    }
+
+    if (!smallest) {
+        return {};
+    }
+    return std::move(smallest->first);
+}
+
+inline compaction_descriptor
+incremental_compaction_strategy::make_descriptor(const std::vector<sstable_run>& runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return compaction_descriptor(std::move(sstables), 0, fragment_size());
+}
+
+inline compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) {
+    size_t min_threshold = cfs.schema()->min_compaction_threshold();
+    size_t max_threshold = cfs.schema()->max_compaction_threshold();
+    auto gc_before = gc_clock::now() - cfs.schema()->gc_grace_seconds();
+
+    auto buckets = get_buckets(get_runs(candidates));
+
+    auto most_interesting = most_interesting_bucket(buckets, min_threshold, max_threshold);
+    if (most_interesting.empty() && !cfs.compaction_enforce_min_threshold()) {
+        most_interesting = most_interesting_bucket(buckets, 2, max_threshold);
+    }
+    if (!most_interesting.empty()) {
+        return make_descriptor(most_interesting);
+    }
+
+    // If there's no run to compact in the standard way, try compacting a single fragment
+    // whose droppable tombstone ratio is greater than the threshold. The output replaces
+    // the fragment in its run, so prefer the oldest fragment of the largest runs.
+    for (auto&& bucket : buckets | boost::adaptors::reversed) {
+        std::vector<shared_sstable> sstables;
+        for (auto& run : bucket) {
+            boost::copy(run.all() | boost::adaptors::filtered([this, &cfs, &gc_before] (const shared_sstable& sst) {
+                return worth_dropping_tombstones(cfs, sst, gc_before);
+            }), std::back_inserter(sstables));
+        }
+        if (sstables.empty()) {
+            continue;
+        }
+        auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
+            return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
+        });
+        auto desc = compaction_descriptor({ *it }, 0, fragment_size());
+        desc.run_identifier = (*it)->run_identifier();
+        desc.tombstone_compaction = true;
+        return desc;
+    }
+    return compaction_descriptor();
+}
+
+inline compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    return compaction_descriptor(std::move(candidates), 0, fragment_size());
+}
+
+inline int64_t incremental_compaction_strategy::estimated_pending_compactions(column_family& cf) const {
+    size_t min_threshold = cf.schema()->min_compaction_threshold();
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    std::vector<shared_sstable> sstables(cf.get_sstables()->begin(), cf.get_sstables()->end());
+    int64_t n = 0;
+
+    for (auto& bucket : get_buckets(get_runs(sstables))) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+}
@@ -539,6 +539,53 @@ class index_reader {
         });
     }
 
+    // Positions the bound on the partition with the given key using the partition trie,
+    // or at the end if the sstable doesn't contain it.
+    //
+    // Only the Index range holding the partition's entry and the following one is read.
+    // Its entries are cached under keys which don't collide with summary indexes.
+    // The bound is marked as being on the last summary page, so that moving past
+    // these entries reaches the end, which is only correct if the partition is the
+    // last one. It's fine for single partition reads, which never go further than
+    // the beginning of the next partition.
+    future<> advance_to_with_trie(index_bound& bound, dht::ring_position_view pos) {
+        auto& s = *_sstable->_schema;
+        auto trie_key = partition_trie_key(pos.token(), bytes_view(key::from_partition_key(s, *pos.key())));
+        return _sstable->get_partition_trie()->lookup(std::move(trie_key), _pc).then([this, &bound] (std::optional<partition_trie_payload> p) {
+            if (!p) {
+                sstlog.trace("index {}: not found in the partition trie", this);
+                advance_to_end(bound);
+                return make_ready_future<>();
+            }
+            auto loader = [this, p = *p] (uint64_t) -> future<index_list> {
+                return do_with(std::make_unique<reader>(_sstable, _pc, p.index_position, p.index_end, 2), [] (auto& entries_reader) {
+                    return entries_reader->_context.consume_input().then([&entries_reader] {
+                        auto indexes = std::move(entries_reader->_consumer.indexes);
+                        return entries_reader->_context.close().then([indexes = std::move(indexes)] () mutable {
+                            return std::move(indexes);
+                        });
+                    });
+                });
+            };
+            auto list_key = (uint64_t(1) << 63) | p->index_position;
+            return _index_lists.get_or_load(list_key, loader).then([this, &bound] (shared_index_lists::list_ptr ref) {
+                if (ref->empty()) {
+                    throw malformed_sstable_exception("missing index entry", _sstable->filename(component_type::Index));
+                }
+                auto& summary = _sstable->get_summary();
+                bound.current_list = std::move(ref);
+                bound.previous_summary_idx = summary.header.size;
+                bound.current_summary_idx = summary.header.size ? summary.header.size - 1 : 0;
+                bound.current_index_idx = 0;
+                bound.current_pi_idx = 0;
+                bound.data_file_position = (*bound.current_list)[0].position();
+                bound.element = indexable_element::partition;
+                bound.end_open_marker.reset();
+                sstlog.trace("index {}: found in the partition trie, pos={}", this, bound.data_file_position);
+            });
+        });
+    }
+
     // Forwards the upper bound cursor to a position which is greater than given position in current partition.
     //
     // Note that the index within partition, unlike the partition index, doesn't cover all keys.
@@ -748,9 +795,16 @@ class index_reader {
 
     // Like advance_to(dht::ring_position_view), but returns information whether the key was found
     // If upper_bound is provided, the upper bound within position is looked up
+    //
+    // If the sstable has a partition trie and the cursor wasn't moved yet, the key
+    // is looked up in the trie instead of the summary. In that case, if the key
+    // is not found, the cursor is left at eof().
     future<bool> advance_lower_and_check_if_present(
             dht::ring_position_view key, std::optional<position_in_partition_view> pos = {}) {
-        return advance_to(_lower_bound, key).then([this, key, pos] {
+        auto f = _sstable->get_partition_trie() && key.key() && !_lower_bound.current_list && !_upper_bound
+                ? advance_to_with_trie(_lower_bound, key)
+                : advance_to(_lower_bound, key);
+        return f.then([this, key, pos] {
             if (eof()) {
                 return make_ready_future<bool>(false);
             }
@@ -79,6 +79,7 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(c
 
     if (!candidate.sstables.empty()) {
         leveled_manifest::logger.debug("leveled: Compacting {} out of {} sstables", candidate.sstables.size(), cfs.get_sstables()->size());
+        candidate.allow_sstable_moves = true;
         return candidate;
     }
 
@@ -90,8 +91,8 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(c
     for (auto level = int(manifest.get_level_count()); level >= 0; level--) {
         auto& sstables = manifest.get_level(level);
         // filter out sstables which droppable tombstone ratio isn't greater than the defined threshold.
-        auto e = boost::range::remove_if(sstables, [this, &gc_before] (const sstables::shared_sstable& sst) -> bool {
-            return !worth_dropping_tombstones(sst, gc_before);
+        auto e = boost::range::remove_if(sstables, [this, &cfs, &gc_before] (const sstables::shared_sstable& sst) -> bool {
+            return !worth_dropping_tombstones(cfs, sst, gc_before);
         });
         sstables.erase(e, sstables.end());
         if (sstables.empty()) {
@@ -100,7 +101,9 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(c
         auto& sst = *std::max_element(sstables.begin(), sstables.end(), [&] (auto& i, auto& j) {
             return i->estimate_droppable_tombstone_ratio(gc_before) < j->estimate_droppable_tombstone_ratio(gc_before);
         });
-        return sstables::compaction_descriptor({ sst }, sst->get_sstable_level());
+        auto desc = sstables::compaction_descriptor({ sst }, sst->get_sstable_level());
+        desc.tombstone_compaction = true;
+        return desc;
     }
     return {};
 }
@@ -27,6 +27,7 @@
 #include "vint-serialization.hh"
 #include "sstables/types.hh"
 #include "sstables/mc/types.hh"
+#include "sstables/partition_trie.hh"
 #include "db/config.hh"
 #include "atomic_cell.hh"
 
@@ -534,6 +535,8 @@ class writer : public sstable_writer::writer_impl {
     bool _compression_enabled = false;
     std::unique_ptr<file_writer> _data_writer;
     std::unique_ptr<file_writer> _index_writer;
+    std::unique_ptr<file_writer> _partition_trie_file_writer;
+    std::unique_ptr<partition_trie_writer> _partition_trie_writer;
     bool _tombstone_written = false;
     bool _static_row_written = false;
     // The length of partition header (partition key, partition deletion and static row, if present)
@@ -745,6 +748,10 @@ class writer : public sstable_writer::writer_impl {
         , _write_regular_as_static(cfg.correctly_serialize_static_compact_in_mc && s.is_static_compact_table())
     {
         _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _schema.bloom_filter_fp_chance());
+        bool write_partition_trie = _cfg.partition_trie_index && partitioner_supports_partition_trie(dht::global_partitioner());
+        if (write_partition_trie) {
+            _sst._recognized_components.insert(component_type::PartitionIndex);
+        }
         _sst.write_toc(_pc);
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -752,10 +759,18 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        _sst._components->filter = _cfg.split_block_filter
+                ? utils::i_filter::get_split_block_filter(estimated_partitions, _schema.bloom_filter_fp_chance())
+                : utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
         _pi_write_m.desired_block_size = cfg.promoted_index_block_size.value_or(get_config().column_index_size_in_kb() * 1024);
         _sst._correctly_serialize_non_compound_range_tombstones = _cfg.correctly_serialize_non_compound_range_tombstones;
         _index_sampling_state.summary_byte_cost = summary_byte_cost();
+        if (write_partition_trie) {
+            // Single partition lookups go through the partition trie, the
+            // summary is only used for range reads, so sample it sparsely.
+            auto ratio = std::max(_schema.max_index_interval() / std::max(_schema.min_index_interval(), 1), 1);
+            _index_sampling_state.summary_byte_cost *= ratio;
+        }
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
     }
 
@@ -781,6 +796,7 @@ writer::~writer() {
         }
     };
     close_writer(_index_writer);
+    close_writer(_partition_trie_file_writer);
     close_writer(_data_writer);
 }
 
@@ -841,6 +857,13 @@ void writer::init_file_writers() {
                 _schema.get_compressor_params()));
     }
     _index_writer = std::make_unique<file_writer>(std::move(_sst._index_file), options);
+
+    if (_sst.has_component(component_type::PartitionIndex)) {
+        auto f = _sst.new_sstable_component_file(_sst._write_error_handler, component_type::PartitionIndex,
+                open_flags::wo | open_flags::create | open_flags::exclusive).get0();
+        _partition_trie_file_writer = std::make_unique<file_writer>(std::move(f), options);
+        _partition_trie_writer = std::make_unique<partition_trie_writer>(*_partition_trie_file_writer);
+    }
 }
 
 std::unique_ptr<file_writer> writer::close_writer(std::unique_ptr<file_writer>& w) {
@@ -940,6 +963,9 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
 
     _sst._components->filter->add(bytes_view(*_partition_key));
     _sst.get_metadata_collector().add_key(bytes_view(*_partition_key));
+    if (_partition_trie_writer) {
+        _partition_trie_writer->add(partition_trie_key(dk.token(), bytes_view(*_partition_key)), _index_writer->offset());
+    }
 
     auto p_key = disk_string_view<uint16_t>();
     p_key.value = bytes_view(*_partition_key);
@@ -1394,6 +1420,11 @@ void writer::consume_end_of_stream() {
         _sst.get_metadata_collector().add_compression_ratio(_sst._components->compression.compressed_file_length(), _sst._components->compression.uncompressed_file_length());
     }
 
+    if (_partition_trie_writer) {
+        _partition_trie_writer->finish(_index_writer->offset());
+        _partition_trie_writer.reset();
+        close_writer(_partition_trie_file_writer);
+    }
     close_writer(_index_writer);
     _sst.set_first_and_last_keys();
 
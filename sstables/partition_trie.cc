@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/future-util.hh>
+
+#include "partition_trie.hh"
+#include "exceptions.hh"
+#include "writer.hh"
+#include "vint-serialization.hh"
+
+namespace sstables {
+
+static constexpr size_t token_size = sizeof(int64_t);
+
+bytes partition_trie_key(const dht::token& token, bytes_view key) {
+    bytes_view token_bytes(token._data);
+    assert(token_bytes.size() == token_size);
+    bytes result(bytes::initialized_later(), token_size + key.size());
+    auto out = std::copy(token_bytes.begin(), token_bytes.end(), result.begin());
+    // Tokens compare as signed integers, flip the sign bit to make them compare as bytes.
+    result[0] ^= 0x80;
+    std::copy(key.begin(), key.end(), out);
+    return result;
+}
+
+bool partitioner_supports_partition_trie(const dht::i_partitioner& partitioner) {
+    return partitioner.name() == "org.apache.cassandra.dht.Murmur3Partitioner";
+}
+
+static size_t common_prefix_length(bytes_view a, bytes_view b) {
+    auto n = std::min(a.size(), b.size());
+    return std::mismatch(a.begin(), a.begin() + n, b.begin()).first - a.begin();
+}
+
+partition_trie_writer::partition_trie_writer(file_writer& out)
+    : _out(out)
+    , _open(1) {
+}
+
+void partition_trie_writer::add(bytes key, uint64_t index_position) {
+    _unresolved.emplace_back(std::move(key), index_position);
+    if (_unresolved.size() == 3) {
+        resolve(index_position);
+    }
+}
+
+void partition_trie_writer::resolve(uint64_t index_end) {
+    auto e = std::move(_unresolved.front());
+    _unresolved.erase(_unresolved.begin());
+    if (!_same_token.empty() && !std::equal(e.first.begin(), e.first.begin() + token_size, _same_token.front().first.begin())) {
+        flush_same_token();
+    }
+    _same_token.emplace_back(std::move(e.first), partition_trie_payload{e.second, index_end});
+}
+
+void partition_trie_writer::flush_same_token() {
+    std::sort(_same_token.begin(), _same_token.end(), [] (auto& a, auto& b) {
+        return compare_unsigned(a.first, b.first) < 0;
+    });
+    for (auto& e : _same_token) {
+        insert(std::move(e.first), e.second);
+    }
+    _same_token.clear();
+}
+
+void partition_trie_writer::insert(bytes key, partition_trie_payload payload) {
+    if (_pending) {
+        auto common = common_prefix_length(_pending->first, key);
+        auto length = std::min(_pending->first.size(), std::max(_pending_common_prefix, common) + 1);
+        store(bytes_view(_pending->first).substr(0, length), _pending->second);
+        _pending_common_prefix = common;
+    }
+    _pending.emplace(std::move(key), payload);
+}
+
+void partition_trie_writer::store(bytes_view prefix, partition_trie_payload payload) {
+    auto common = common_prefix_length(_last_prefix, prefix);
+    while (_open.size() > common + 1) {
+        close_node();
+    }
+    _open.resize(prefix.size() + 1);
+    _open.back().payload = payload;
+    _last_prefix = bytes(prefix);
+}
+
+void partition_trie_writer::close_node() {
+    auto node = std::move(_open.back());
+    _open.pop_back();
+    auto position = write_node(node);
+    _open.back().children.emplace_back(_last_prefix[_open.size() - 1], position);
+}
+
+uint64_t partition_trie_writer::write_node(const open_node& node) {
+    // Children are written before their parent. Use the worst case padding
+    // to choose the pointer width, so that it doesn't depend on the padding.
+    uint64_t max_distance = 0;
+    for (auto& c : node.children) {
+        max_distance = std::max(max_distance, _out.offset() + partition_trie_page_size - c.second);
+    }
+    uint8_t width_log2 = max_distance < (uint64_t(1) << 8) ? 0
+            : max_distance < (uint64_t(1) << 16) ? 1
+            : max_distance < (uint64_t(1) << 32) ? 2 : 3;
+    size_t width = size_t(1) << width_log2;
+
+    size_t size = 1 + unsigned_vint::serialized_size(node.children.size()) + node.children.size() * (1 + width);
+    if (node.payload) {
+        size += unsigned_vint::serialized_size(node.payload->index_position);
+        size += unsigned_vint::serialized_size(node.payload->index_end - node.payload->index_position);
+    }
+    assert(size <= partition_trie_page_size);
+
+    auto in_page = _out.offset() % partition_trie_page_size;
+    if (in_page + size > partition_trie_page_size) {
+        bytes padding(partition_trie_page_size - in_page, 0);
+        _out.write(padding);
+    }
+    uint64_t position = _out.offset();
+
+    bytes buf(bytes::initialized_later(), size);
+    auto out = buf.begin();
+    *out++ = int8_t(uint8_t(node.payload ? 1 : 0) | (width_log2 << 1));
+    if (node.payload) {
+        out += unsigned_vint::serialize(node.payload->index_position, out);
+        out += unsigned_vint::serialize(node.payload->index_end - node.payload->index_position, out);
+    }
+    out += unsigned_vint::serialize(node.children.size(), out);
+    for (auto& c : node.children) {
+        *out++ = int8_t(c.first);
+    }
+    for (auto& c : node.children) {
+        uint64_t distance = position - c.second;
+        for (size_t i = width; i > 0; --i) {
+            *out++ = int8_t(distance >> ((i - 1) * 8));
+        }
+    }
+    _out.write(buf);
+    return position;
+}
+
+void partition_trie_writer::finish(uint64_t index_size) {
+    while (!_unresolved.empty()) {
+        resolve(index_size);
+    }
+    flush_same_token();
+    if (_pending) {
+        auto length = std::min(_pending->first.size(), _pending_common_prefix + 1);
+        store(bytes_view(_pending->first).substr(0, length), _pending->second);
+        _pending.reset();
+    }
+    while (_open.size() > 1) {
+        close_node();
+    }
+    auto root = write_node(_open.back());
+    _open.clear();
+    char footer[sizeof(uint64_t)];
+    write_be<uint64_t>(footer, root);
+    _out.write(footer, sizeof(footer));
+}
+
+namespace {
+
+// A parsed trie node, valid as long as the page it was parsed from.
+struct node_view {
+    std::optional<partition_trie_payload> payload;
+    bytes_view transitions;
+    const int8_t* pointers;
+    size_t width;
+
+    static node_view parse(const temporary_buffer<char>& page, size_t offset) {
+        if (offset >= page.size()) {
+            throw malformed_sstable_exception(format("partition trie node at offset {} is out of the page", offset));
+        }
+        bytes_view in(reinterpret_cast<const int8_t*>(page.get()) + offset, page.size() - offset);
+        auto read_vint = [&in] {
+            if (in.empty() || unsigned_vint::serialized_size_from_first_byte(in[0]) > in.size()) {
+                throw malformed_sstable_exception("truncated partition trie node");
+            }
+            auto len = unsigned_vint::serialized_size_from_first_byte(in[0]);
+            auto v = unsigned_vint::deserialize(in);
+            in.remove_prefix(len);
+            return v;
+        };
+        node_view n;
+        uint8_t flags = in[0];
+        in.remove_prefix(1);
+        n.width = size_t(1) << ((flags >> 1) & 3);
+        if (flags & 1) {
+            auto position = read_vint();
+            auto length = read_vint();
+            n.payload = partition_trie_payload{position, position + length};
+        }
+        auto count = read_vint();
+        if (in.size() < count * (1 + n.width)) {
+            throw malformed_sstable_exception("truncated partition trie node");
+        }
+        n.transitions = in.substr(0, count);
+        n.pointers = in.data() + count;
+        return n;
+    }
+
+    // Returns the distance back to the child reached with the given byte.
+    std::optional<uint64_t> child(uint8_t b) const {
+        auto t = reinterpret_cast<const uint8_t*>(transitions.data());
+        auto i = std::lower_bound(t, t + transitions.size(), b);
+        if (i == t + transitions.size() || *i != b) {
+            return std::nullopt;
+        }
+        uint64_t distance = 0;
+        auto p = pointers + (i - t) * width;
+        for (size_t j = 0; j < width; ++j) {
+            distance = (distance << 8) | uint8_t(p[j]);
+        }
+        return distance;
+    }
+};
+
+}
+
+partition_trie::partition_trie(file f, uint64_t root, uint64_t root_page_position, temporary_buffer<char> root_page)
+    : _file(std::move(f))
+    , _root(root)
+    , _root_page_position(root_page_position)
+    , _root_page(std::move(root_page)) {
+}
+
+future<lw_shared_ptr<partition_trie>> partition_trie::open(file f, const io_priority_class& pc) {
+    return f.size().then([f, &pc] (uint64_t size) mutable {
+        if (size < sizeof(uint64_t)) {
+            throw malformed_sstable_exception("partition trie is missing its footer");
+        }
+        return f.dma_read_exactly<char>(size - sizeof(uint64_t), sizeof(uint64_t), pc).then([f, size, &pc] (temporary_buffer<char> footer) mutable {
+            auto root = read_be<uint64_t>(footer.get());
+            if (root >= size - sizeof(uint64_t)) {
+                throw malformed_sstable_exception(format("partition trie root {} is past the end of the file", root));
+            }
+            auto page_position = root - root % partition_trie_page_size;
+            auto len = std::min<uint64_t>(partition_trie_page_size, size - page_position);
+            return f.dma_read_exactly<char>(page_position, len, pc).then([f, root, page_position] (temporary_buffer<char> page) mutable {
+                return make_lw_shared<partition_trie>(std::move(f), root, page_position, std::move(page));
+            });
+        });
+    });
+}
+
+future<temporary_buffer<char>> partition_trie::read_page(uint64_t page_position, const io_priority_class& pc) const {
+    if (page_position == _root_page_position) {
+        return make_ready_future<temporary_buffer<char>>(_root_page.share());
+    }
+    // Nodes never cross page boundaries, and the page with the root is the
+    // last one, so every other page is full.
+    return _file.dma_read_exactly<char>(page_position, partition_trie_page_size, pc);
+}
+
+future<std::optional<partition_trie_payload>> partition_trie::lookup(bytes key, const io_priority_class& pc) const {
+    struct cursor {
+        bytes key;
+        uint64_t position;
+        size_t depth = 0;
+    };
+    using result_type = std::optional<partition_trie_payload>;
+    return do_with(cursor{std::move(key), _root}, [this, &pc] (cursor& c) {
+        return repeat_until_value([this, &pc, &c] {
+            auto page_position = c.position - c.position % partition_trie_page_size;
+            return read_page(page_position, pc).then([&c, page_position] (temporary_buffer<char> page) -> std::optional<result_type> {
+                auto n = node_view::parse(page, c.position - page_position);
+                if (n.transitions.empty() || c.depth == c.key.size()) {
+                    return n.payload;
+                }
+                auto distance = n.child(c.key[c.depth]);
+                if (!distance) {
+                    return result_type();
+                }
+                if (*distance == 0 || *distance > c.position) {
+                    throw malformed_sstable_exception(format("invalid partition trie child pointer {} at {}", *distance, c.position));
+                }
+                c.position -= *distance;
+                ++c.depth;
+                return std::nullopt;
+            });
+        });
+    });
+}
+
+future<> partition_trie::close() {
+    return _file.close();
+}
+
+}
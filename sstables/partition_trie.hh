@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include "bytes.hh"
+#include "dht/i_partitioner.hh"
+#include "seastarx.hh"
+
+// The PartitionIndex component maps partition keys to their entries in the
+// Index component, so that a single partition can be located without the
+// summary.
+//
+// It is a byte-ordered trie over the keys returned by partition_trie_key().
+// Each key is stored only up to the byte which distinguishes it from its
+// neighbours, so the trie has O(1) nodes per partition and a lookup may
+// return a candidate for an absent key; the caller verifies the candidate
+// against the key stored in the Index entry.
+//
+// Nodes are written in post-order, so that children always precede their
+// parent and the root is the last node in the file, followed by its position
+// as a big-endian 64-bit integer. No node crosses a page boundary, so visiting
+// a node costs at most one page read. A node is laid out as:
+//
+//   flags:        byte; bit 0 - has payload, bits 1-2 - log2 of child pointer width
+//   payload:      unsigned vint Index position, unsigned vint length of the
+//                 Index range holding the entry and the one following it
+//   child count:  unsigned vint
+//   transitions:  one byte per child, in increasing order
+//   pointers:     distance from the node back to each child, big-endian
+namespace sstables {
+
+class file_writer;
+
+constexpr size_t partition_trie_page_size = 4096;
+
+// Returns the byte-comparable trie key for a partition. Only the murmur3
+// partitioner, whose tokens are 8-byte signed integers, is supported.
+bytes partition_trie_key(const dht::token& token, bytes_view key);
+bool partitioner_supports_partition_trie(const dht::i_partitioner& partitioner);
+
+struct partition_trie_payload {
+    // Position of the partition's entry in the Index component.
+    uint64_t index_position;
+    // End of the Index range starting at index_position which holds the
+    // partition's entry and, if present, the next partition's entry.
+    uint64_t index_end;
+};
+
+// Builds the trie incrementally. Partitions must be added in ring order.
+// Must be used in a seastar thread.
+class partition_trie_writer {
+    struct open_node {
+        std::vector<std::pair<uint8_t, uint64_t>> children;
+        std::optional<partition_trie_payload> payload;
+    };
+    file_writer& _out;
+    // Partitions whose Index range isn't known yet, in Index order.
+    std::vector<std::pair<bytes, uint64_t>> _unresolved;
+    // Partitions sharing the token of the last resolved one. They are ordered
+    // by key in the ring, which may differ from byte order.
+    std::vector<std::pair<bytes, partition_trie_payload>> _same_token;
+    // The last key passed to insert(), not yet stored because the length of
+    // its distinguishing prefix depends on the next key.
+    std::optional<std::pair<bytes, partition_trie_payload>> _pending;
+    size_t _pending_common_prefix = 0;
+    // Nodes on the path to the last stored prefix, _open[i] is at depth i.
+    std::vector<open_node> _open;
+    bytes _last_prefix;
+private:
+    void resolve(uint64_t index_end);
+    void flush_same_token();
+    void insert(bytes key, partition_trie_payload payload);
+    void store(bytes_view prefix, partition_trie_payload payload);
+    void close_node();
+    uint64_t write_node(const open_node& node);
+public:
+    explicit partition_trie_writer(file_writer& out);
+    // Adds a partition whose Index entry starts at index_position.
+    void add(bytes key, uint64_t index_position);
+    // Writes out the trie. index_size is the final size of the Index component.
+    void finish(uint64_t index_size);
+};
+
+class partition_trie {
+    file _file;
+    uint64_t _root;
+    // The root is always looked up, so the page holding it is kept in memory.
+    uint64_t _root_page_position;
+    temporary_buffer<char> _root_page;
+private:
+    future<temporary_buffer<char>> read_page(uint64_t page_position, const io_priority_class& pc) const;
+public:
+    partition_trie(file f, uint64_t root, uint64_t root_page_position, temporary_buffer<char> root_page);
+
+    static future<lw_shared_ptr<partition_trie>> open(file f, const io_priority_class& pc);
+
+    // Returns the Index range of the only partition which may have the given
+    // trie key, or std::nullopt if the sstable certainly doesn't contain it.
+    future<std::optional<partition_trie_payload>> lookup(bytes key, const io_priority_class& pc) const;
+
+    future<> close();
+};
+
+}
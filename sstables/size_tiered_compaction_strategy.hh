@@ -112,6 +112,7 @@ class size_tiered_compaction_strategy_options {
     }
 #endif
     friend class size_tiered_compaction_strategy;
+    friend class incremental_compaction_strategy;
 };
 
 class size_tiered_compaction_strategy : public compaction_strategy_impl {
@@ -308,8 +309,8 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(column_family& cfs,
     // tombstone purge, i.e. less likely to shadow even older data.
     for (auto&& sstables : buckets | boost::adaptors::reversed) {
         // filter out sstables which droppable tombstone ratio isn't greater than the defined threshold.
-        auto e = boost::range::remove_if(sstables, [this, &gc_before] (const sstables::shared_sstable& sst) -> bool {
-            return !worth_dropping_tombstones(sst, gc_before);
+        auto e = boost::range::remove_if(sstables, [this, &cfs, &gc_before] (const sstables::shared_sstable& sst) -> bool {
+            return !worth_dropping_tombstones(cfs, sst, gc_before);
         });
         sstables.erase(e, sstables.end());
         if (sstables.empty()) {
@@ -319,7 +320,9 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(column_family& cfs,
         auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
             return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
         });
-        return sstables::compaction_descriptor({ *it });
+        auto desc = sstables::compaction_descriptor({ *it });
+        desc.tombstone_compaction = true;
+        return desc;
     }
     return sstables::compaction_descriptor();
 }
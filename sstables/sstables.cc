@@ -811,6 +811,24 @@ future<> parse(sstable_version_types v, random_access_reader& in, compression& c
     });
 }
 
+// The CRC component is the chunk size followed by one checksum per chunk of
+// the data file, with no element count: the checksums run up to end of file.
+future<> parse(sstable_version_types v, random_access_reader& in, checksum& c) {
+    return parse(v, in, c.chunk_size).then([v, &in, &c] {
+        return do_until([&in] { return in.eof(); }, [v, &in, &c] {
+            return in.read_exactly(sizeof(uint32_t)).then([&c] (temporary_buffer<char> buf) {
+                if (buf.empty()) {
+                    return;
+                }
+                check_buf_size(buf, sizeof(uint32_t));
+                uint32_t value;
+                read_integer(buf, value);
+                c.checksums.push_back(value);
+            });
+        });
+    });
+}
+
 void write(sstable_version_types v, file_writer& out, const compression& c) {
     write(v, out, c.name, c.options, c.uncompressed_chunk_length(), c.uncompressed_file_length());
 
@@ -1067,7 +1085,13 @@ future<> sstable::read_compression(const io_priority_class& pc) {
         return make_ready_future<>();
     }
 
-    return read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    return read_simple<component_type::CompressionInfo>(_components->compression, pc).then([this] {
+        auto* dict = _components->scylla_metadata ? _components->scylla_metadata->get_compression_dictionary() : nullptr;
+        if (dict) {
+            _components->compression.set_dictionary(dict->dictionary.value);
+        }
+        _components->compression.load_compressor();
+    });
 }
 
 void sstable::write_compression(const io_priority_class& pc) {
@@ -1278,6 +1302,15 @@ future<> sstable::update_info_for_opened_data() {
             });
         }
         return make_ready_future<>();
+    }).then([this] {
+        if (!this->has_component(component_type::PartitionIndex) || _partition_trie) {
+            return make_ready_future<>();
+        }
+        return open_file(component_type::PartitionIndex, open_flags::ro).then([this] (file f) {
+            return partition_trie::open(std::move(f), default_priority_class());
+        }).then([this] (lw_shared_ptr<partition_trie> trie) {
+            _partition_trie = std::move(trie);
+        });
     }).then([this] {
         this->set_clustering_components_ranges();
         this->set_first_and_last_keys();
@@ -1329,6 +1362,11 @@ future<> sstable::read_filter(const io_priority_class& pc) {
         read_simple<component_type::Filter>(filter, pc).get();
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
         large_bitset bs(nr_bits, std::move(filter.buckets.elements));
+        auto* fv = _components->scylla_metadata ? _components->scylla_metadata->get_filter_version() : nullptr;
+        if (fv && fv->version == filter_version::split_block_bloom) {
+            _components->filter = utils::filter::create_split_block_filter(std::move(bs));
+            return;
+        }
         utils::filter_format format = (_version == sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
@@ -1341,7 +1379,7 @@ void sstable::write_filter(const io_priority_class& pc) {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
     auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
@@ -1372,6 +1410,60 @@ future<> sstable::load(const io_priority_class& pc) {
     });
 }
 
+template <typename ChecksumType>
+static void validate_chunk_checksums(input_stream<char>& stream, const checksum& c, const sstring& file_path) {
+    size_t chunk = 0;
+    for (;;) {
+        auto buf = stream.read_exactly(c.chunk_size).get0();
+        if (buf.empty()) {
+            break;
+        }
+        if (chunk >= c.checksums.size()) {
+            throw malformed_sstable_exception(format("data file has more than the {} chunks covered by the CRC component", c.checksums.size()), file_path);
+        }
+        if (ChecksumType::checksum(buf.get(), buf.size()) != c.checksums[chunk]) {
+            throw malformed_sstable_exception(format("chunk {} failed checksum", chunk), file_path);
+        }
+        ++chunk;
+    }
+    if (chunk != c.checksums.size()) {
+        throw malformed_sstable_exception(format("data file has {} chunks, but the CRC component covers {}", chunk, c.checksums.size()), file_path);
+    }
+}
+
+future<> sstable::validate_checksums(const io_priority_class& pc) {
+    if (!has_component(component_type::CompressionInfo) && !has_component(component_type::CRC)) {
+        sstlog.debug("SSTable {} has no checksums to validate", get_filename());
+        return make_ready_future<>();
+    }
+    return seastar::async([this, &pc] {
+        auto stream = data_stream(0, data_size(), pc, no_resource_tracking(), {});
+        std::exception_ptr ex;
+        try {
+            if (has_component(component_type::CompressionInfo)) {
+                // The compressed source verifies every chunk against the
+                // checksum stored after it as it reads it.
+                while (!stream.read().get0().empty()) {
+                }
+            } else {
+                checksum c;
+                read_simple<component_type::CRC>(c, pc).get();
+                if (_version == sstable_version_types::mc) {
+                    validate_chunk_checksums<crc32_utils>(stream, c, get_filename());
+                } else {
+                    validate_chunk_checksums<adler32_utils>(stream, c, get_filename());
+                }
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        stream.close().get();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    });
+}
+
 future<> sstable::load(sstables::foreign_sstable_open_info info) {
     return read_toc().then([this, info = std::move(info)] () mutable {
         _components = std::move(info.components);
@@ -1973,7 +2065,9 @@ components_writer::components_writer(sstable& sst, const schema& s, file_writer&
     , _tombstone_written(false)
     , _range_tombstones(s)
 {
-    _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::k_l_format);
+    _sst._components->filter = cfg.split_block_filter
+            ? utils::i_filter::get_split_block_filter(estimated_partitions, _schema.bloom_filter_fp_chance())
+            : utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::k_l_format);
     _sst._pi_write.desired_block_size = cfg.promoted_index_block_size.value_or(get_config().column_index_size_in_kb() * 1024);
     _sst._correctly_serialize_non_compound_range_tombstones = cfg.correctly_serialize_non_compound_range_tombstones;
     _index_sampling_state.summary_byte_cost = summary_byte_cost();
@@ -2175,6 +2269,13 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
     _components->scylla_metadata->data.set<scylla_metadata_type::Sharding>(std::move(sm));
     _components->scylla_metadata->data.set<scylla_metadata_type::Features>(std::move(features));
     _components->scylla_metadata->data.set<scylla_metadata_type::RunIdentifier>(std::move(identifier));
+    if (dynamic_cast<const utils::filter::split_block_bloom_filter*>(_components->filter.get())) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::FilterVersion>(filter_version{filter_version::split_block_bloom});
+    }
+    if (!_components->compression.dictionary().empty()) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::CompressionDictionary>(
+                compression_dictionary{disk_string<uint32_t>{_components->compression.dictionary()}});
+    }
 
     write_simple<component_type::Scylla>(*_components->scylla_metadata, pc);
 }
@@ -2708,11 +2809,24 @@ component_type sstable::component_from_sstring(version_types v, sstring &s) {
     }
 }
 
+// Number of buffers a data stream keeps in flight. A long read is sequential
+// by construction, so it gets enough of them to keep the disk busy, while the
+// buffer size itself is adapted to the observed access pattern by the stream
+// history. When memory is short, the read-ahead is limited to the reader's
+// share of the semaphore.
+static unsigned data_read_ahead(uint64_t len, size_t buffer_size, const reader_resource_tracker& resource_tracker) {
+    static constexpr unsigned default_read_ahead = 4;
+    static constexpr unsigned max_read_ahead = 16;
+    auto buffers = std::clamp<uint64_t>(len / buffer_size, default_read_ahead, max_read_ahead);
+    auto budget = resource_tracker.read_ahead_budget() / buffer_size;
+    return std::max<uint64_t>(std::min<uint64_t>(buffers, budget), 1);
+}
+
 input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_priority_class& pc, reader_resource_tracker resource_tracker, lw_shared_ptr<file_input_stream_history> history) {
     file_input_stream_options options;
     options.buffer_size = sstable_buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = 4;
+    options.read_ahead = data_read_ahead(len, sstable_buffer_size, resource_tracker);
     options.dynamic_adjustments = std::move(history);
 
     auto f = resource_tracker.track(_data_file);
@@ -2821,17 +2935,26 @@ future<> sstable::mutate_sstable_level(uint32_t new_level) {
         return make_ready_future<>();
     }
 
-    s.sstable_level = new_level;
+    // The statistics are written from memory, so the level is changed there first.
+    // If the write fails, the file on disk still has the old level, since it is
+    // replaced atomically, and so is the level restored in memory.
+    auto old_level = std::exchange(s.sstable_level, new_level);
     // Technically we don't have to write the whole file again. But the assumption that
     // we will always write sequentially is a powerful one, and this does not merit an
     // exception.
-    return seastar::async([this] {
+    return seastar::async([this, &s, old_level] {
         // This is not part of the standard memtable flush path, but there is no reason
         // to come up with a class just for that. It is used by the snapshot/restore mechanism
         // which comprises mostly hard link creation and this operation at the end + this operation,
         // and also (eventually) by some compaction strategy. In any of the cases, it won't be high
         // priority enough so we will use the default priority
-        rewrite_statistics(default_priority_class());
+        try {
+            rewrite_statistics(default_priority_class());
+        } catch (...) {
+            sstlog.warn("failed to set level of {} to {}, keeping level {}: {}", get_filename(), s.sstable_level, old_level, std::current_exception());
+            s.sstable_level = old_level;
+            throw;
+        }
     });
 }
 
@@ -2854,6 +2977,12 @@ sstable::~sstable() {
             general_disk_error();
         });
     }
+    if (_partition_trie) {
+        _partition_trie->close().handle_exception([save = _partition_trie, op = background_jobs().start()] (auto ep) {
+            sstlog.warn("sstable close partition index failed: {}", ep);
+            general_disk_error();
+        });
+    }
 
     if (_marked_for_deletion) {
         // We need to delete the on-disk files for this table. Since this is a
@@ -3314,6 +3443,14 @@ bool supports_correct_static_compact_in_mc() {
     return bool(service::get_local_storage_service().cluster_supports_correct_static_compact_in_mc());
 }
 
+bool supports_split_block_filter() {
+    return bool(service::get_local_storage_service().cluster_supports_split_block_bloom_filter());
+}
+
+bool writes_partition_trie_index() {
+    return get_config().enable_sstables_partition_index();
+}
+
 }
 
 std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp_type) {
@@ -3331,6 +3468,7 @@ std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp
     case ct::TemporaryTOC: out << "TemporaryTOC"; break;
     case ct::TemporaryStatistics: out << "TemporaryStatistics"; break;
     case ct::Scylla: out << "Scylla"; break;
+    case ct::PartitionIndex: out << "PartitionIndex"; break;
     case ct::Unknown: out << "Unknown"; break;
     }
     return out;
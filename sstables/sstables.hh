@@ -61,6 +61,7 @@
 #include "stats.hh"
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
+#include "sstables/partition_trie.hh"
 
 #include <seastar/util/optimized_optional.hh>
 
@@ -109,6 +110,8 @@ class index_reader;
 
 bool supports_correct_non_compound_range_tombstones();
 bool supports_correct_static_compact_in_mc();
+bool supports_split_block_filter();
+bool writes_partition_trie_index();
 
 struct sstable_writer_config {
     std::optional<size_t> promoted_index_block_size;
@@ -119,6 +122,9 @@ struct sstable_writer_config {
     write_monitor* monitor = &default_write_monitor();
     bool correctly_serialize_non_compound_range_tombstones = supports_correct_non_compound_range_tombstones();
     bool correctly_serialize_static_compact_in_mc = supports_correct_static_compact_in_mc();
+    bool split_block_filter = supports_split_block_filter();
+    // Only respected by the mc format writer.
+    bool partition_trie_index = writes_partition_trie_index();
     utils::UUID run_identifier = utils::make_random_uuid();
 };
 
@@ -196,6 +202,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     future<> load(const io_priority_class& pc = default_priority_class());
     future<> open_data();
     future<> update_info_for_opened_data();
+    // Reads the whole data file and checks it against the checksums written
+    // along with it: those of every compressed chunk, or the CRC component of
+    // an uncompressed sstable. Throws malformed_sstable_exception on mismatch.
+    future<> validate_checksums(const io_priority_class& pc);
 
     future<> set_generation(int64_t generation);
     void move_to_new_dir_in_thread(sstring dir, int64_t generation);
@@ -477,6 +487,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     column_stats _c_stats;
     file _index_file;
     file _data_file;
+    lw_shared_ptr<partition_trie> _partition_trie;
     uint64_t _data_file_size;
     uint64_t _index_file_size;
     uint64_t _filter_file_size = 0;
@@ -711,6 +722,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->filter->is_present(bytes_view(key));
     }
 
+    // Returns the PartitionIndex component, or nullptr if the sstable doesn't have one.
+    const partition_trie* get_partition_trie() const {
+        return _partition_trie.get();
+    }
+
     /*!
      * \brief check if the sstable contains the given key.
      * The method would search that the key is actually
@@ -173,11 +173,13 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
             candidates.erase(boost::remove_if(candidates, is_expired), candidates.end());
         }
 
-        auto compaction_candidates = get_next_non_expired_sstables(cf, std::move(candidates), gc_before);
+        auto desc = get_next_non_expired_sstables(cf, std::move(candidates), gc_before);
         if (!expired.empty()) {
-            compaction_candidates.insert(compaction_candidates.end(), expired.begin(), expired.end());
+            desc.sstables.insert(desc.sstables.end(), expired.begin(), expired.end());
+            // The job now drops whole sstables, not only tombstones.
+            desc.tombstone_compaction = false;
         }
-        return compaction_descriptor(std::move(compaction_candidates));
+        return desc;
     }
 private:
     static timestamp_type
@@ -192,27 +194,29 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
         };
     }
 
-    std::vector<shared_sstable>
+    compaction_descriptor
     get_next_non_expired_sstables(column_family& cf, std::vector<shared_sstable> non_expiring_sstables, gc_clock::time_point gc_before) {
         auto most_interesting = get_compaction_candidates(cf, non_expiring_sstables);
 
         if (!most_interesting.empty()) {
-            return most_interesting;
+            return compaction_descriptor(std::move(most_interesting));
         }
 
         // if there is no sstable to compact in standard way, try compacting single sstable whose droppable tombstone
         // ratio is greater than threshold.
-        auto e = boost::range::remove_if(non_expiring_sstables, [this, &gc_before] (const shared_sstable& sst) -> bool {
-            return !worth_dropping_tombstones(sst, gc_before);
+        auto e = boost::range::remove_if(non_expiring_sstables, [this, &cf, &gc_before] (const shared_sstable& sst) -> bool {
+            return !worth_dropping_tombstones(cf, sst, gc_before);
         });
         non_expiring_sstables.erase(e, non_expiring_sstables.end());
         if (non_expiring_sstables.empty()) {
-            return {};
+            return compaction_descriptor(std::vector<shared_sstable>());
         }
         auto it = boost::min_element(non_expiring_sstables, [] (auto& i, auto& j) {
             return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
         });
-        return { *it };
+        auto desc = compaction_descriptor({ *it });
+        desc.tombstone_compaction = true;
+        return desc;
     }
 
     std::vector<shared_sstable> get_compaction_candidates(column_family& cf, std::vector<shared_sstable> candidate_sstables) {
@@ -498,6 +498,8 @@ enum class scylla_metadata_type : uint32_t {
     Features = 2,
     ExtensionAttributes = 3,
     RunIdentifier = 4,
+    CompressionDictionary = 5,
+    FilterVersion = 6,
 };
 
 struct run_identifier {
@@ -509,6 +511,27 @@ struct run_identifier {
     auto describe_type(sstable_version_types v, Describer f) { return f(id); }
 };
 
+// Scylla-specific dictionary the chunks of a compressed Data component
+// were compressed with. Only present for compressors that train one.
+struct compression_dictionary {
+    disk_string<uint32_t> dictionary;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(dictionary); }
+};
+
+// Scylla-specific format of the Filter component. When absent, the
+// component holds a Cassandra compatible murmur3 bloom filter.
+struct filter_version {
+    static constexpr uint32_t murmur3_bloom = 0;
+    static constexpr uint32_t split_block_bloom = 1;
+
+    uint32_t version;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(version); }
+};
+
 struct scylla_metadata {
     using extension_attributes = disk_hash<uint32_t, disk_string<uint32_t>, disk_string<uint32_t>>;
 
@@ -516,7 +539,9 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Sharding, sharding_metadata>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Features, sstable_enabled_features>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ExtensionAttributes, extension_attributes>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::RunIdentifier, run_identifier>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::RunIdentifier, run_identifier>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::CompressionDictionary, compression_dictionary>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::FilterVersion, filter_version>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -544,6 +569,12 @@ struct scylla_metadata {
         auto* m = data.get<scylla_metadata_type::RunIdentifier, run_identifier>();
         return m ? std::make_optional(m->id) : std::nullopt;
     }
+    const compression_dictionary* get_compression_dictionary() const {
+        return data.get<scylla_metadata_type::CompressionDictionary, compression_dictionary>();
+    }
+    const filter_version* get_filter_version() const {
+        return data.get<scylla_metadata_type::FilterVersion, filter_version>();
+    }
 
     template <typename Describer>
     auto describe_type(sstable_version_types v, Describer f) { return f(data); }
@@ -66,6 +66,8 @@
 #include <boost/range/adaptor/map.hpp>
 #include "../db/view/view_update_generator.hh"
 #include "mutation_source_metadata.hh"
+#include <seastar/core/fstream.hh>
+#include <boost/range/adaptor/reversed.hpp>
 
 namespace streaming {
 
@@ -101,6 +103,147 @@ static auto get_session(utils::UUID plan_id, gms::inet_address from, const char*
     return coordinator->get_or_create_session(from);
 }
 
+future<> stream_session::write_streamed_reader(flat_mutation_reader reader, uint64_t estimated_partitions, stream_reason reason) {
+    auto& cf = get_local_db().find_column_family(reader.schema());
+    return db::view::check_needs_view_update_path(_sys_dist_ks->local(), cf, reason).then([cf = cf.shared_from_this(), estimated_partitions, reader = std::move(reader)] (bool use_view_update_path) mutable {
+        //FIXME: for better estimations this should be transmitted from remote
+        auto metadata = mutation_source_metadata{};
+        auto& cs = cf->get_compaction_strategy();
+        const auto adjusted_estimated_partitions = cs.adjust_partition_estimate(metadata, estimated_partitions);
+        auto consumer = cf->get_compaction_strategy().make_interposer_consumer(metadata,
+                [cf = std::move(cf), adjusted_estimated_partitions, use_view_update_path] (flat_mutation_reader reader) {
+            sstables::shared_sstable sst = use_view_update_path ? cf->make_streaming_staging_sstable() : cf->make_streaming_sstable_for_write();
+            schema_ptr s = reader.schema();
+            auto& pc = service::get_local_streaming_write_priority();
+
+            return sst->write_components(std::move(reader), std::max(1ul, adjusted_estimated_partitions), s,
+                                         sstables::sstable_writer_config{}, encoding_stats{}, pc).then([sst] {
+                return sst->open_data();
+            }).then([cf, sst] {
+                return cf->add_sstable_and_update_cache(sst);
+            }).then([cf, s, sst, use_view_update_path]() mutable -> future<> {
+                if (!use_view_update_path) {
+                    return make_ready_future<>();
+                }
+                return _view_update_generator->local().register_staging_sstable(sst, std::move(cf));
+            });
+        });
+        return consumer(std::move(reader));
+    });
+}
+
+// Writes the components of an sstable sent with STREAM_SSTABLE_FILES to dir.
+// The TOC comes first and is written as a temporary TOC, which is renamed
+// only after all components are written and synced, so that an sstable
+// which was received partially is removed on restart.
+future<> stream_session::receive_sstable_files(sstable_file_source source, schema_ptr s, sstring dir, int64_t generation,
+        sstables::sstable_version_types version) {
+    return seastar::async([source = std::move(source), s, dir, generation, version] () mutable {
+        auto sstable_format = sstables::sstable::format_types::big;
+        auto toc = sstables::sstable_version_constants::get_component_map(version).at(sstables::component_type::TOC);
+        std::vector<sstring> files;
+        std::optional<output_stream<char>> out;
+        sstring component;
+        uint64_t size = 0;
+        uint64_t received = 0;
+        auto close_component = [&] {
+            if (!out) {
+                return;
+            }
+            out->flush().get();
+            auto o = std::move(*out);
+            out = {};
+            o.close().get();
+            if (received != size) {
+                throw std::runtime_error(format("Received {} bytes of sstable component {}, expected {}", received, component, size));
+            }
+        };
+        try {
+            while (auto element = source().get0()) {
+                auto& [name, total, chunk] = *element;
+                if (!out || name != component) {
+                    close_component();
+                    if (files.empty() != (name == toc) || name.find('/') != sstring::npos) {
+                        throw std::runtime_error(format("Unexpected sstable component {}", name));
+                    }
+                    auto filename = name == toc
+                            ? sstables::sstable::filename(dir, s->ks_name(), s->cf_name(), version, generation, sstable_format, sstables::component_type::TemporaryTOC)
+                            : sstables::sstable::filename(dir, s->ks_name(), s->cf_name(), version, generation, sstable_format, name);
+                    files.push_back(filename);
+                    auto f = open_file_dma(filename, open_flags::wo | open_flags::create | open_flags::exclusive).get0();
+                    file_output_stream_options options;
+                    options.io_priority_class = service::get_local_streaming_write_priority();
+                    out.emplace(make_file_output_stream(std::move(f), std::move(options)));
+                    component = name;
+                    size = total;
+                    received = 0;
+                }
+                received += chunk.size();
+                if (received > size) {
+                    throw std::runtime_error(format("Received more than {} bytes of sstable component {}", size, component));
+                }
+                out->write(reinterpret_cast<const char*>(chunk.data()), chunk.size()).get();
+            }
+            close_component();
+            if (files.empty()) {
+                throw std::runtime_error("No sstable components received");
+            }
+            sync_directory(dir).get();
+            rename_file(files.front(), sstables::sstable::filename(dir, s->ks_name(), s->cf_name(), version, generation, sstable_format, toc)).get();
+            sync_directory(dir).get();
+        } catch (...) {
+            if (out) {
+                out->close().handle_exception([] (std::exception_ptr) { }).get();
+            }
+            // The temporary TOC is removed last.
+            for (auto& file : files | boost::adaptors::reversed) {
+                remove_file(file).handle_exception([] (std::exception_ptr) { }).get();
+            }
+            throw;
+        }
+    });
+}
+
+future<> stream_session::add_received_sstable(lw_shared_ptr<table> cf, sstring dir, int64_t generation, sstables::sstable_version_types version,
+        stream_reason reason, bool use_view_update_path) {
+    auto sst = cf->make_sstable(dir, generation, version, sstables::sstable::format_types::big);
+    return sst->load(service::get_local_streaming_read_priority()).then([sst] {
+        // The data file was copied verbatim, so check it against the checksums
+        // that came with it before it is linked into the table. On failure the
+        // sender falls back to streaming the sstable as mutation fragments.
+        return sst->validate_checksums(service::get_local_streaming_read_priority());
+    }).then([sst] {
+        // The level was assigned by the sender's compaction strategy.
+        return sst->get_sstable_level() ? sst->mutate_sstable_level(0) : make_ready_future<>();
+    }).handle_exception([sst] (std::exception_ptr ep) {
+        sst->mark_for_deletion();
+        return make_exception_future<>(ep);
+    }).then([cf, sst, reason, use_view_update_path] () mutable {
+        auto& shards = sst->get_shards_for_this_sstable();
+        if (shards.size() == 1 && shards.front() == engine().cpu_id()) {
+            return cf->add_sstable_and_update_cache(sst).then([cf, sst, use_view_update_path] () mutable -> future<> {
+                if (!use_view_update_path) {
+                    return make_ready_future<>();
+                }
+                return _view_update_generator->local().register_staging_sstable(sst, std::move(cf));
+            });
+        }
+        // The sstable spans several shards of this node, so it is rewritten
+        // like streamed mutation fragments are, and removed afterwards.
+        sslog.debug("Rewriting received sstable {} owned by shards {}", sst->get_filename(), shards);
+        auto s = cf->schema();
+        return mutation_writer::distribute_reader_and_consume_on_shards(s, dht::global_partitioner(),
+                sst->read_range_rows_flat(s, query::full_partition_range, s->full_slice(), service::get_local_streaming_read_priority()),
+                [estimated_partitions = sst->get_estimated_key_count(), reason] (flat_mutation_reader reader) {
+                    return write_streamed_reader(std::move(reader), estimated_partitions, reason);
+                },
+                cf->stream_in_progress()
+        ).discard_result().finally([sst] {
+            sst->mark_for_deletion();
+        });
+    });
+}
+
 void stream_session::init_messaging_service_handler() {
     ms().register_prepare_message([] (const rpc::client_info& cinfo, prepare_message msg, UUID plan_id, sstring description, rpc::optional<stream_reason> reason_opt) {
         const auto& src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
@@ -188,33 +331,8 @@ void stream_session::init_messaging_service_handler() {
                     };
                     mutation_writer::distribute_reader_and_consume_on_shards(s, dht::global_partitioner(),
                         make_generating_reader(s, std::move(get_next_mutation_fragment)),
-                        [plan_id, estimated_partitions, reason] (flat_mutation_reader reader) {
-                            auto& cf = get_local_db().find_column_family(reader.schema());
-                            return db::view::check_needs_view_update_path(_sys_dist_ks->local(), cf, reason).then([cf = cf.shared_from_this(), estimated_partitions, reader = std::move(reader)] (bool use_view_update_path) mutable {
-                                //FIXME: for better estimations this should be transmitted from remote
-                                auto metadata = mutation_source_metadata{};
-                                auto& cs = cf->get_compaction_strategy();
-                                const auto adjusted_estimated_partitions = cs.adjust_partition_estimate(metadata, estimated_partitions);
-                                auto consumer = cf->get_compaction_strategy().make_interposer_consumer(metadata,
-                                        [cf = std::move(cf), adjusted_estimated_partitions, use_view_update_path] (flat_mutation_reader reader) {
-                                    sstables::shared_sstable sst = use_view_update_path ? cf->make_streaming_staging_sstable() : cf->make_streaming_sstable_for_write();
-                                    schema_ptr s = reader.schema();
-                                    auto& pc = service::get_local_streaming_write_priority();
-
-                                    return sst->write_components(std::move(reader), std::max(1ul, adjusted_estimated_partitions), s,
-                                                                 sstables::sstable_writer_config{}, encoding_stats{}, pc).then([sst] {
-                                        return sst->open_data();
-                                    }).then([cf, sst] {
-                                        return cf->add_sstable_and_update_cache(sst);
-                                    }).then([cf, s, sst, use_view_update_path]() mutable -> future<> {
-                                        if (!use_view_update_path) {
-                                            return make_ready_future<>();
-                                        }
-                                        return _view_update_generator->local().register_staging_sstable(sst, std::move(cf));
-                                    });
-                                });
-                                return consumer(std::move(reader));
-                            });
+                        [estimated_partitions, reason] (flat_mutation_reader reader) {
+                            return write_streamed_reader(std::move(reader), estimated_partitions, reason);
                         },
                         cf.stream_in_progress()
                     ).then_wrapped([s, plan_id, from, sink, estimated_partitions] (future<uint64_t> f) mutable {
@@ -240,6 +358,57 @@ void stream_session::init_messaging_service_handler() {
                 });
         });
     });
+    ms().register_stream_sstable_files([] (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring version, dht::token first_token,
+            stream_reason reason, rpc::source<sstring, uint64_t, bytes> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        if (!_sys_dist_ks->local_is_initialized() || !_view_update_generator->local_is_initialized()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address())));
+        }
+        return with_scheduling_group(service::get_local_storage_service().db().local().get_streaming_scheduling_group(), [=] () mutable {
+            return service::get_schema_for_write(schema_id, from).then([=] (schema_ptr s) mutable {
+                auto sink = ms().make_sink_for_stream_sstable_files(source);
+                auto cf = get_local_db().find_column_family(cf_id).shared_from_this();
+                // The sstable is written to the shard which owns its first
+                // token, which is the only owner in the common case.
+                auto shard = dht::global_partitioner().shard_of(first_token);
+                db::view::check_needs_view_update_path(_sys_dist_ks->local(), *cf, reason).then([=] (bool use_view_update_path) mutable {
+                    auto dir = cf->dir() + (use_view_update_path ? "/staging" : "");
+                    auto v = sstables::from_string(version);
+                    return smp::submit_to(shard, [cf_id] {
+                        return get_local_db().find_column_family(cf_id).calculate_generation_for_new_table();
+                    }).then([=] (int64_t generation) mutable {
+                        auto chunks = [source, plan_id, from] () mutable {
+                            return source().then([plan_id, from] (std::optional<sstable_file_chunk> chunk) {
+                                if (chunk) {
+                                    streaming::get_local_stream_manager().update_progress(plan_id, from.addr, progress_info::direction::IN, std::get<2>(*chunk).size());
+                                }
+                                return chunk;
+                            });
+                        };
+                        return receive_sstable_files(std::move(chunks), s, dir, generation, v).then([=] {
+                            return smp::submit_to(shard, [=] {
+                                return add_received_sstable(get_local_db().find_column_family(cf_id).shared_from_this(), dir, generation, v, reason, use_view_update_path);
+                            });
+                        });
+                    });
+                }).then_wrapped([s, plan_id, from, sink] (future<> f) mutable {
+                    int32_t status = 0;
+                    if (f.failed()) {
+                        sslog.warn("[Stream #{}] Failed to receive sstable files for ks={}, cf={}, peer={}: {}", plan_id, s->ks_name(), s->cf_name(), from.addr, f.get_exception());
+                        status = -1;
+                    }
+                    return sink(status).finally([sink] () mutable {
+                        return sink.close();
+                    });
+                }).handle_exception([s, plan_id, from, sink] (std::exception_ptr ep) {
+                    sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES for ks={}, cf={}, peer={}: {}", plan_id, s->ks_name(), s->cf_name(), from.addr, ep);
+                });
+                return make_ready_future<rpc::sink<int>>(sink);
+            });
+        });
+    });
     ms().register_stream_mutation_done([] (const rpc::client_info& cinfo, UUID plan_id, dht::token_range_vector ranges, UUID cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return smp::submit_to(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] () mutable {
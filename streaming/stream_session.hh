@@ -55,9 +55,14 @@
 #include "query-request.hh"
 #include "dht/i_partitioner.hh"
 #include "db/system_distributed_keyspace.hh"
+#include "flat_mutation_reader.hh"
+#include "sstables/version.hh"
 #include <map>
 #include <vector>
 #include <memory>
+#include <optional>
+
+class table;
 
 namespace db::view {
 
@@ -143,6 +148,8 @@ class stream_session : public enable_shared_from_this<stream_session> {
     using token = dht::token;
     using ring_position = dht::ring_position;
     static void init_messaging_service_handler();
+    // Writes streamed data to sstables of the shard the reader is consumed on.
+    static future<> write_streamed_reader(flat_mutation_reader reader, uint64_t estimated_partitions, stream_reason reason);
     static distributed<database>* _db;
     static distributed<db::system_distributed_keyspace>* _sys_dist_ks;
     static distributed<db::view::view_update_generator>* _view_update_generator;
@@ -153,6 +160,19 @@ class stream_session : public enable_shared_from_this<stream_session> {
     static database& get_local_db() { return _db->local(); }
     static distributed<database>& get_db() { return *_db; };
     static future<> init_streaming_service(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks, distributed<db::view::view_update_generator>& view_update_generator);
+
+    // A chunk of an sstable component sent with STREAM_SSTABLE_FILES: the
+    // component name, its total size and the data.
+    using sstable_file_chunk = std::tuple<sstring, uint64_t, bytes>;
+    using sstable_file_source = noncopyable_function<future<std::optional<sstable_file_chunk>> ()>;
+    // Writes the components of an sstable read from source to dir, under the
+    // given generation.
+    static future<> receive_sstable_files(sstable_file_source source, schema_ptr s, sstring dir, int64_t generation,
+            sstables::sstable_version_types version);
+    // Adds an sstable received by STREAM_SSTABLE_FILES to the table, or splits
+    // it between shards if it doesn't belong to this shard only.
+    static future<> add_received_sstable(lw_shared_ptr<table> cf, sstring dir, int64_t generation, sstables::sstable_version_types version,
+            stream_reason reason, bool use_view_update_path);
 public:
     /**
      * Streaming endpoint.
@@ -55,6 +55,8 @@
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
 #include "database.hh"
+#include "db/config.hh"
+#include <seastar/core/fstream.hh>
 
 namespace streaming {
 
@@ -90,10 +92,17 @@ struct send_info {
     column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sstables which are sent as files, see send_sstable_files().
+    struct sstable_to_send {
+        sstables::shared_sstable sst;
+        std::vector<sstable_component_file> components;
+    };
+    bool stream_sstable_files;
+    std::vector<sstable_to_send> sstables_to_send;
     flat_mutation_reader reader;
     send_info(database& db_, utils::UUID plan_id_, utils::UUID cf_id_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
-              uint32_t dst_cpu_id_, stream_reason reason_)
+              uint32_t dst_cpu_id_, stream_reason reason_, bool stream_sstable_files_ = false)
         : db(db_)
         , plan_id(plan_id_)
         , cf_id(cf_id_)
@@ -103,7 +112,72 @@ struct send_info {
         , cf(db.find_column_family(cf_id))
         , ranges(std::move(ranges_))
         , prs(to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), prs)) {
+        , stream_sstable_files(stream_sstable_files_)
+        , reader(make_reader()) {
+    }
+    // An sstable can be sent as is if all of its data falls into the streamed
+    // ranges and it belongs to this shard only.
+    std::vector<sstables::shared_sstable> select_sstables_to_send() const {
+        std::vector<sstables::shared_sstable> ret;
+        for (auto& sst : *cf.get_sstables()) {
+            if (sst->is_shared()) {
+                continue;
+            }
+            auto sst_range = dht::token_range::make(sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token());
+            if (std::any_of(ranges.begin(), ranges.end(), [&sst_range] (const dht::token_range& range) {
+                return range.contains(sst_range, dht::token_comparator());
+            })) {
+                ret.push_back(sst);
+            }
+        }
+        return ret;
+    }
+    // Picks the sstables which are sent as files and opens their components
+    // right away, then recreates the reader so that it skips them. An sstable
+    // which is deleted by compaction before it is opened is left to the
+    // reader, which reads the sstables compaction wrote instead.
+    future<> open_sstables_to_send() {
+        if (!stream_sstable_files) {
+            return make_ready_future<>();
+        }
+        return do_with(select_sstables_to_send(), [this] (std::vector<sstables::shared_sstable>& candidates) {
+            return do_for_each(candidates, [this] (sstables::shared_sstable& sst) {
+                return open_sstable_components(sst).then_wrapped([this, sst] (future<std::vector<sstable_component_file>> f) {
+                    if (f.failed()) {
+                        sslog.debug("[Stream #{}] Streaming sstable {} as mutation fragments, failed to open it: {}", plan_id, sst->get_filename(), f.get_exception());
+                        return;
+                    }
+                    sstables_to_send.push_back(sstable_to_send{sst, f.get0()});
+                });
+            });
+        }).then([this] {
+            if (!sstables_to_send.empty()) {
+                reader = make_reader();
+            }
+        });
+    }
+    // Puts sstables which the receiver failed to take as files back into the
+    // reader, so that their data is streamed as mutation fragments instead.
+    void fall_back_to_mutation_fragments(const std::vector<sstables::shared_sstable>& failed) {
+        if (failed.empty()) {
+            return;
+        }
+        sstables_to_send.erase(std::remove_if(sstables_to_send.begin(), sstables_to_send.end(), [&failed] (const sstable_to_send& s) {
+            return std::find(failed.begin(), failed.end(), s.sst) != failed.end();
+        }), sstables_to_send.end());
+        reader = make_reader();
+    }
+    // Reads everything but the sstables which are sent as files.
+    flat_mutation_reader make_reader() {
+        if (sstables_to_send.empty()) {
+            return cf.make_streaming_reader(cf.schema(), prs);
+        }
+        std::vector<sstables::shared_sstable> excluded;
+        excluded.reserve(sstables_to_send.size());
+        for (auto& s : sstables_to_send) {
+            excluded.push_back(s.sst);
+        }
+        return cf.make_streaming_reader(cf.schema(), prs, std::move(excluded));
     }
     future<bool> has_relevant_range_on_this_shard() {
         return do_with(false, [this] (bool& found_relevant_range) {
@@ -173,30 +247,32 @@ future<> send_mutations(lw_shared_ptr<send_info> si) {
     });
 }
 
+static future<> receive_status(lw_shared_ptr<send_info> si, rpc::source<int32_t> source, lw_shared_ptr<bool> got_error_from_peer) {
+    return repeat([source, got_error_from_peer, si] () mutable {
+        return source().then([source, got_error_from_peer, si] (std::optional<std::tuple<int32_t>> status_opt) mutable {
+            if (status_opt) {
+                auto status = std::get<0>(*status_opt);
+                *got_error_from_peer = status == -1;
+                sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
+                // we've got an error from the other side, but we cannot just abandon rpc::source we
+                // need to continue reading until EOS since this will signal that no more work
+                // is left and rpc::source can be destroyed. The sender closes connection immediately
+                // after sending the status, so EOS should arrive shortly.
+                return stop_iteration::no;
+            } else {
+                return stop_iteration::yes;
+            }
+        });
+    });
+}
+
 future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
   return si->estimate_partitions().then([si] (size_t estimated_partitions) {
     sslog.info("[Stream #{}] Start sending ks={}, cf={}, estimated_partitions={}, with new rpc streaming", si->plan_id, si->cf.schema()->ks_name(), si->cf.schema()->cf_name(), estimated_partitions);
     return netw::get_local_messaging_service().make_sink_and_source_for_stream_mutation_fragments(si->reader.schema()->version(), si->plan_id, si->cf_id, estimated_partitions, si->reason, si->id).then([si] (rpc::sink<frozen_mutation_fragment> sink, rpc::source<int32_t> source) mutable {
         auto got_error_from_peer = make_lw_shared<bool>(false);
 
-        auto source_op = [source, got_error_from_peer, si] () mutable -> future<> {
-            return repeat([source, got_error_from_peer, si] () mutable {
-                return source().then([source, got_error_from_peer, si] (std::optional<std::tuple<int32_t>> status_opt) mutable {
-                    if (status_opt) {
-                        auto status = std::get<0>(*status_opt);
-                        *got_error_from_peer = status == -1;
-                        sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
-                        // we've got an error from the other side, but we cannot just abandon rpc::source we
-                        // need to continue reading until EOS since this will signal that no more work
-                        // is left and rpc::source can be destroyed. The sender closes connection immediately
-                        // after sending the status, so EOS should arrive shortly.
-                        return stop_iteration::no;
-                    } else {
-                        return stop_iteration::yes;
-                    }
-                });
-            });
-        }();
+        auto source_op = receive_status(si, source, got_error_from_peer);
 
         auto sink_op = [sink, si, got_error_from_peer] () mutable -> future<> {
             return do_with(std::move(sink), [si, got_error_from_peer] (rpc::sink<frozen_mutation_fragment>& sink) {
@@ -226,6 +302,134 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
   });
 }
 
+future<std::vector<sstable_component_file>> open_sstable_components(sstables::shared_sstable sst) {
+    std::vector<sstring> names;
+    for (auto& c : sst->all_components()) {
+        if (c.first == sstables::component_type::TOC) {
+            names.insert(names.begin(), c.second);
+        } else {
+            names.push_back(c.second);
+        }
+    }
+    return do_with(std::move(names), std::vector<sstable_component_file>(), [sst] (std::vector<sstring>& names, std::vector<sstable_component_file>& files) {
+        return do_for_each(names, [sst, &files] (const sstring& name) {
+            auto s = sst->get_schema();
+            auto filename = sstables::sstable::filename(sst->get_dir(), s->ks_name(), s->cf_name(), sst->get_version(), sst->generation(),
+                    sstables::sstable::format_types::big, name);
+            return open_file_dma(filename, open_flags::ro).then([&files, name] (file f) {
+                files.push_back(sstable_component_file{name, std::move(f)});
+            });
+        }).then_wrapped([&files] (future<> f) {
+            if (!f.failed()) {
+                return make_ready_future<std::vector<sstable_component_file>>(std::move(files));
+            }
+            auto ep = f.get_exception();
+            return parallel_for_each(files, [] (sstable_component_file& c) {
+                return c.f.close().handle_exception([] (std::exception_ptr) { });
+            }).then([ep = std::move(ep)] () mutable {
+                return make_exception_future<std::vector<sstable_component_file>>(std::move(ep));
+            });
+        });
+    });
+}
+
+future<> send_sstable_components(std::vector<sstable_component_file> components,
+        noncopyable_function<future<stop_iteration> (const sstring& name, uint64_t size, bytes chunk)> consumer) {
+    return do_with(std::move(components), std::move(consumer), false, [] (std::vector<sstable_component_file>& components, auto& consumer, bool& stopped) {
+        return do_for_each(components, [&consumer, &stopped] (sstable_component_file& c) {
+            if (stopped) {
+                return make_ready_future<>();
+            }
+            return c.f.size().then([&c, &consumer, &stopped] (uint64_t size) {
+                if (!size) {
+                    // Let the receiver create the empty file.
+                    return consumer(c.name, size, bytes()).then([&stopped] (stop_iteration stop) {
+                        stopped = bool(stop);
+                    });
+                }
+                file_input_stream_options options;
+                options.buffer_size = 128 * 1024;
+                options.read_ahead = 1;
+                options.io_priority_class = service::get_local_streaming_read_priority();
+                return do_with(make_file_input_stream(c.f, 0, size, std::move(options)), [&c, &consumer, &stopped, size] (input_stream<char>& in) {
+                    return repeat([&c, &consumer, &stopped, &in, size] {
+                        return in.read().then([&c, &consumer, &stopped, size] (temporary_buffer<char> buf) {
+                            if (buf.empty()) {
+                                return make_ready_future<stop_iteration>(stop_iteration::yes);
+                            }
+                            return consumer(c.name, size, bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size())).then([&stopped] (stop_iteration stop) {
+                                stopped = bool(stop);
+                                return stop;
+                            });
+                        });
+                    }).finally([&in] {
+                        return in.close();
+                    });
+                });
+            });
+        }).finally([&components] {
+            return parallel_for_each(components, [] (sstable_component_file& c) {
+                return c.f.close().handle_exception([] (std::exception_ptr) { });
+            });
+        });
+    });
+}
+
+// Sends all components of the sstable, the TOC first. The receiver writes
+// the TOC as a temporary TOC, so that an sstable which is received only
+// partially is removed on restart.
+static future<> send_sstable(lw_shared_ptr<send_info> si, sstables::shared_sstable sst, std::vector<sstable_component_file> components) {
+    sslog.debug("[Stream #{}] Sending sstable {} as files to {}", si->plan_id, sst->get_filename(), si->id);
+    return netw::get_local_messaging_service().make_sink_and_source_for_stream_sstable_files(si->cf.schema()->version(), si->plan_id, si->cf_id,
+            sstables::to_string(sst->get_version()), sst->get_first_decorated_key().token(), si->reason, si->id).then(
+            [si, sst, components = std::move(components)] (rpc::sink<sstring, uint64_t, bytes> sink, rpc::source<int32_t> source) mutable {
+        auto got_error_from_peer = make_lw_shared<bool>(false);
+
+        auto source_op = receive_status(si, source, got_error_from_peer);
+
+        auto sink_op = do_with(std::move(sink), [si, components = std::move(components), got_error_from_peer] (rpc::sink<sstring, uint64_t, bytes>& sink) mutable {
+            return send_sstable_components(std::move(components), [si, &sink, got_error_from_peer] (const sstring& name, uint64_t size, bytes chunk) {
+                if (*got_error_from_peer) {
+                    return make_ready_future<stop_iteration>(stop_iteration::yes);
+                }
+                streaming::get_local_stream_manager().update_progress(si->plan_id, si->id.addr, streaming::progress_info::direction::OUT, chunk.size());
+                return sink(name, size, std::move(chunk)).then([] {
+                    return stop_iteration::no;
+                });
+            }).finally([&sink] () mutable {
+                return sink.close();
+            });
+        });
+
+        return when_all_succeed(std::move(source_op), std::move(sink_op)).then([got_error_from_peer, si, sst] {
+            if (*got_error_from_peer) {
+                throw std::runtime_error(format("Peer failed to process sstable files peer={}, plan_id={}, cf_id={}, sstable={}", si->id.addr, si->plan_id, si->cf_id, sst->get_filename()));
+            }
+        });
+    });
+}
+
+// Sstables which only hold data of the streamed ranges are sent as they are,
+// rather than being read and written again by the receiver.
+future<> send_sstable_files(lw_shared_ptr<send_info> si) {
+    if (!si->sstables_to_send.empty()) {
+        sslog.info("[Stream #{}] Start sending ks={}, cf={}, {} sstables as files", si->plan_id, si->cf.schema()->ks_name(), si->cf.schema()->cf_name(),
+                si->sstables_to_send.size());
+    }
+    auto failed = make_lw_shared<std::vector<sstables::shared_sstable>>();
+    return do_for_each(si->sstables_to_send, [si, failed] (send_info::sstable_to_send& s) {
+        auto sst = s.sst;
+        return send_sstable(si, sst, std::move(s.components)).handle_exception([si, sst, failed] (std::exception_ptr ep) {
+            // The receiver rejects an sstable whose data does not match its
+            // checksums, and removes whatever it got of it.
+            sslog.warn("[Stream #{}] Failed to send sstable {} as files, streaming it as mutation fragments: {}", si->plan_id, sst->get_filename(), ep);
+            failed->push_back(sst);
+        });
+    }).then([si, failed] {
+        si->fall_back_to_mutation_fragments(*failed);
+    });
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -234,9 +438,11 @@ future<> stream_transfer_task::execute() {
     sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}", plan_id, cf_id);
     sort_and_merge_ranges();
     bool streaming_with_rpc_stream = service::get_local_storage_service().cluster_supports_stream_with_rpc_stream();
+    bool stream_sstable_files = streaming_with_rpc_stream && service::get_local_storage_service().cluster_supports_stream_sstable_files();
     auto reason = session->get_reason();
-    return session->get_db().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, streaming_with_rpc_stream, reason] (database& db) {
-        auto si = make_lw_shared<send_info>(db, plan_id, cf_id, std::move(ranges), id, dst_cpu_id, reason);
+    return session->get_db().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, streaming_with_rpc_stream, stream_sstable_files, reason] (database& db) {
+        auto si = make_lw_shared<send_info>(db, plan_id, cf_id, std::move(ranges), id, dst_cpu_id, reason,
+                stream_sstable_files && db.get_config().enable_sstable_file_streaming());
         return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id, streaming_with_rpc_stream] (bool has_relevant_range_on_this_shard) {
             if (!has_relevant_range_on_this_shard) {
                 sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
@@ -244,7 +450,11 @@ future<> stream_transfer_task::execute() {
                 return make_ready_future<>();
             }
             if (streaming_with_rpc_stream) {
-                return send_mutation_fragments(std::move(si));
+                return si->open_sstables_to_send().then([si] {
+                    return send_sstable_files(si);
+                }).then([si] {
+                    return send_mutation_fragments(si);
+                });
             } else {
                 return send_mutations(std::move(si));
             }
@@ -41,14 +41,35 @@
 #include "utils/UUID.hh"
 #include "streaming/stream_task.hh"
 #include "streaming/stream_detail.hh"
+#include "sstables/shared_sstable.hh"
+#include "bytes.hh"
 #include <map>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/file.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 namespace streaming {
 
 class stream_session;
 class send_info;
 
+// A component of an sstable sent with STREAM_SSTABLE_FILES. The components
+// are opened when the sstable is picked for sending, so that they can still
+// be read if compaction deletes the sstable before it is sent.
+struct sstable_component_file {
+    sstring name;
+    file f;
+};
+
+// Opens all components of the sstable, the TOC first.
+future<std::vector<sstable_component_file>> open_sstable_components(sstables::shared_sstable sst);
+
+// Passes the contents of the components to consumer in chunks, together with
+// the component name and size, and closes the files. Stops early if consumer
+// returns stop_iteration::yes.
+future<> send_sstable_components(std::vector<sstable_component_file> components,
+        noncopyable_function<future<stop_iteration> (const sstring& name, uint64_t size, bytes chunk)> consumer);
+
 /**
  * StreamTransferTask sends sections of SSTable files in certain ColumnFamily.
  */
@@ -510,6 +510,51 @@ table::make_streaming_reader(schema_ptr s,
     return make_flat_multi_range_reader(s, std::move(source), ranges, slice, pc, nullptr, mutation_reader::forwarding::no);
 }
 
+flat_mutation_reader
+table::make_streaming_reader(schema_ptr s, const dht::partition_range_vector& ranges, std::vector<sstables::shared_sstable> excluded) const {
+    auto& slice = s->full_slice();
+    auto& pc = service::get_local_streaming_read_priority();
+
+    auto source = mutation_source([this, excluded = std::move(excluded)] (schema_ptr s, const dht::partition_range& range, const query::partition_slice& slice,
+                                      const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
+        auto sstables = make_lw_shared<sstables::sstable_set>(*_sstables);
+        for (auto& sst : excluded) {
+            if (sstables->all()->count(sst)) {
+                sstables->erase(sst);
+            }
+        }
+        std::vector<flat_mutation_reader> readers;
+        readers.reserve(_memtables->size() + 1);
+        for (auto&& mt : *_memtables) {
+            readers.emplace_back(mt->make_flat_reader(s, range, slice, pc, trace_state, fwd, fwd_mr));
+        }
+        readers.emplace_back(make_sstable_reader(s, sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        return make_combined_reader(s, std::move(readers), fwd, fwd_mr);
+    });
+
+    return make_flat_multi_range_reader(s, std::move(source), ranges, slice, pc, nullptr, mutation_reader::forwarding::no);
+}
+
+future<bool> table::has_memtable_data(const dht::partition_range& range) const {
+    if (!_streaming_memtables_big.empty()) {
+        // Big partitions which are being streamed are added to the table
+        // only once the stream is done.
+        return make_ready_future<bool>(true);
+    }
+    std::vector<flat_mutation_reader> readers;
+    for (auto&& mt : *_memtables) {
+        readers.emplace_back(mt->make_flat_reader(_schema, range));
+    }
+    for (auto&& mt : *_streaming_memtables) {
+        readers.emplace_back(mt->make_flat_reader(_schema, range));
+    }
+    return do_with(make_combined_reader(_schema, std::move(readers)), [] (flat_mutation_reader& reader) {
+        return reader(db::no_timeout).then([] (mutation_fragment_opt mf) {
+            return bool(mf);
+        });
+    });
+}
+
 flat_mutation_reader table::make_streaming_reader(schema_ptr schema, const dht::partition_range& range,
         const query::partition_slice& slice, mutation_reader::forwarding fwd_mr) const {
     const auto& pc = service::get_local_streaming_read_priority();
@@ -1004,6 +1049,7 @@ table::stop() {
     }
     return _async_gate.close().then([this] {
         return when_all(await_pending_writes(), await_pending_reads(), await_pending_streams()).discard_result().finally([this] {
+            _view_update_coalescer.flush();
             return when_all(_memtables->request_flush(), _streaming_memtables->request_flush()).discard_result().finally([this] {
                 return _compaction_manager.remove(this).then([this] {
                     // Nest, instead of using when_all, so we don't lose any exceptions.
@@ -1111,6 +1157,9 @@ void table::set_metrics() {
                     ms::make_total_operations("view_updates_pushed_local", _view_stats.view_updates_pushed_local, ms::description("Number of updates (mutations) pushed to local view replicas"))(cf)(ks),
                     ms::make_total_operations("view_updates_failed_local", _view_stats.view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"))(cf)(ks),
                     ms::make_gauge("view_updates_pending", ms::description("Number of updates pushed to view and are still to be completed"), _view_stats.writes)(cf)(ks),
+                    ms::make_total_operations("view_updates_coalesced", _view_stats.view_updates_coalesced, ms::description("Number of updates (mutations) merged into another update of the same view partition"))(cf)(ks),
+                    ms::make_total_operations("view_updates_batched", _view_stats.view_updates_batched, ms::description("Number of updates (mutations) sent to a remote view replica in the same message as other updates"))(cf)(ks),
+                    ms::make_total_operations("view_update_reads_batched", _view_stats.view_update_reads_batched, ms::description("Number of base writes whose read-before-write was shared with another write to the same partition"))(cf)(ks),
             });
         }
 
@@ -1307,6 +1356,24 @@ table::compact_sstables(sstables::compaction_descriptor descriptor, bool cleanup
     });
 }
 
+future<>
+table::move_sstables_to_level(std::vector<sstables::shared_sstable> sstables, uint32_t level) {
+    return do_with(std::move(sstables), [this, level] (std::vector<sstables::shared_sstable>& sstables) {
+        return do_for_each(sstables, [this, level] (const sstables::shared_sstable& sst) {
+            // The backlog tracker accounts for sstables by their level.
+            _compaction_strategy.get_backlog_tracker().remove_sstable(sst);
+            return sst->mutate_sstable_level(level).finally([this, sst] {
+                _compaction_strategy.get_backlog_tracker().add_sstable(sst);
+            });
+        }).finally([this] {
+            // The sstable set may place sstables according to their level. If moving
+            // an sstable failed, it kept its level both on disk and in memory, and the
+            // ones moved before it are rebuilt at their new level.
+            rebuild_sstable_list({}, {});
+        });
+    });
+}
+
 static bool needs_cleanup(const sstables::shared_sstable& sst,
                    const dht::token_range_vector& owned_ranges,
                    schema_ptr s) {
@@ -1332,8 +1399,9 @@ future<> table::cleanup_sstables(sstables::compaction_descriptor descriptor, boo
         r = service::get_local_storage_service().get_local_ranges(_schema->ks_name());
     }
 
-    return do_with(std::move(descriptor.sstables), std::move(r), std::move(descriptor.release_exhausted), [this, is_actual_cleanup] (auto& sstables, auto& owned_ranges, auto& release_fn) {
-        return do_for_each(sstables, [this, &owned_ranges, &release_fn, is_actual_cleanup] (auto& sst) {
+    return do_with(std::move(descriptor.sstables), std::move(r), std::move(descriptor.release_exhausted),
+            [this, is_actual_cleanup, parallelism = descriptor.parallelism] (auto& sstables, auto& owned_ranges, auto& release_fn) {
+        return do_for_each(sstables, [this, &owned_ranges, &release_fn, is_actual_cleanup, parallelism] (auto& sst) {
             if (!owned_ranges.empty() && !needs_cleanup(sst, owned_ranges, _schema)) {
                 return make_ready_future<>();
             }
@@ -1344,11 +1412,12 @@ future<> table::cleanup_sstables(sstables::compaction_descriptor descriptor, boo
             // twice the disk space used by those sstables.
             static thread_local semaphore sem(1);
 
-            return with_semaphore(sem, 1, [this, &sst, &release_fn, is_actual_cleanup] {
+            return with_semaphore(sem, 1, [this, &sst, &release_fn, is_actual_cleanup, parallelism] {
                 // release reference to sstables cleaned up, otherwise space usage from their data and index
                 // components cannot be reclaimed until all of them are cleaned.
                 auto descriptor = sstables::compaction_descriptor({ std::move(sst) }, sst->get_sstable_level());
                 descriptor.release_exhausted = release_fn;
+                descriptor.parallelism = parallelism;
                 return this->compact_sstables(std::move(descriptor), is_actual_cleanup);
             });
         });
@@ -1551,6 +1620,7 @@ table::table(schema_ptr schema, config config, db::commitlog* cl, compaction_man
     : _schema(std::move(schema))
     , _config(std::move(config))
     , _view_stats(format("{}_{}_view_replica_update", _schema->ks_name(), _schema->cf_name()))
+    , _view_update_coalescer(_view_stats, _config.cf_stats, _config.view_update_coalescing_window)
     , _memtables(_config.enable_disk_writes ? make_memtable_list() : make_memory_only_memtable_list())
     , _streaming_memtables(_config.enable_disk_writes ? make_streaming_memtable_list() : make_memory_only_memtable_list())
     , _compaction_strategy(make_compaction_strategy(_schema->compaction_strategy(), _schema->compaction_strategy_options()))
@@ -2080,7 +2150,7 @@ future<> table::generate_and_propagate_view_updates(const schema_ptr& base,
             flat_mutation_reader_from_mutations({std::move(m)}),
             std::move(existings)).then([this, base_token = std::move(base_token)] (std::vector<frozen_mutation_and_schema>&& updates) mutable {
         auto units = seastar::consume_units(*_config.view_update_concurrency_semaphore, memory_usage_of(updates));
-        db::view::mutate_MV(std::move(base_token), std::move(updates), _view_stats, *_config.cf_stats, std::move(units)).handle_exception([] (auto ignored) { });
+        _view_update_coalescer.add(base_token, std::move(updates), std::move(units));
     });
 }
 
@@ -2301,6 +2371,16 @@ table::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle
     do_apply(std::move(h), m, m_schema);
 }
 
+void
+table::apply(const std::vector<const frozen_mutation*>& ms, const schema_ptr& m_schema) {
+    try {
+        _memtables->active_memtable().apply(ms, m_schema);
+    } catch (...) {
+        _failed_counter_applies_to_memtable++;
+        throw;
+    }
+}
+
 future<>
 write_memtable_to_sstable(memtable& mt, sstables::shared_sstable sst,
                           sstables::write_monitor& monitor,
@@ -2472,7 +2552,8 @@ future<row_locker::lock_holder> table::push_view_replica_updates(const schema_pt
     return push_view_replica_updates(s, std::move(m), timeout);
 }
 
-future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source) const {
+future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout,
+        mutation_source&& source, bool batch_reads) const {
     if (!_config.view_update_concurrency_semaphore->current()) {
         // We don't have resources to generate view updates for this write. If we reached this point, we failed to
         // throttle the client. The memory queue is already full, waiting on the semaphore would cause this node to
@@ -2496,45 +2577,103 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema
                 return make_ready_future<row_locker::lock_holder>();
         });
     }
+    auto slice = view_update_read_slice(*base, std::move(cr_ranges));
+    // Take the shard-local lock on the base-table row or partition as needed.
+    // We'll return this lock to the caller, which will release it after
+    // writing the base-table update.
+    future<row_locker::lock_holder> lockf = local_base_lock(base, m.decorated_key(), slice.default_row_ranges(), timeout);
+    return lockf.then([m = std::move(m), slice = std::move(slice), views = std::move(views), base, this, source = std::move(source), batch_reads] (row_locker::lock_holder lock) mutable {
+        auto f = batch_reads
+                ? generate_and_propagate_batched_view_updates(base, std::move(m))
+                : read_and_propagate_view_updates(base, std::move(views), std::move(m), std::move(slice), source);
+        return f.then([lock = std::move(lock)] () mutable {
+            // return the local partition/row lock we have taken so it
+            // remains locked until the caller is done modifying this
+            // partition/row and destroys the lock object.
+            return std::move(lock);
+        });
+    });
+}
+
+query::partition_slice table::view_update_read_slice(const schema& base, query::clustering_row_ranges&& cr_ranges) {
     // We read the whole set of regular columns in case the update now causes a base row to pass
     // a view's filters, and a view happens to include columns that have no value in this update.
     // Also, one of those columns can determine the lifetime of the base row, if it has a TTL.
     auto columns = boost::copy_range<query::column_id_vector>(
-            base->regular_columns() | boost::adaptors::transformed(std::mem_fn(&column_definition::id)));
+            base.regular_columns() | boost::adaptors::transformed(std::mem_fn(&column_definition::id)));
     query::partition_slice::option_set opts;
     opts.set(query::partition_slice::option::send_partition_key);
     opts.set(query::partition_slice::option::send_clustering_key);
     opts.set(query::partition_slice::option::send_timestamp);
     opts.set(query::partition_slice::option::send_ttl);
-    auto slice = query::partition_slice(
+    return query::partition_slice(
             std::move(cr_ranges), { }, std::move(columns), std::move(opts), { }, cql_serialization_format::internal(), query::max_rows);
-    // Take the shard-local lock on the base-table row or partition as needed.
-    // We'll return this lock to the caller, which will release it after
-    // writing the base-table update.
-    future<row_locker::lock_holder> lockf = local_base_lock(base, m.decorated_key(), slice.default_row_ranges(), timeout);
-    return lockf.then([m = std::move(m), slice = std::move(slice), views = std::move(views), base, this, timeout, source = std::move(source)] (row_locker::lock_holder lock) {
-      return do_with(
+}
+
+future<> table::read_and_propagate_view_updates(const schema_ptr& base,
+        std::vector<view_ptr>&& views,
+        mutation&& m,
+        query::partition_slice&& slice,
+        const mutation_source& source) const {
+    return do_with(
         dht::partition_range::make_singular(m.decorated_key()),
         std::move(slice),
         std::move(m),
-        [base, views = std::move(views), lock = std::move(lock), this, timeout, source = std::move(source)] (auto& pk, auto& slice, auto& m) mutable {
+        [base, views = std::move(views), this, &source] (auto& pk, auto& slice, auto& m) mutable {
             auto reader = source.make_reader(base, pk, slice, service::get_local_sstable_query_read_priority());
-            return this->generate_and_propagate_view_updates(base, std::move(views), std::move(m), std::move(reader)).then([lock = std::move(lock)] () mutable {
-                // return the local partition/row lock we have taken so it
-                // remains locked until the caller is done modifying this
-                // partition/row and destroys the lock object.
-                return std::move(lock);
-            });
-      });
+            return this->generate_and_propagate_view_updates(base, std::move(views), std::move(m), std::move(reader));
+    });
+}
+
+/**
+ * Writes to the same base partition which are holding their locks when the
+ * read-before-write of one of them starts share that read. Their updates are
+ * merged and the view updates are generated from the merged mutation. Since
+ * the writes hold locks on different rows, that gives the same view updates
+ * as generating them for each write, but with a single read of the partition.
+ */
+future<> table::generate_and_propagate_batched_view_updates(const schema_ptr& base, mutation&& m) const {
+    auto token = m.token();
+    auto range = _view_update_read_batches.equal_range(token);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto& batch = *it->second;
+        if (batch.base == base && batch.m.decorated_key().equal(*base, m.decorated_key())) {
+            batch.m.apply(std::move(m));
+            ++_view_stats.view_update_reads_batched;
+            return batch.done.get_shared_future();
+        }
+    }
+    auto batch = make_lw_shared<view_update_read_batch>(view_update_read_batch{base, std::move(m)});
+    _view_update_read_batches.emplace(token, batch);
+    auto f = batch->done.get_shared_future();
+    // Let the writes to the partition which are already runnable join the batch.
+    later().then([this, batch, token] {
+        auto range = _view_update_read_batches.equal_range(token);
+        _view_update_read_batches.erase(std::find_if(range.first, range.second, [&batch] (auto& entry) {
+            return entry.second == batch;
+        }));
+        auto& base = batch->base;
+        auto& m = batch->m;
+        auto views = affected_views(base, m);
+        auto cr_ranges = db::view::calculate_affected_clustering_ranges(*base, m.decorated_key(), m.partition(), views);
+        auto slice = view_update_read_slice(*base, std::move(cr_ranges));
+        return read_and_propagate_view_updates(base, std::move(views), std::move(m), std::move(slice), as_mutation_source());
+    }).then_wrapped([batch] (future<> f) {
+        if (f.failed()) {
+            batch->done.set_exception(f.get_exception());
+        } else {
+            batch->done.set_value();
+        }
     });
+    return f;
 }
 
 future<row_locker::lock_holder> table::push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout) const {
-    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source());
+    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source(), true);
 }
 
 future<row_locker::lock_holder> table::stream_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, sstables::shared_sstable excluded_sstable) const {
-    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source_excluding(std::move(excluded_sstable)));
+    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source_excluding(std::move(excluded_sstable)), false);
 }
 
 mutation_source
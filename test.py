@@ -93,6 +93,8 @@ boost_tests = [
     'cell_locker_test',
     'view_schema_test',
     'view_build_test',
+    'repair_range_hash_test',
+    'stream_sstable_files_test',
     'view_complex_test',
     'clustering_ranges_walker_test',
     'vint_serialization_test',
@@ -86,6 +86,27 @@ BOOST_AUTO_TEST_CASE(test_libdeflate_matches_zlib) {
     test<zlib_crc32_checksummer, libdeflate_crc32_checksummer>();
 }
 
+BOOST_AUTO_TEST_CASE(test_fast_crc32_matches_zlib) {
+    test<zlib_crc32_checksummer, fast_crc32_checksummer>();
+}
+
+BOOST_AUTO_TEST_CASE(test_fast_crc32_implementations_match_zlib) {
+    auto data = make_random_string(4096);
+    for (auto impl : {fast_crc32_implementation::generic, fast_crc32_implementation::pclmul, fast_crc32_implementation::avx512_vpclmul}) {
+        if (!fast_crc32_supported(impl)) {
+            continue;
+        }
+        // Covers all combinations of the folded part and of the tails.
+        for (size_t offset : {0, 1, 7}) {
+            for (size_t size = 0; size < data.size() - offset; size += size < 600 ? 1 : 61) {
+                auto input = data.cbegin() + offset;
+                auto expected = zlib_crc32_checksummer::checksum(0x12345678, input, size);
+                BOOST_REQUIRE_EQUAL(fast_crc32(impl, 0x12345678, input, size), expected);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_default_matches_zlib) {
     test<zlib_crc32_checksummer, crc32_utils>();
 }
@@ -22,6 +22,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include <stdlib.h>
 #include <iostream>
@@ -101,6 +102,67 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// Writes rounds of concurrent mutations. The writes of the first round
+// share buffers, which makes batch mode open group commit windows for the
+// following ones.
+static future<> write_concurrent_mutations(commitlog& log) {
+    auto uuid = utils::UUID_gen::get_time_UUID();
+    return do_for_each(boost::irange(0, 10), [&log, uuid] (int) {
+        return parallel_for_each(boost::irange(0, 100), [&log, uuid] (int) {
+            sstring tmp = "hej bubba cow";
+            return log.add_mutation(uuid, tmp.size(), [tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            }).then([](replay_position rp) {
+                BOOST_CHECK_NE(rp, db::replay_position());
+            });
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_batch_group_commit){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.commitlog_sync_batch_max_window_in_us = 10000;
+    return cl_test(cfg, [](commitlog& log) {
+        return write_concurrent_mutations(log).then([&log] {
+            BOOST_REQUIRE_GT(log.get_num_batch_windows(), 0);
+            // concurrent writes share flushes.
+            auto n = log.get_flush_count();
+            BOOST_REQUIRE_GT(n, 0);
+            BOOST_REQUIRE_LT(n, 1000);
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_batch_group_commit_disabled){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.commitlog_sync_batch_max_window_in_us = 0;
+    return cl_test(cfg, [](commitlog& log) {
+        return write_concurrent_mutations(log).then([&log] {
+            BOOST_REQUIRE_EQUAL(log.get_num_batch_windows(), 0);
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_batch_no_window_for_sequential_writes){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.commitlog_sync_batch_max_window_in_us = 10000;
+    return cl_test(cfg, [](commitlog& log) {
+        auto uuid = utils::UUID_gen::get_time_UUID();
+        // Writes which don't overlap have nothing to share a flush with.
+        return do_for_each(boost::irange(0, 100), [&log, uuid] (int) {
+            sstring tmp = "hej bubba cow";
+            return log.add_mutation(uuid, tmp.size(), [tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            }).discard_result();
+        }).then([&log] {
+            BOOST_REQUIRE_EQUAL(log.get_num_batch_windows(), 0);
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_periodic){
     return cl_test([](commitlog& log) {
             auto state = make_lw_shared(false);
@@ -356,6 +418,58 @@ SEASTAR_TEST_CASE(test_commitlog_reader){
         });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_compressed_reader){
+    static auto read_segment = [] (sstring path, db::position_type off) {
+        auto rps = make_lw_shared<std::vector<db::replay_position>>();
+        return db::commitlog::read_log_file(path, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [rps](fragmented_temporary_buffer buf, db::replay_position rp) {
+            auto linearization_buffer = bytes_ostream();
+            auto in = buf.get_istream();
+            auto str = to_sstring_view(in.read_bytes_view(buf.size_bytes(), linearization_buffer));
+            BOOST_CHECK_EQUAL(str, sstring(1024, 'x'));
+            rps->push_back(rp);
+            return make_ready_future<>();
+        }, off).then([](auto s) {
+            return do_with(std::move(s), [](auto& s) {
+                return s->done();
+            });
+        }).then([rps] {
+            return std::move(*rps);
+        });
+    };
+    commitlog::config cfg;
+    cfg.use_compression = true;
+    return cl_test(cfg, [](commitlog& log) {
+        auto rps = make_lw_shared<std::vector<db::replay_position>>();
+        auto uuid = utils::UUID_gen::get_time_UUID();
+        return do_for_each(boost::irange(0, 1000), [&log, uuid, rps] (int) {
+            sstring tmp(1024, 'x');
+            return log.add_mutation(uuid, tmp.size(), [tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            }).then([rps](replay_position rp) {
+                rps->push_back(rp);
+            });
+        }).then([&log] {
+            return log.sync_all_segments();
+        }).then([&log, rps] {
+            auto segments = log.get_active_segment_names();
+            BOOST_REQUIRE_EQUAL(segments.size(), 1);
+            commitlog::descriptor desc(segments[0], db::commitlog::descriptor::FILENAME_PREFIX);
+            BOOST_REQUIRE_EQUAL(desc.ver, 2);
+            // Positions are those of the uncompressed data, both when
+            // reading the whole segment and when starting from an entry.
+            return read_segment(segments[0], 0).then([rps, segment = segments[0]] (std::vector<db::replay_position> replayed) {
+                BOOST_REQUIRE(replayed == *rps);
+                auto mid = (*rps)[rps->size() / 2];
+                return read_segment(segment, mid.pos).then([rps, mid] (std::vector<db::replay_position> replayed) {
+                    BOOST_REQUIRE(!replayed.empty());
+                    BOOST_REQUIRE(replayed.front() <= mid);
+                    BOOST_REQUIRE(replayed.back() == rps->back());
+                });
+            });
+        });
+    });
+}
+
 static future<> corrupt_segment(sstring seg, uint64_t off, uint32_t value) {
     return open_file_dma(seg, open_flags::rw).then([off, value](file f) {
         size_t size = align_up<size_t>(off, 4096);
@@ -44,6 +44,7 @@
 #include "types/set.hh"
 #include "db/config.hh"
 #include "sstables/compaction_manager.hh"
+#include "service/storage_proxy.hh"
 #include "exception_utils.hh"
 
 using namespace std::literals::chrono_literals;
@@ -3855,6 +3856,88 @@ SEASTAR_TEST_CASE(test_aggregate_and_simple_selection_together) {
     });
 }
 
+SEASTAR_TEST_CASE(test_parallelized_aggregation) {
+    auto cfg = make_shared<db::config>();
+    cfg->enable_parallelized_aggregation(true);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "create table t (p int, c int, v int, primary key(p, c))");
+        require_rows(e, "select count(*), count(v), sum(v), min(v), max(v) from t", {{L(0), L(0), I(0), std::nullopt, std::nullopt}});
+        int32_t sum = 0;
+        for (int p = 0; p < 100; ++p) {
+            for (int c = 0; c < 3; ++c) {
+                cquery_nofail(e, format("insert into t (p, c, v) values ({}, {}, {})", p, c, p * 3 + c).c_str());
+                sum += p * 3 + c;
+            }
+        }
+        cquery_nofail(e, "insert into t (p, c) values (100, 0)");
+        flush(e);
+        auto partial_aggregate_reads = [] {
+            return service::get_storage_proxy().map_reduce0([] (service::storage_proxy& p) {
+                return p.get_stats().replica_partial_aggregate_reads;
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto reads = partial_aggregate_reads();
+        require_rows(e, "select count(*), count(v), sum(v), min(v), max(v) from t", {{L(301), L(300), I(sum), I(0), I(299)}});
+        BOOST_REQUIRE_GT(partial_aggregate_reads(), reads);
+        reads = partial_aggregate_reads();
+        require_rows(e, "select count(*) from t where c > 0 allow filtering", {{L(200)}});
+        require_rows(e, "select count(*) from t where p = 1", {{L(3)}});
+        BOOST_REQUIRE_EQUAL(partial_aggregate_reads(), reads);
+    }, cfg);
+}
+
+SEASTAR_TEST_CASE(test_select_key_columns_of_many_partitions) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "create table t (p1 text, p2 int, c1 text, c2 int, v int, primary key((p1, p2), c1, c2))");
+        // Long enough not to fit in the inline storage of the keys.
+        auto text = [] (int i) { return format("a rather long text value number {:d}", i); };
+        std::vector<std::vector<bytes_opt>> expected;
+        for (int p = 0; p < 10; ++p) {
+            for (int c = 0; c < 10; ++c) {
+                cquery_nofail(e, format("insert into t (p1, p2, c1, c2, v) values ('{}', {:d}, '{}', {:d}, {:d})", text(p), p, text(c), c, p * c).c_str());
+                expected.push_back({T(text(p).c_str()), I(p), T(text(c).c_str()), I(c), I(p * c)});
+            }
+        }
+        // A partition without rows, whose keys are written by accept_partition_end().
+        cquery_nofail(e, "create table s (p1 text, p2 int, c int, st int static, primary key((p1, p2), c))");
+        cquery_nofail(e, format("insert into s (p1, p2, st) values ('{}', 1, 1)", text(1)).c_str());
+        cquery_nofail(e, format("insert into s (p1, p2, st) values ('{}', 2, 2)", text(2)).c_str());
+
+        require_rows(e, "select p1, p2, c1, c2, v from t", expected);
+        require_rows(e, "select p2, p1 from s", {{I(1), T(text(1).c_str())}, {I(2), T(text(2).c_str())}});
+    });
+}
+
+SEASTAR_TEST_CASE(test_partition_key_bound_by_markers) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "create table t (p1 int, p2 text, c int, v int, primary key((p1, p2), c))");
+        auto insert = e.prepare("insert into t (p2, p1, c, v) values (?, ?, ?, ?)").get0();
+        auto select = e.prepare("select c, v from t where p1 = ? and p2 = ?").get0();
+        auto select_reversed = e.prepare("select c, v from t where p2 = ? and p1 = ?").get0();
+        auto value = [] (bytes b) { return cql3::raw_value::make_value(std::move(b)); };
+        for (int c = 0; c < 3; ++c) {
+            e.execute_prepared(insert, {value(T("a")), value(I(1)), value(I(c)), value(I(c * 10))}).get();
+        }
+        e.execute_prepared(insert, {value(T("b")), value(I(1)), value(I(0)), value(I(100))}).get();
+
+        std::vector<std::vector<bytes_opt>> expected = {{I(0), I(0)}, {I(1), I(10)}, {I(2), I(20)}};
+        assert_that(e.execute_prepared(select, {value(I(1)), value(T("a"))}).get0()).is_rows().with_rows(expected);
+        assert_that(e.execute_prepared(select_reversed, {value(T("a")), value(I(1))}).get0()).is_rows().with_rows(expected);
+        // Keys built from bound values are the same as the ones of literals.
+        require_rows(e, "select c, v from t where p1 = 1 and p2 = 'a'", expected);
+        require_rows(e, "select v from t where p1 = 1 and p2 = 'b'", {{I(100)}});
+
+        auto update = e.prepare("update t set v = ? where p1 = ? and p2 = ? and c = ?").get0();
+        e.execute_prepared(update, {value(I(200)), value(I(1)), value(T("b")), value(I(0))}).get();
+        require_rows(e, "select v from t where p1 = 1 and p2 = 'b'", {{I(200)}});
+
+        BOOST_REQUIRE_THROW(e.execute_prepared(select, {value(I(1)), cql3::raw_value::make_null()}).get(), exceptions::invalid_request_exception);
+        BOOST_REQUIRE_THROW(e.execute_prepared(select, {value(T("ab")), value(T("a"))}).get(), exceptions::invalid_request_exception);
+        BOOST_REQUIRE_THROW(e.execute_prepared(update, {value(I(1)), value(I(1)), cql3::raw_value::make_null(), value(I(0))}).get(),
+                exceptions::invalid_request_exception);
+    });
+}
+
 SEASTAR_TEST_CASE(test_like_operator) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "create table t (p int primary key, s text)");
@@ -291,6 +291,10 @@ class single_node_cql_env : public cql_test_env {
         return _auth_service->local();
     }
 
+    sharded<auth::service>& auth_service() override {
+        return *_auth_service;
+    }
+
     virtual db::view::view_builder& local_view_builder() override {
         return _view_builder->local();
     }
@@ -119,6 +119,8 @@ class cql_test_env {
 
     virtual auth::service& local_auth_service() = 0;
 
+    virtual sharded<auth::service>& auth_service() = 0;
+
     virtual db::view::view_builder& local_view_builder() = 0;
 
     virtual db::view::view_update_generator& local_view_update_generator() = 0;
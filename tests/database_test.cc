@@ -27,6 +27,7 @@
 
 #include "tests/cql_test_env.hh"
 #include "tests/result_set_assertions.hh"
+#include "tests/cql_assertions.hh"
 
 #include "database.hh"
 #include "partition_slice_builder.hh"
@@ -78,6 +79,40 @@ SEASTAR_TEST_CASE(test_safety_after_truncate) {
     }, cfg);
 }
 
+SEASTAR_TEST_CASE(test_commitlog_replay_in_bulk) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (p int, c int, v int, primary key (p, c));").get();
+        for (int i = 0; i < 1000; ++i) {
+            e.execute_cql(format("insert into ks.cf (p, c, v) values ({}, {}, {});", i % 10, i, i)).get();
+        }
+        auto assert_row_count = [&] (int64_t count) {
+            auto msg = e.execute_cql("select count(*) from ks.cf;").get0();
+            assert_that(msg).is_rows().with_rows({{{long_type->decompose(count)}}});
+        };
+        assert_row_count(1000);
+
+        // Drop the memtables, so that only the commitlog has the data.
+        e.db().invoke_on_all([] (database& db) {
+            return db.find_column_family("ks", "cf").clear();
+        }).get();
+        assert_row_count(0);
+
+        auto rp = db::commitlog_replayer::create_replayer(e.db()).get0();
+        auto paths = e.local_db().commitlog()->list_existing_segments().get0();
+        rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+
+        assert_row_count(1000);
+        auto& stats = rp.get_stats();
+        BOOST_REQUIRE_GE(stats.applied_mutations, 1000u);
+        BOOST_REQUIRE_EQUAL(stats.invalid_mutations, 0u);
+        // The writes are spread over 10 partitions, so most of them are
+        // batched with other writes to the same table.
+        BOOST_REQUIRE_GE(stats.bulk_applied_mutations, 900u);
+        BOOST_REQUIRE_GT(stats.applied_bytes, 0u);
+        BOOST_REQUIRE_GT(rp.mutations_per_sec(), 0);
+    });
+}
+
 SEASTAR_TEST_CASE(test_querying_with_limits) {
     return do_with_cql_env([](cql_test_env& e) {
         return seastar::async([&] {
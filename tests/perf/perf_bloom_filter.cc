@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/tests/perf/perf_tests.hh>
+#include <seastar/testing/test_runner.hh>
+
+#include <random>
+
+#include "utils/bloom_filter.hh"
+
+// Compares the murmur3 bloom filter with the split block one at the same
+// number of bits per key. Filters are sized so that they don't fit in the
+// CPU caches, as is the case for the filters of large sstables.
+class bloom_filter_probe {
+public:
+    static constexpr size_t count = 1000;
+    static constexpr int64_t elements = 4 * 1024 * 1024;
+    static constexpr double fp_chance = 0.01;
+private:
+    utils::filter_ptr _murmur3;
+    utils::filter_ptr _split_block;
+    std::vector<utils::hashed_key> _present;
+    std::vector<utils::hashed_key> _absent;
+
+    static bytes key(uint64_t i) {
+        bytes b(bytes::initialized_later(), sizeof(i));
+        std::copy_n(reinterpret_cast<const int8_t*>(&i), sizeof(i), b.begin());
+        return b;
+    }
+
+    static double false_positive_rate(utils::i_filter& f, uint64_t from, uint64_t to) {
+        uint64_t positives = 0;
+        for (auto i = from; i < to; ++i) {
+            positives += f.is_present(key(i));
+        }
+        return double(positives) / (to - from);
+    }
+public:
+    bloom_filter_probe()
+        : _murmur3(utils::i_filter::get_filter(elements, fp_chance, utils::filter_format::m_format))
+        , _split_block(utils::i_filter::get_split_block_filter(elements, fp_chance))
+    {
+        for (int64_t i = 0; i < elements; ++i) {
+            auto k = key(i);
+            _murmur3->add(k);
+            _split_block->add(k);
+        }
+
+        auto eng = seastar::testing::local_random_engine;
+        auto present = std::uniform_int_distribution<uint64_t>(0, elements - 1);
+        auto absent = std::uniform_int_distribution<uint64_t>(elements, std::numeric_limits<uint64_t>::max());
+        for (size_t i = 0; i < count; ++i) {
+            _present.push_back(utils::make_hashed_key(key(present(eng))));
+            _absent.push_back(utils::make_hashed_key(key(absent(eng))));
+        }
+
+        static bool reported = false;
+        if (!reported) {
+            reported = true;
+            std::cout << "false positive rate at " << fp_chance << " target, "
+                      << double(_murmur3->memory_size()) * 8 / elements << " bits per key: murmur3 "
+                      << false_positive_rate(*_murmur3, elements, elements * 2) << ", split block "
+                      << false_positive_rate(*_split_block, elements, elements * 2) << std::endl;
+        }
+    }
+
+    utils::i_filter& murmur3() { return *_murmur3; }
+    utils::i_filter& split_block() { return *_split_block; }
+    const std::vector<utils::hashed_key>& present() const { return _present; }
+    const std::vector<utils::hashed_key>& absent() const { return _absent; }
+};
+
+PERF_TEST_F(bloom_filter_probe, murmur3_present) {
+    for (auto& k : present()) {
+        perf_tests::do_not_optimize(murmur3().is_present(k));
+    }
+    return count;
+}
+
+PERF_TEST_F(bloom_filter_probe, split_block_present) {
+    for (auto& k : present()) {
+        perf_tests::do_not_optimize(split_block().is_present(k));
+    }
+    return count;
+}
+
+PERF_TEST_F(bloom_filter_probe, murmur3_absent) {
+    for (auto& k : absent()) {
+        perf_tests::do_not_optimize(murmur3().is_present(k));
+    }
+    return count;
+}
+
+PERF_TEST_F(bloom_filter_probe, split_block_absent) {
+    for (auto& k : absent()) {
+        perf_tests::do_not_optimize(split_block().is_present(k));
+    }
+    return count;
+}
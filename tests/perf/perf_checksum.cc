@@ -67,3 +67,34 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+// Checksum tests process 64 KiB, so throughput in GB/s is 65536 divided
+// by the reported time per iteration in nanoseconds. Implementations not
+// supported by the CPU fall back to the generic one.
+
+static uint32_t fast_crc32_or_generic(fast_crc32_implementation impl, const sstring& data) {
+    if (!fast_crc32_supported(impl)) {
+        impl = fast_crc32_implementation::generic;
+    }
+    return fast_crc32(impl, 0, data.data(), data.size());
+}
+
+PERF_TEST_F(crc_test, perf_fast_crc32_generic_checksum) {
+    perf_tests::do_not_optimize(
+        fast_crc32_or_generic(fast_crc32_implementation::generic, data));
+}
+
+PERF_TEST_F(crc_test, perf_fast_crc32_pclmul_checksum) {
+    perf_tests::do_not_optimize(
+        fast_crc32_or_generic(fast_crc32_implementation::pclmul, data));
+}
+
+PERF_TEST_F(crc_test, perf_fast_crc32_avx512_vpclmul_checksum) {
+    perf_tests::do_not_optimize(
+        fast_crc32_or_generic(fast_crc32_implementation::avx512_vpclmul, data));
+}
+
+PERF_TEST_F(crc_test, perf_crc32_utils_checksum) {
+    perf_tests::do_not_optimize(
+        crc32_utils::checksum(data.data(), data.size()));
+}
@@ -811,6 +811,21 @@ static test_result scan_with_stride_partitions(column_family& cf, int n, int n_r
     return {before, fragments};
 }
 
+// Reads the whole table with n_readers concurrent readers.
+static test_result scan_all_concurrently(column_family& cf, unsigned n_readers) {
+    metrics_snapshot before;
+
+    uint64_t fragments = 0;
+    parallel_for_each(boost::irange(0u, n_readers), [&] (unsigned) {
+        return seastar::async([&] {
+            auto rd = cf.make_reader(cf.schema(), query::full_partition_range, cf.schema()->full_slice());
+            fragments += consume_all(rd);
+        });
+    }).get();
+
+    return {before, fragments};
+}
+
 static test_result slice_rows(column_family& cf, int offset = 0, int n_read = 1) {
     auto rd = cf.make_reader(cf.schema(),
         query::full_partition_range,
@@ -1577,6 +1592,31 @@ void test_small_partition_slicing(column_family& cf2, multipart_ds& ds) {
     test(n_parts / 2, 4096);
 }
 
+static void test_sequential_scan(column_family& cf, uint64_t fragments_per_scan) {
+    output_mgr->set_test_param_names({{"readers", "{:<7}"}}, test_result::stats_names());
+    auto test = [&] (unsigned n_readers) {
+      run_test_case([&] {
+        auto r = scan_all_concurrently(cf, n_readers);
+        r.set_params(to_sstrings(n_readers));
+        check_fragment_count(r, fragments_per_scan * n_readers);
+        return r;
+      });
+    };
+
+    test(1);
+    test(2);
+    test(4);
+    test(16);
+}
+
+void test_large_partition_sequential_scan(column_family& cf, clustered_ds& ds) {
+    test_sequential_scan(cf, ds.n_rows(cfg));
+}
+
+void test_small_partition_sequential_scan(column_family& cf, multipart_ds& ds) {
+    test_sequential_scan(cf, ds.n_partitions(cfg));
+}
+
 static
 auto make_datasets() {
     std::map<std::string, std::unique_ptr<dataset>> dsets;
@@ -1708,6 +1748,14 @@ static std::initializer_list<test_group> test_groups = {
         test_group::type::large_partition,
         make_test_fn(test_large_partition_forwarding),
     },
+    {
+        "large-partition-sequential-scan",
+        "Testing throughput of full scans of a large partition by concurrent readers.\n" \
+        "Shows how read-ahead keeps the disk busy and how it is limited when readers compete for memory",
+        test_group::requires_cache::no,
+        test_group::type::large_partition,
+        make_test_fn(test_large_partition_sequential_scan),
+    },
     {
         "small-partition-skips",
         "Testing scanning small partitions with skips.\n" \
@@ -1723,6 +1771,13 @@ static std::initializer_list<test_group> test_groups = {
         test_group::type::small_partition,
         make_test_fn(test_small_partition_slicing),
     },
+    {
+        "small-partition-sequential-scan",
+        "Testing throughput of full scans of small partitions by concurrent readers",
+        test_group::requires_cache::no,
+        test_group::type::small_partition,
+        make_test_fn(test_small_partition_sequential_scan),
+    },
 };
 
 // Disables compaction for given tables.
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/range/irange.hpp>
+#include "tests/cql_test_env.hh"
+#include "tests/perf/perf.hh"
+#include <seastar/core/app-template.hh>
+#include <seastar/testing/test_runner.hh>
+#include "db/config.hh"
+
+// Measures the write throughput of a base table with materialized views.
+//
+// Each view has the base partition key as its partition key, so writes to the
+// same base partition update the same view partition, which lets view updates
+// be coalesced (see view_update_coalescing_window_in_ms).
+
+static constexpr unsigned max_views = 5;
+
+struct test_config {
+    unsigned partitions;
+    unsigned rows_per_partition;
+    unsigned concurrency;
+    unsigned duration_in_seconds;
+    unsigned operations_per_shard = 0;
+};
+
+std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
+    return os << "{partitions=" << cfg.partitions
+           << ", rows_per_partition=" << cfg.rows_per_partition
+           << ", concurrency=" << cfg.concurrency
+           << "}";
+}
+
+static sstring table_name(unsigned views) {
+    return format("t{}", views);
+}
+
+static future<> create_table_with_views(cql_test_env& env, unsigned views) {
+    auto table = table_name(views);
+    return env.execute_cql(format("CREATE TABLE {} (p int, c int, v0 int, v1 int, v2 int, v3 int, v4 int, PRIMARY KEY (p, c))", table)).discard_result().then([&env, table, views] {
+        auto ids = boost::irange(0u, views);
+        return do_for_each(ids.begin(), ids.end(), [&env, table] (unsigned i) {
+            return env.execute_cql(format("CREATE MATERIALIZED VIEW {}_mv{} AS SELECT p, c, v{} FROM {} "
+                    "WHERE p IS NOT NULL AND c IS NOT NULL AND v{} IS NOT NULL PRIMARY KEY (p, v{}, c)", table, i, i, table, i, i)).discard_result();
+        });
+    });
+}
+
+static future<std::vector<double>> test_write(cql_test_env& env, test_config& cfg, unsigned views) {
+    return create_table_with_views(env, views).then([&env, views] {
+        return env.prepare(format("UPDATE {} SET v0 = ?, v1 = ?, v2 = ?, v3 = ?, v4 = ? WHERE p = ? AND c = ?", table_name(views)));
+    }).then([&env, &cfg] (auto id) {
+        return time_parallel([&env, &cfg, id] {
+            std::vector<cql3::raw_value> values;
+            for (unsigned i = 0; i < max_views; ++i) {
+                values.push_back(cql3::raw_value::make_value(int32_type->decompose(int32_t(std::rand()))));
+            }
+            values.push_back(cql3::raw_value::make_value(int32_type->decompose(int32_t(std::rand() % cfg.partitions))));
+            values.push_back(cql3::raw_value::make_value(int32_type->decompose(int32_t(std::rand() % cfg.rows_per_partition))));
+            return env.execute_prepared(id, std::move(values)).discard_result();
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
+    });
+}
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("random-seed", bpo::value<unsigned>(), "Random number generator seed")
+        ("partitions", bpo::value<unsigned>()->default_value(1000), "number of base partitions")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(100), "number of rows in each base partition")
+        ("duration", bpo::value<unsigned>()->default_value(5), "test duration in seconds")
+        ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
+        ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
+        ("views", bpo::value<std::vector<unsigned>>()->default_value({1, 2, 5}, "1 2 5")->multitoken(), "numbers of views to test with, at most 5")
+        ("coalescing-window-ms", bpo::value<unsigned>()->default_value(0), "view update coalescing window, in milliseconds")
+        ;
+
+    return app.run(argc, argv, [&app] {
+        auto init = [&app] {
+            auto conf_seed = app.configuration()["random-seed"];
+            auto seed = conf_seed.empty() ? std::random_device()() : conf_seed.as<unsigned>();
+            std::cout << "random-seed=" << seed << '\n';
+            return smp::invoke_on_all([seed] {
+                seastar::testing::local_random_engine.seed(seed + engine().cpu_id());
+                std::srand(seed + engine().cpu_id());
+            });
+        };
+
+        auto db_cfg = make_shared<db::config>();
+        db_cfg->view_update_coalescing_window_in_ms(app.configuration()["coalescing-window-ms"].as<unsigned>());
+
+        return init().then([&app, db_cfg] {
+          return do_with_cql_env([&app] (auto&& env) {
+            auto cfg = test_config();
+            cfg.partitions = app.configuration()["partitions"].as<unsigned>();
+            cfg.rows_per_partition = app.configuration()["rows-per-partition"].as<unsigned>();
+            cfg.duration_in_seconds = app.configuration()["duration"].as<unsigned>();
+            cfg.concurrency = app.configuration()["concurrency"].as<unsigned>();
+            if (app.configuration().count("operations-per-shard")) {
+                cfg.operations_per_shard = app.configuration()["operations-per-shard"].as<unsigned>();
+            }
+            auto views = app.configuration()["views"].as<std::vector<unsigned>>();
+
+            return do_with(std::move(cfg), std::move(views), [&env] (test_config& cfg, std::vector<unsigned>& views) {
+                return do_for_each(views, [&env, &cfg] (unsigned n) {
+                    if (n > max_views) {
+                        throw std::invalid_argument(format("at most {} views are supported", max_views));
+                    }
+                    std::cout << "Running test with " << n << " view(s) and config: " << cfg << std::endl;
+                    return test_write(env, cfg, n).then([n] (std::vector<double> results) {
+                        std::sort(results.begin(), results.end());
+                        auto median = results[results.size() / 2];
+                        auto min = results[0];
+                        auto max = results[results.size() - 1];
+                        std::cout << format("views: {}\nmedian {:.2f}\nmaximum: {:.2f}\nminimum: {:.2f}\n\n", n, median, max, min);
+                    });
+                });
+            });
+          }, db_cfg);
+        });
+    });
+}
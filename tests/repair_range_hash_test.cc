@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/testing/test_case.hh>
+
+#include "database.hh"
+#include "repair/repair.hh"
+#include "repair/row_level.hh"
+#include "tests/cql_test_env.hh"
+#include "tests/cql_assertions.hh"
+
+// Returns n keys of the table which belong to this shard, sorted by token.
+static std::vector<std::pair<int32_t, dht::token>> local_keys(const schema& s, size_t n) {
+    std::vector<std::pair<int32_t, dht::token>> keys;
+    for (int32_t p = 0; keys.size() < n; ++p) {
+        auto token = dht::global_partitioner().decorate_key(s, partition_key::from_singular(s, p)).token();
+        if (dht::global_partitioner().shard_of(token) == engine().cpu_id()) {
+            keys.emplace_back(p, token);
+        }
+    }
+    std::sort(keys.begin(), keys.end(), [] (auto& a, auto& b) {
+        return a.second < b.second;
+    });
+    return keys;
+}
+
+static void insert(cql_test_env& e, int32_t p, int32_t v) {
+    e.execute_cql(format("insert into t (p, v) values ({}, {});", p, v)).get();
+}
+
+SEASTAR_TEST_CASE(test_remembered_range_hash) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table t (p int primary key, v int);").get();
+        auto& cf = e.local_db().find_column_family("ks", "t");
+        auto s = cf.schema();
+        auto keys = local_keys(*s, 3);
+        auto range = dht::token_range::make_singular(keys[1].second);
+        auto hash = repair_hash(42);
+
+        insert(e, keys[1].first, 1);
+        cf.flush().get();
+        auto sstables = repair_range_sstables(cf, range);
+        BOOST_REQUIRE_EQUAL(sstables.size(), 1u);
+        BOOST_REQUIRE(remember_repair_range_hash(cf, range, sstables, hash).get0());
+        auto remembered = get_remembered_repair_range_hash(cf, range).get0();
+        BOOST_REQUIRE(remembered && *remembered == hash);
+        assert_that(e.execute_cql("select hash from system.repair_range_hashes;").get0()).is_rows().with_rows({{long_type->decompose(int64_t(42))}});
+
+        // Writes around the range, in memtables and in an sstable which
+        // overlaps the range, don't change it.
+        insert(e, keys[0].first, 2);
+        insert(e, keys[2].first, 2);
+        remembered = get_remembered_repair_range_hash(cf, range).get0();
+        BOOST_REQUIRE(remembered && *remembered == hash);
+        cf.flush().get();
+        BOOST_REQUIRE_EQUAL(repair_range_sstables(cf, range).size(), 2u);
+        remembered = get_remembered_repair_range_hash(cf, range).get0();
+        BOOST_REQUIRE(remembered && *remembered == hash);
+
+        // A write to the range does, whether it is flushed or not.
+        insert(e, keys[1].first, 3);
+        BOOST_REQUIRE(!get_remembered_repair_range_hash(cf, range).get0());
+        BOOST_REQUIRE(!remember_repair_range_hash(cf, range, sstables, hash).get0());
+        cf.flush().get();
+        BOOST_REQUIRE(!get_remembered_repair_range_hash(cf, range).get0());
+        BOOST_REQUIRE(!remember_repair_range_hash(cf, range, sstables, hash).get0());
+
+        // So does compacting the sstables the range was read from.
+        sstables = repair_range_sstables(cf, range);
+        BOOST_REQUIRE(remember_repair_range_hash(cf, range, sstables, hash).get0());
+        cf.compact_all_sstables().get();
+        BOOST_REQUIRE(!get_remembered_repair_range_hash(cf, range).get0());
+    });
+}
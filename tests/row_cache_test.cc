@@ -1764,6 +1764,96 @@ SEASTAR_TEST_CASE(test_lru) {
     });
 }
 
+SEASTAR_TEST_CASE(test_tinylfu_admission) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        std::vector<mutation> partitions = make_ring(s, 10);
+        for (auto&& m : partitions) {
+            mt->apply(m);
+        }
+
+        cache_tracker tracker;
+        tracker.set_admission_policy(std::make_unique<tinylfu_admission_policy>());
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto read = [&] (const mutation& m) {
+            assert_that(cache.make_reader(s, dht::partition_range::make_singular(m.decorated_key())))
+                .produces(m)
+                .produces_end_of_stream();
+        };
+
+        // Nothing was evicted yet, so everything is admitted.
+        read(partitions[1]);
+        for (int i = 0; i < 3; ++i) {
+            read(partitions[0]);
+        }
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 2);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_admissions, 2);
+
+        // Evicts partitions[1], which was read once.
+        evict_one_partition(tracker);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+
+        // A scan reads each partition once, which doesn't make them more
+        // valuable than the victim.
+        auto pr = dht::partition_range::make_starting_with(dht::ring_position(partitions[2].decorated_key()));
+        auto rd = assert_that(cache.make_reader(s, pr));
+        for (int i = 2; i < 10; ++i) {
+            rd.produces(partitions[i]);
+        }
+        rd.produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_rejections, 8);
+
+        // Read again, it is now more frequent than the victim.
+        read(partitions[2]);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 2);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().population_admissions, 3);
+
+        read(partitions[0]);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_hits, 3);
+    });
+}
+
+SEASTAR_TEST_CASE(test_scan_population_limit) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        std::vector<mutation> partitions = make_ring(s, 10);
+        for (auto&& m : partitions) {
+            mt->apply(m);
+        }
+
+        cache_tracker tracker;
+        tracker.set_scan_population_limit(1);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        // Only the first partition is populated, the limit is exceeded by its row.
+        auto rd = assert_that(cache.make_reader(s));
+        for (auto&& m : partitions) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().scan_population_bypasses, 9);
+
+        // Single partition reads are not affected.
+        assert_that(cache.make_reader(s, dht::partition_range::make_singular(partitions[5].decorated_key())))
+            .produces(partitions[5])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 2);
+
+        tracker.set_scan_population_limit(0);
+        assert_that(cache.make_reader(s))
+            .produces(partitions)
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), partitions.size());
+    });
+}
+
 SEASTAR_TEST_CASE(test_update_invalidating) {
     return seastar::async([] {
         simple_schema s;
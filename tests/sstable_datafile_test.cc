@@ -55,6 +55,7 @@
 #include "tests/normalizing_reader.hh"
 #include "sstable_run_based_compaction_strategy_for_tests.hh"
 #include "compatible_ring_position.hh"
+#include "utils/bloom_filter.hh"
 
 #include <stdio.h>
 #include <ftw.h>
@@ -3646,6 +3647,151 @@ shared_sstable make_sstable_easy(test_env& env, const fs::path& path, flat_mutat
     return sst;
 }
 
+SEASTAR_TEST_CASE(test_zstd_dictionary_compression) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        for (const auto version : all_sstable_versions) {
+            auto s = schema_builder("tests", "zstd_dictionary_test")
+                    .with_column("pk", int32_type, column_kind::partition_key)
+                    .with_column("ck", int32_type, column_kind::clustering_key)
+                    .with_column("v", utf8_type)
+                    .set_compressor_params(compression_parameters({
+                        {compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor"},
+                        {compression_parameters::CHUNK_LENGTH_KB, "4"},
+                        {"compression_level", "1"},
+                        {"dictionary_size_in_kb", "4"},
+                    }))
+                    .build();
+
+            std::vector<mutation> muts;
+            for (int pk = 0; pk < 100; ++pk) {
+                mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+                for (int ck = 0; ck < 100; ++ck) {
+                    auto v = format("sensor={} status=ok unit=celsius reading={}", pk % 7, ck % 13);
+                    m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)),
+                            "v", data_value(v), api::new_timestamp());
+                }
+                muts.push_back(std::move(m));
+            }
+            std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+
+            auto tmp = tmpdir();
+            auto sst = make_sstable_easy(env, tmp.path(), flat_mutation_reader_from_mutations(muts), sstable_writer_config{}, version);
+
+            BOOST_REQUIRE(!sstables::test(sst).get_compression().dictionary().empty());
+
+            auto assertions = assert_that(sst->as_mutation_source().make_reader(s));
+            for (auto& m : muts) {
+                assertions.produces(m);
+            }
+            assertions.produces_end_of_stream();
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_split_block_bloom_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        for (const auto version : all_sstable_versions) {
+            auto s = schema_builder("tests", "split_block_filter_test")
+                    .with_column("pk", int32_type, column_kind::partition_key)
+                    .with_column("v", int32_type)
+                    .build();
+
+            std::vector<mutation> muts;
+            for (int pk = 0; pk < 1000; ++pk) {
+                mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+                m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(pk), api::new_timestamp());
+                muts.push_back(std::move(m));
+            }
+            std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+
+            auto tmp = tmpdir();
+            sstable_writer_config cfg;
+            cfg.split_block_filter = true;
+            auto sst = make_sstable_easy(env, tmp.path(), flat_mutation_reader_from_mutations(muts), cfg, version);
+
+            BOOST_REQUIRE(dynamic_cast<utils::filter::split_block_bloom_filter*>(&sstables::test(sst).get_filter()));
+            for (auto& m : muts) {
+                BOOST_REQUIRE(sst->filter_has_key(*s, m.decorated_key()));
+            }
+            unsigned false_positives = 0;
+            for (int pk = 1000; pk < 11000; ++pk) {
+                auto dk = dht::global_partitioner().decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+                false_positives += sst->filter_has_key(*s, dk);
+            }
+            // The default bloom_filter_fp_chance is 0.01.
+            BOOST_REQUIRE_LT(false_positives, 300);
+
+            auto assertions = assert_that(sst->as_mutation_source().make_reader(s));
+            for (auto& m : muts) {
+                assertions.produces(m);
+            }
+            assertions.produces_end_of_stream();
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_partition_trie_index) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        auto s = schema_builder("tests", "partition_trie_test")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto make_key = [&] (int pk) {
+            return dht::global_partitioner().decorate_key(*s, partition_key::from_single_value(*s, utf8_type->decompose(format("key{:d}", pk))));
+        };
+
+        // Enough partitions for the trie to span several pages.
+        std::vector<mutation> muts;
+        for (int pk = 0; pk < 5000; ++pk) {
+            mutation m(s, make_key(pk));
+            for (int ck = 0; ck < pk % 3; ++ck) {
+                m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), "v", data_value(pk), api::new_timestamp());
+            }
+            if (pk % 3 == 0) {
+                m.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+            }
+            muts.push_back(std::move(m));
+        }
+        std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+
+        auto tmp = tmpdir();
+        sstable_writer_config cfg;
+        cfg.partition_trie_index = true;
+        auto sst = make_sstable_easy(env, tmp.path(), flat_mutation_reader_from_mutations(muts), cfg, sstable_version_types::mc);
+        BOOST_REQUIRE(sst->has_component(component_type::PartitionIndex));
+        BOOST_REQUIRE(sst->get_partition_trie());
+
+        auto ms = sst->as_mutation_source();
+        for (auto& m : muts) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            assert_that(ms.make_reader(s, pr))
+                .produces(m)
+                .produces_end_of_stream();
+            auto hk = sstables::sstable::make_hashed_key(*s, m.key());
+            BOOST_REQUIRE(sst->has_partition_key(hk, m.decorated_key()).get0());
+        }
+        for (int pk = 5000; pk < 6000; ++pk) {
+            auto dk = make_key(pk);
+            auto pr = dht::partition_range::make_singular(dk);
+            assert_that(ms.make_reader(s, pr)).produces_end_of_stream();
+            auto hk = sstables::sstable::make_hashed_key(*s, dk.key());
+            BOOST_REQUIRE(!sst->has_partition_key(hk, dk).get0());
+        }
+
+        // Range reads still go through the (sparser) summary.
+        auto assertions = assert_that(ms.make_reader(s));
+        for (auto& m : muts) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(test_repeated_tombstone_skipping) {
     return test_env::do_with_async([] (test_env& env) {
       for (const auto version : all_sstable_versions) {
@@ -4120,6 +4266,7 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
         auto descriptor = cs.get_sstables_for_compaction(*cf, { sst });
         BOOST_REQUIRE(descriptor.sstables.size() == 1);
         BOOST_REQUIRE(descriptor.sstables.front() == sst);
+        BOOST_REQUIRE(descriptor.tombstone_compaction);
 
         cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::leveled, options);
         sst->set_sstable_level(1);
@@ -4154,6 +4301,22 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
             sstables::test(sst).set_data_file_write_time(db_clock::now());
             auto descriptor = cs.get_sstables_for_compaction(*cf, { sst });
             BOOST_REQUIRE(descriptor.sstables.size() == 0);
+            sstables::test(sst).set_data_file_write_time(db_clock::time_point::min());
+        }
+        // sstable won't be included if most of its keys are also in another sstable, which its
+        // tombstones may shadow, unless overlap checking is disabled.
+        {
+            column_family_test(cf).add_sstable(info.new_sstables.front());
+            auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options);
+            auto descriptor = cs.get_sstables_for_compaction(*cf, { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 0);
+
+            auto unchecked_options = options;
+            unchecked_options.emplace("unchecked_tombstone_compaction", "true");
+            cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, unchecked_options);
+            descriptor = cs.get_sstables_for_compaction(*cf, { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 1);
+            BOOST_REQUIRE(descriptor.sstables.front() == sst);
         }
     });
 }
@@ -4852,6 +5015,299 @@ SEASTAR_TEST_CASE(sstable_run_based_compaction_test) {
     });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto builder = schema_builder("tests", "incremental_compaction_strategy_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        builder.set_min_compaction_threshold(2);
+        builder.set_compaction_strategy_options({{ "sstable_size_in_mb", "1" }});
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, column_family_test_config(), column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf->mark_ready_for_writes();
+        cf->start();
+        cf->set_compaction_strategy(sstables::compaction_strategy_type::incremental);
+
+        auto tokens = token_generation_for_current_shard(32);
+        auto make_fragment = [&] (utils::UUID run_identifier, std::vector<size_t> indexes) {
+            std::vector<mutation> mutations;
+            for (auto i : indexes) {
+                auto key = partition_key::from_exploded(*s, {to_bytes(tokens[i].first)});
+                mutation m(s, key);
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 1 /* ts */);
+                mutations.push_back(std::move(m));
+            }
+            auto sst = sst_gen();
+            sstable_writer_config cfg;
+            cfg.run_identifier = run_identifier;
+            sst->write_components(flat_mutation_reader_from_mutations(std::move(mutations)), indexes.size(), s, cfg, encoding_stats{}).get();
+            sst->load().get();
+            column_family_test(cf).add_sstable(sst);
+            return sst;
+        };
+
+        // Run A holds the even tokens and run B the odd ones. Their fragments are shifted
+        // against each other, so that each fragment overlaps two fragments of the other run.
+        std::vector<shared_sstable> input;
+        auto run_a = utils::make_random_uuid();
+        auto run_b = utils::make_random_uuid();
+        input.push_back(make_fragment(run_b, {1, 3}));
+        for (size_t i = 0; i < 4; i++) {
+            input.push_back(make_fragment(run_a, {8 * i, 8 * i + 2, 8 * i + 4, 8 * i + 6}));
+        }
+        for (size_t i = 0; i < 3; i++) {
+            input.push_back(make_fragment(run_b, {8 * i + 5, 8 * i + 7, 8 * i + 9, 8 * i + 11}));
+        }
+        input.push_back(make_fragment(run_b, {29, 31}));
+
+        auto cs = cf->get_compaction_strategy();
+        auto desc = cs.get_sstables_for_compaction(*cf, input);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), input.size());
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, uint64_t(1024 * 1024));
+        BOOST_REQUIRE_EQUAL(cs.get_major_compaction_job(*cf, input).max_sstable_bytes, uint64_t(1024 * 1024));
+
+        // Write a fragment per partition, so that inputs can be released as soon as they are exhausted.
+        desc.max_sstable_bytes = 0;
+        auto run_identifier = desc.run_identifier;
+        std::unordered_set<shared_sstable> released;
+        size_t written = 0;
+        std::optional<size_t> written_at_first_release;
+        auto replacer = [&] (std::vector<shared_sstable> old_sstables, std::vector<shared_sstable> new_sstables) {
+            written += new_sstables.size();
+            if (!written_at_first_release) {
+                written_at_first_release = written;
+            }
+            for (auto& sst : old_sstables) {
+                BOOST_REQUIRE(released.insert(sst).second);
+            }
+        };
+        auto info = sstables::compact_sstables(std::move(desc), *cf, sst_gen, replacer).get0();
+
+        BOOST_REQUIRE_EQUAL(released.size(), input.size());
+        BOOST_REQUIRE_EQUAL(info.new_sstables.size(), tokens.size());
+        // Inputs are released as soon as they are exhausted, although every one of them overlaps
+        // an input which isn't yet, because no tombstone was purged.
+        BOOST_REQUIRE(written_at_first_release);
+        BOOST_REQUIRE_LE(*written_at_first_release, 8u);
+        for (auto& sst : info.new_sstables) {
+            BOOST_REQUIRE(sst->run_identifier() == run_identifier);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(parallel_compaction_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto builder = schema_builder("tests", "parallel_compaction_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, column_family_test_config(), column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf->mark_ready_for_writes();
+        cf->start();
+
+        auto make_insert = [&] (auto p) {
+            auto key = partition_key::from_exploded(*s, {to_bytes(p.first)});
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 1 /* ts */);
+            return m;
+        };
+
+        // 4 sstables spanning the whole token range of the shard, overlapping each other.
+        auto tokens = token_generation_for_current_shard(64);
+        std::vector<shared_sstable> input;
+        for (auto i = 0U; i < 4; i++) {
+            std::vector<mutation> mutations;
+            for (auto j = i; j < tokens.size(); j += 4) {
+                mutations.push_back(make_insert(tokens[j]));
+            }
+            input.push_back(make_sstable_containing(sst_gen, std::move(mutations)));
+        }
+
+        auto replacements = 0U;
+        auto replacer = [&] (std::vector<shared_sstable> old_sstables, std::vector<shared_sstable> new_sstables) {
+            replacements++;
+            // inputs are only replaced when all the sub-ranges are compacted.
+            BOOST_REQUIRE_EQUAL(old_sstables.size(), 4);
+            BOOST_REQUIRE(!new_sstables.empty());
+        };
+
+        auto descriptor = sstables::compaction_descriptor(input);
+        descriptor.parallelism = 4;
+        auto run_identifier = descriptor.run_identifier;
+        auto info = sstables::compact_sstables(std::move(descriptor), *cf, sst_gen, replacer).get0();
+
+        BOOST_REQUIRE_EQUAL(replacements, 1);
+        BOOST_REQUIRE_EQUAL(info.total_keys_written, tokens.size());
+        auto output = info.new_sstables;
+        BOOST_REQUIRE(output.size() > 1);
+        BOOST_REQUIRE(output.size() <= 4);
+
+        // outputs form a single run of non-overlapping sstables.
+        std::sort(output.begin(), output.end(), [&s] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_first_decorated_key().tri_compare(*s, b->get_first_decorated_key()) < 0;
+        });
+        for (auto i = 0U; i < output.size(); i++) {
+            BOOST_REQUIRE(output[i]->run_identifier() == run_identifier);
+            if (i > 0) {
+                BOOST_REQUIRE(output[i - 1]->get_last_decorated_key().tri_compare(*s, output[i]->get_first_decorated_key()) < 0);
+            }
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(leveled_compaction_moves_non_overlapping_sstables_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto builder = schema_builder("tests", "leveled_compaction_moves_non_overlapping_sstables_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, column_family_test_config(), column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf->mark_ready_for_writes();
+        cf->start();
+        cf->set_compaction_strategy(sstables::compaction_strategy_type::leveled);
+
+        auto make_insert = [&] (auto p) {
+            auto key = partition_key::from_exploded(*s, {to_bytes(p.first)});
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 1 /* ts */);
+            return m;
+        };
+        auto make_sstable = [&] (std::vector<mutation> mutations, uint32_t level) {
+            auto sst = make_sstable_containing(sst_gen, std::move(mutations));
+            sst->set_sstable_level(level);
+            column_family_test(cf).add_sstable(sst);
+            return sst;
+        };
+
+        auto tokens = token_generation_for_current_shard(4);
+        // sst1 doesn't overlap with any other sstable, while sst2 overlaps with sst3.
+        auto sst1 = make_sstable({make_insert(tokens[0])}, 0);
+        auto sst2 = make_sstable({make_insert(tokens[2]), make_insert(tokens[3])}, 0);
+        auto sst3 = make_sstable({make_insert(tokens[3])}, 1);
+
+        std::vector<shared_sstable> replaced;
+        auto replacer = [&] (std::vector<shared_sstable> old_sstables, std::vector<shared_sstable> new_sstables) {
+            std::move(old_sstables.begin(), old_sstables.end(), std::back_inserter(replaced));
+        };
+
+        auto descriptor = sstables::compaction_descriptor({ sst1, sst2, sst3 }, 1);
+        descriptor.allow_sstable_moves = true;
+        auto info = sstables::compact_sstables(std::move(descriptor), *cf, sst_gen, replacer).get0();
+
+        BOOST_REQUIRE_EQUAL(sst1->get_sstable_level(), 1u);
+        BOOST_REQUIRE(std::find(replaced.begin(), replaced.end(), sst1) == replaced.end());
+        BOOST_REQUIRE(std::find(replaced.begin(), replaced.end(), sst2) != replaced.end());
+        BOOST_REQUIRE(std::find(replaced.begin(), replaced.end(), sst3) != replaced.end());
+        BOOST_REQUIRE_EQUAL(info.total_keys_written, 2u);
+        BOOST_REQUIRE(cf->get_sstables()->count(sst1));
+
+        // the new level is persisted.
+        auto reopened = env.reusable_sst(s, tmp.path().string(), sst1->generation()).get0();
+        BOOST_REQUIRE_EQUAL(reopened->get_sstable_level(), 1u);
+    });
+}
+
+SEASTAR_TEST_CASE(leveled_compaction_does_not_move_sstables_inside_compacted_span_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto builder = schema_builder("tests", "leveled_compaction_does_not_move_sstables_inside_compacted_span_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, column_family_test_config(), column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf->mark_ready_for_writes();
+        cf->start();
+        cf->set_compaction_strategy(sstables::compaction_strategy_type::leveled);
+
+        auto make_insert = [&] (auto p) {
+            auto key = partition_key::from_exploded(*s, {to_bytes(p.first)});
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 1 /* ts */);
+            return m;
+        };
+        auto make_sstable = [&] (std::vector<mutation> mutations, uint32_t level) {
+            auto sst = make_sstable_containing(sst_gen, std::move(mutations));
+            sst->set_sstable_level(level);
+            column_family_test(cf).add_sstable(sst);
+            return sst;
+        };
+
+        auto tokens = token_generation_for_current_shard(6);
+        // sst_m overlaps no other input, but lies between sst_a and sst_c, which are
+        // compacted because they overlap the level 1 inputs. Their output spans sst_m.
+        auto sst_a = make_sstable({make_insert(tokens[0]), make_insert(tokens[1])}, 0);
+        auto sst_m = make_sstable({make_insert(tokens[2]), make_insert(tokens[3])}, 0);
+        auto sst_c = make_sstable({make_insert(tokens[4]), make_insert(tokens[5])}, 0);
+        auto sst_x = make_sstable({make_insert(tokens[0])}, 1);
+        auto sst_y = make_sstable({make_insert(tokens[5])}, 1);
+
+        std::vector<shared_sstable> replaced;
+        auto replacer = [&] (std::vector<shared_sstable> old_sstables, std::vector<shared_sstable> new_sstables) {
+            std::move(old_sstables.begin(), old_sstables.end(), std::back_inserter(replaced));
+        };
+
+        auto descriptor = sstables::compaction_descriptor({ sst_a, sst_m, sst_c, sst_x, sst_y }, 1);
+        descriptor.allow_sstable_moves = true;
+        auto info = sstables::compact_sstables(std::move(descriptor), *cf, sst_gen, replacer).get0();
+
+        BOOST_REQUIRE_EQUAL(sst_m->get_sstable_level(), 0u);
+        BOOST_REQUIRE_EQUAL(replaced.size(), 5u);
+        BOOST_REQUIRE(std::find(replaced.begin(), replaced.end(), sst_m) != replaced.end());
+        BOOST_REQUIRE_EQUAL(info.total_keys_written, 6u);
+    });
+}
+
 SEASTAR_TEST_CASE(compaction_strategy_aware_major_compaction_test) {
     return test_env::do_with_async([] (test_env& env) {
         storage_service_for_tests ssft;
@@ -5042,3 +5498,48 @@ SEASTAR_TEST_CASE(basic_interval_map_testing_for_sstable_set) {
 
     return make_ready_future<>();
 }
+
+SEASTAR_TEST_CASE(sstable_validate_checksums_test) {
+    return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
+        return seastar::async([&env, tmpdir_path] {
+            int64_t generation = 1;
+            for (auto version : all_sstable_versions) {
+                for (auto c : {compressor_ptr(), compressor::lz4}) {
+                    schema_builder builder(some_keyspace, some_column_family);
+                    builder.with_column("p1", utf8_type, column_kind::partition_key);
+                    builder.with_column("r1", bytes_type);
+                    if (c) {
+                        builder.set_compressor_params(c);
+                    } else {
+                        builder.set_compressor_params(compression_parameters::no_compression());
+                    }
+                    auto s = builder.build();
+                    auto& cdef = *s->get_column_definition("r1");
+
+                    auto mt = make_lw_shared<memtable>(s);
+                    for (auto i = 0; i < 100; i++) {
+                        mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+                        m.set_clustered_cell(clustering_key::make_empty(), cdef, make_atomic_cell(bytes_type, to_bytes(make_random_string(1000))));
+                        mt->apply(std::move(m));
+                    }
+                    auto gen = generation++;
+                    auto sst = env.make_sstable(s, tmpdir_path, gen, version, big);
+                    write_memtable_to_sstable_for_test(*mt, sst).get();
+                    sst = env.reusable_sst(s, tmpdir_path, gen, version).get0();
+                    sst->validate_checksums(default_priority_class()).get();
+
+                    // Flip a byte of the first chunk of the data file.
+                    auto f = open_file_dma(sst->get_filename(), open_flags::rw).get0();
+                    auto buf = f.dma_read_exactly<char>(0, 4096).get0();
+                    buf.get_write()[100] ^= 0xff;
+                    f.dma_write(0, buf.get(), buf.size()).get();
+                    f.flush().get();
+                    f.close().get();
+
+                    sst = env.reusable_sst(s, tmpdir_path, gen, version).get0();
+                    BOOST_REQUIRE_THROW(sst->validate_checksums(default_priority_class()).get(), std::exception);
+                }
+            }
+        });
+    });
+}
@@ -125,6 +125,14 @@ class test {
         return _sst->_components->summary;
     }
 
+    const compression& get_compression() {
+        return _sst->_components->compression;
+    }
+
+    utils::i_filter& get_filter() {
+        return *_sst->_components->filter;
+    }
+
     summary move_summary() {
         return std::move(_sst->_components->summary);
     }
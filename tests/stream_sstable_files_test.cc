@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/core/thread.hh>
+#include <seastar/testing/test_case.hh>
+
+#include "database.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstable_version.hh"
+#include "streaming/stream_session.hh"
+#include "streaming/stream_transfer_task.hh"
+#include "tests/cql_test_env.hh"
+#include "tests/cql_assertions.hh"
+#include "tests/eventually.hh"
+
+using sstable_file_chunk = streaming::stream_session::sstable_file_chunk;
+
+static void create_tables(cql_test_env& e) {
+    e.execute_cql("create table src (p int, c int, v text, primary key (p, c));").get();
+    e.execute_cql("create table dst (p int, c int, v text, primary key (p, c));").get();
+    for (int p = 0; p < 100; ++p) {
+        for (int c = 0; c < 10; ++c) {
+            e.execute_cql(format("insert into src (p, c, v) values ({}, {}, '{}');", p, c, sstring(100, 'a' + c))).get();
+        }
+    }
+    e.db().invoke_on_all([] (database& db) {
+        return db.flush_all_memtables();
+    }).get();
+}
+
+// Sends the components like STREAM_SSTABLE_FILES does, collecting the chunks.
+static std::vector<sstable_file_chunk> send(std::vector<streaming::sstable_component_file> components) {
+    std::vector<sstable_file_chunk> chunks;
+    streaming::send_sstable_components(std::move(components), [&chunks] (const sstring& name, uint64_t size, bytes chunk) {
+        chunks.emplace_back(name, size, std::move(chunk));
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }).get();
+    return chunks;
+}
+
+static streaming::stream_session::sstable_file_source make_source(std::vector<sstable_file_chunk> chunks) {
+    return [chunks = std::move(chunks), i = size_t(0)] () mutable {
+        if (i == chunks.size()) {
+            return make_ready_future<std::optional<sstable_file_chunk>>();
+        }
+        return make_ready_future<std::optional<sstable_file_chunk>>(chunks[i++]);
+    };
+}
+
+SEASTAR_TEST_CASE(test_stream_sstable_files) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        create_tables(e);
+        e.db().invoke_on_all([] (database& db) {
+            return seastar::async([&db] {
+                auto& src = db.find_column_family("ks", "src");
+                auto& dst = db.find_column_family("ks", "dst");
+                auto sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(*src.get_sstables());
+                std::vector<std::vector<streaming::sstable_component_file>> components;
+                for (auto& sst : sstables) {
+                    components.push_back(streaming::open_sstable_components(sst).get0());
+                    BOOST_REQUIRE_EQUAL(components.back().size(), sst->all_components().size());
+                }
+
+                // Compaction deletes the sstables before they are sent.
+                src.compact_all_sstables().get();
+                eventually([&sstables] {
+                    for (auto& sst : sstables) {
+                        BOOST_REQUIRE(!file_exists(sst->get_filename()).get0());
+                    }
+                });
+
+                for (size_t i = 0; i < sstables.size(); ++i) {
+                    auto& sst = sstables[i];
+                    auto chunks = send(std::move(components[i]));
+                    auto toc = sstables::sstable_version_constants::get_component_map(sst->get_version()).at(sstables::component_type::TOC);
+                    BOOST_REQUIRE(!chunks.empty());
+                    BOOST_REQUIRE_EQUAL(std::get<0>(chunks.front()), toc);
+
+                    auto generation = dst.calculate_generation_for_new_table();
+                    streaming::stream_session::receive_sstable_files(make_source(std::move(chunks)), dst.schema(), dst.dir(), generation, sst->get_version()).get();
+                    streaming::stream_session::add_received_sstable(dst.shared_from_this(), dst.dir(), generation, sst->get_version(),
+                            streaming::stream_reason::rebuild, false).get();
+                }
+            });
+        }).get();
+
+        auto expected = e.execute_cql("select * from src;").get0();
+        auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(expected);
+        BOOST_REQUIRE(rows);
+        auto& expected_rows = rows->rs().result_set().rows();
+        BOOST_REQUIRE_EQUAL(expected_rows.size(), 1000u);
+        std::vector<std::vector<bytes_opt>> expected_values(expected_rows.begin(), expected_rows.end());
+        assert_that(e.execute_cql("select * from dst;").get0()).is_rows().with_rows_ignore_order(std::move(expected_values));
+    });
+}
+
+SEASTAR_TEST_CASE(test_receive_sstable_files_with_wrong_size) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        create_tables(e);
+        e.db().invoke_on_all([] (database& db) {
+            return seastar::async([&db] {
+                auto& src = db.find_column_family("ks", "src");
+                auto& dst = db.find_column_family("ks", "dst");
+                for (auto& sst : *src.get_sstables()) {
+                    auto chunks = send(streaming::open_sstable_components(sst).get0());
+                    // Announce a larger size for the last component than what is sent.
+                    auto last = std::get<0>(chunks.back());
+                    for (auto& chunk : chunks) {
+                        if (std::get<0>(chunk) == last) {
+                            std::get<1>(chunk) += 1;
+                        }
+                    }
+
+                    auto generation = dst.calculate_generation_for_new_table();
+                    auto s = dst.schema();
+                    BOOST_REQUIRE_THROW(streaming::stream_session::receive_sstable_files(make_source(std::move(chunks)), s, dst.dir(), generation,
+                            sst->get_version()).get(), std::runtime_error);
+                    for (auto& c : sst->all_components()) {
+                        auto name = sstables::sstable::filename(dst.dir(), s->ks_name(), s->cf_name(), sst->get_version(), generation,
+                                sstables::sstable::format_types::big, c.second);
+                        BOOST_REQUIRE(!file_exists(name).get0());
+                    }
+                    auto temporary_toc = sstables::sstable::filename(dst.dir(), s->ks_name(), s->cf_name(), sst->get_version(), generation,
+                            sstables::sstable::format_types::big, sstables::component_type::TemporaryTOC);
+                    BOOST_REQUIRE(!file_exists(temporary_toc).get0());
+                }
+            });
+        }).get();
+
+        assert_that(e.execute_cql("select * from dst;").get0()).is_rows().is_empty();
+    });
+}
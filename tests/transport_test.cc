@@ -19,11 +19,23 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <zstd.h>
+
+#include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/byteorder.hh>
+#include <seastar/net/api.hh>
+#include <seastar/util/defer.hh>
 
 #include "transport/request.hh"
 #include "transport/response.hh"
+#include "transport/server.hh"
+#include "service/storage_proxy.hh"
+#include "cql3/query_processor.hh"
+#include "timeout_config.hh"
 
+#include "tests/cql_test_env.hh"
+#include "tests/cql_assertions.hh"
 #include "random-utils.hh"
 
 SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
@@ -113,3 +125,192 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     auto received_string_map = req.read_string_map();
     BOOST_CHECK_EQUAL(received_string_map, string_unordered_map);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_response_zstd_compression) {
+    static constexpr auto version = 4;
+    auto stream_id = tests::random::get_int<int16_t>();
+
+    // Large enough for the body to span several fragments, partly compressible.
+    auto values = boost::copy_range<std::vector<bytes>>(
+        boost::irange(0, 64)
+        | boost::adaptors::transformed([] (int i) {
+            auto size = tests::random::get_int<size_t>(16 * 1024);
+            return i % 2 ? tests::random::get_bytes(size) : bytes(size, int8_t(i));
+        })
+    );
+    auto make_message = [&] (cql_transport::cql_compression compression) {
+        auto res = cql_transport::response(stream_id, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+        for (auto& value : values) {
+            res.write_value(bytes_opt(value));
+        }
+        auto msg = res.make_message(version, compression).release();
+        bytes_ostream out;
+        for (auto& buf : msg.release()) {
+            out.write(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+        }
+        return to_bytes(out.linearize());
+    };
+
+    static constexpr auto header_size = 9;
+    auto plain = make_message(cql_transport::cql_compression::none);
+    auto compressed = make_message(cql_transport::cql_compression::zstd);
+    BOOST_CHECK_EQUAL(unsigned(plain[1]), 0);
+    BOOST_CHECK_EQUAL(unsigned(compressed[1]), unsigned(cql_transport::cql_frame_flags::compression));
+    BOOST_REQUIRE_LT(compressed.size(), plain.size());
+
+    auto body = bytes(bytes::initialized_later(), plain.size() - header_size);
+    auto ret = ZSTD_decompress(body.begin(), body.size(), compressed.begin() + header_size, compressed.size() - header_size);
+    BOOST_REQUIRE(!ZSTD_isError(ret));
+    BOOST_REQUIRE_EQUAL(ret, body.size());
+    BOOST_CHECK_EQUAL(body, to_bytes(bytes_view(plain).substr(header_size)));
+}
+
+namespace {
+
+// Speaks version 4 of the protocol over a connection of its own, so that
+// requests go through cql_server like those of a real driver.
+class cql_client {
+    static constexpr uint8_t version = 4;
+    static constexpr size_t header_size = 9;
+    connected_socket _socket;
+    input_stream<char> _in;
+    output_stream<char> _out;
+public:
+    explicit cql_client(socket_address addr)
+        : _socket(connect(addr).get0())
+        , _in(_socket.input())
+        , _out(_socket.output()) {
+    }
+    ~cql_client() {
+        _out.close().get();
+        _in.close().get();
+    }
+    // Sends the request whose body was written by fill, returns the opcode
+    // and the body of the response.
+    std::pair<cql_transport::cql_binary_opcode, bytes> request(cql_transport::cql_binary_opcode op,
+            std::function<void(cql_transport::response&)> fill) {
+        auto req = cql_transport::response(0, op, tracing::trace_state_ptr());
+        fill(req);
+        auto msg = req.make_message(version, cql_transport::cql_compression::none).release();
+        bytes_ostream out;
+        for (auto& buf : msg.release()) {
+            out.write(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+        }
+        auto frame = to_bytes(out.linearize());
+        // Requests are sent with the direction bit of the version cleared.
+        frame[0] = version;
+        _out.write(reinterpret_cast<const char*>(frame.data()), frame.size()).get();
+        _out.flush().get();
+
+        auto header = _in.read_exactly(header_size).get0();
+        BOOST_REQUIRE_EQUAL(header.size(), header_size);
+        auto res_op = cql_transport::cql_binary_opcode(uint8_t(header[4]));
+        auto length = read_be<int32_t>(header.get() + 5);
+        auto body = _in.read_exactly(length).get0();
+        BOOST_REQUIRE_EQUAL(body.size(), size_t(length));
+        return std::make_pair(res_op, bytes(reinterpret_cast<const int8_t*>(body.get()), body.size()));
+    }
+    void startup() {
+        auto res = request(cql_transport::cql_binary_opcode::STARTUP, [] (cql_transport::response& r) {
+            r.write_string_map({{"CQL_VERSION", "3.0.0"}});
+        });
+        BOOST_REQUIRE(res.first == cql_transport::cql_binary_opcode::READY);
+    }
+    bytes prepare(const sstring& query) {
+        auto res = request(cql_transport::cql_binary_opcode::PREPARE, [&query] (cql_transport::response& r) {
+            r.write_long_string(query);
+        });
+        BOOST_REQUIRE(res.first == cql_transport::cql_binary_opcode::RESULT);
+        // The body starts with the kind of the result, then the id.
+        auto id_length = read_be<uint16_t>(reinterpret_cast<const char*>(res.second.data()) + 4);
+        return bytes(res.second.data() + 6, id_length);
+    }
+    cql_transport::cql_binary_opcode execute(const bytes& id, const std::vector<bytes>& values, const std::vector<sstring>& names = {}) {
+        return request(cql_transport::cql_binary_opcode::EXECUTE, [&] (cql_transport::response& r) {
+            r.write_short_bytes(id);
+            r.write_consistency(db::consistency_level::ONE);
+            r.write_byte(names.empty() ? 0x01 : 0x41);
+            r.write_short(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (!names.empty()) {
+                    r.write_string(names[i]);
+                }
+                r.write_value(bytes_opt(values[i]));
+            }
+        }).first;
+    }
+};
+
+}
+
+SEASTAR_TEST_CASE(test_owning_shard_load_balancing) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.t (a int, b int, v int, primary key ((a, b)));").get();
+        auto s = e.local_db().find_schema("ks", "t");
+
+        sharded<cql_transport::cql_server> server;
+        cql_transport::cql_server_config config;
+        config.timeout_config = infinite_timeout_config;
+        config.max_request_size = 1 << 20;
+        server.start(std::ref(service::get_storage_proxy()), std::ref(e.qp()), cql_transport::cql_load_balance::owning_shard,
+                std::ref(e.auth_service()), config).get();
+        auto stop_server = defer([&server] { server.stop().get(); });
+        auto addr = socket_address(ipv4_addr("127.0.0.1", 19042));
+        server.invoke_on_all(&cql_transport::cql_server::listen, addr, std::shared_ptr<seastar::tls::credentials_builder>(), false).get();
+
+        auto forwarded = [&server] {
+            return server.map_reduce0(std::mem_fn(&cql_transport::cql_server::requests_forwarded_to_owning_shard), uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto accepted = [&server] {
+            return server.map_reduce0(std::mem_fn(&cql_transport::cql_server::requests_accepted_on_owning_shard), uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto int_value = [] (int32_t v) { return int32_type->decompose(v); };
+
+        // Pick keys owned by every shard, so that whichever shard accepts
+        // the connection, some requests are forwarded and some are not.
+        std::vector<int32_t> keys;
+        std::set<unsigned> shards;
+        for (int32_t k = 0; shards.size() < smp::count; ++k) {
+            auto key = partition_key::from_exploded(*s, {int_value(k), int_value(0)});
+            shards.insert(dht::shard_of(dht::global_partitioner().get_token(*s, key)));
+            keys.push_back(k);
+        }
+
+        {
+            cql_client client(addr);
+            client.startup();
+
+            auto insert = client.prepare("insert into ks.t (a, b, v) values (?, ?, ?);");
+            for (auto k : keys) {
+                BOOST_REQUIRE(client.execute(insert, {int_value(k), int_value(0), int_value(k)}) == cql_transport::cql_binary_opcode::RESULT);
+            }
+            BOOST_REQUIRE_EQUAL(forwarded() + accepted(), keys.size());
+            BOOST_REQUIRE_GT(accepted(), 0);
+            if (smp::count > 1) {
+                BOOST_REQUIRE_GT(forwarded(), 0);
+            }
+            for (auto k : keys) {
+                auto msg = e.execute_cql(format("select v from ks.t where a = {:d} and b = 0;", k)).get0();
+                assert_that(msg).is_rows().with_rows({{int_value(k)}});
+            }
+
+            // Requests which can't be routed are processed where they were
+            // accepted, and aren't counted.
+            auto routed = forwarded() + accepted();
+
+            auto named_insert = client.prepare("insert into ks.t (a, b, v) values (:a, :b, :v);");
+            BOOST_REQUIRE(client.execute(named_insert, {int_value(1), int_value(1), int_value(1)}, {"a", "b", "v"}) == cql_transport::cql_binary_opcode::RESULT);
+            BOOST_REQUIRE_EQUAL(forwarded() + accepted(), routed);
+
+            auto incomplete_key = client.prepare("select v from ks.t where a = ? and b = 0;");
+            BOOST_REQUIRE(client.execute(incomplete_key, {int_value(keys.front())}) == cql_transport::cql_binary_opcode::RESULT);
+            BOOST_REQUIRE_EQUAL(forwarded() + accepted(), routed);
+
+            // Before STARTUP the connection is not authenticated, so the
+            // request is rejected by the shard which accepted it.
+            cql_client unauthenticated(addr);
+            BOOST_REQUIRE(unauthenticated.execute(insert, {int_value(2), int_value(2), int_value(2)}) == cql_transport::cql_binary_opcode::ERROR);
+            BOOST_REQUIRE_EQUAL(forwarded() + accepted(), routed);
+        }
+    });
+}
@@ -22,6 +22,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "database.hh"
+#include "db/config.hh"
 #include "db/view/view_builder.hh"
 #include "db/system_keyspace.hh"
 
@@ -164,6 +165,55 @@ SEASTAR_TEST_CASE(test_builder_with_multiple_partitions_of_batch_size_rows) {
     });
 }
 
+SEASTAR_TEST_CASE(test_builder_with_large_batch_size) {
+    auto db_cfg = make_shared<db::config>();
+    db_cfg->view_building_batch_size(4096);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        for (auto i = 0; i < 1024; ++i) {
+            e.execute_cql(format("insert into cf (p, c, v) values ({:d}, {:d}, 0)", i % 5, i)).get();
+        }
+        e.local_db().flush_all_memtables().get();
+
+        auto f = e.local_view_builder().wait_until_built("ks", "vcf");
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+
+        f.get();
+        auto msg = e.execute_cql("select count(*) from vcf where v = 0").get0();
+        assert_that(msg).is_rows().with_size(1);
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(1024L)}}});
+    }, db_cfg);
+}
+
+SEASTAR_TEST_CASE(test_builder_throttled) {
+    auto db_cfg = make_shared<db::config>();
+    db_cfg->view_building_throughput_mb_per_sec(1);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        for (auto i = 0; i < 4096; ++i) {
+            e.execute_cql(format("insert into cf (p, c, v) values (0, {:d}, 0)", i)).get();
+        }
+        e.local_db().flush_all_memtables().get();
+
+        auto f = e.local_view_builder().wait_until_built("ks", "vcf");
+        auto start = std::chrono::steady_clock::now();
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+
+        f.get();
+        // Each row takes well over 64 bytes in memory, and all but the last
+        // of the 32 steps are paid for before the next one starts.
+        BOOST_REQUIRE(std::chrono::steady_clock::now() - start >= 200ms);
+        auto msg = e.execute_cql("select count(*) from vcf where v = 0").get0();
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(4096L)}}});
+    }, db_cfg);
+}
+
 SEASTAR_TEST_CASE(test_builder_view_added_during_ongoing_build) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
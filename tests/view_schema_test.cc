@@ -4370,3 +4370,90 @@ SEASTAR_TEST_CASE(test_mv_allow_some_column_drops) {
         BOOST_REQUIRE_THROW(e.execute_cql("alter table cf2 drop d").get(), exceptions::invalid_request_exception);
     });
 }
+
+SEASTAR_TEST_CASE(test_coalesced_view_updates) {
+    auto db_cfg = make_shared<db::config>();
+    db_cfg->view_update_coalescing_window_in_ms(1000);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+        e.execute_cql("create materialized view mv as select * from cf "
+                      "where p is not null and c is not null and v is not null primary key (p, v, c)").get();
+
+        // Each update replaces the view row created by the previous one. All of them are
+        // merged into a single update of the view partition.
+        for (auto v : {1, 2, 3}) {
+            e.execute_cql(format("update cf set v = {} where p = 0 and c = 0", v)).get();
+        }
+        e.execute_cql("update cf set v = 4 where p = 0 and c = 1").get();
+
+        eventually([&] {
+            auto msg = e.execute_cql("select p, v, c from mv").get0();
+            assert_that(msg).is_rows().with_rows_ignore_order({
+                {{int32_type->decompose(0)}, {int32_type->decompose(3)}, {int32_type->decompose(0)}},
+                {{int32_type->decompose(0)}, {int32_type->decompose(4)}, {int32_type->decompose(1)}},
+            });
+        });
+        auto& stats = e.local_db().find_column_family("ks", "cf").get_view_stats();
+        BOOST_REQUIRE_EQUAL(stats.view_updates_coalesced, 3);
+        BOOST_REQUIRE_EQUAL(stats.view_updates_pushed_local, 1);
+    }, db_cfg);
+}
+
+SEASTAR_TEST_CASE(test_uncoalesced_view_updates) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+        e.execute_cql("create materialized view mv as select * from cf "
+                      "where p is not null and c is not null and v is not null primary key (p, v, c)").get();
+
+        // Without a coalescing window, each base write sends its own view update.
+        for (auto v : {1, 2, 3}) {
+            e.execute_cql(format("update cf set v = {} where p = 0 and c = 0", v)).get();
+        }
+        e.execute_cql("update cf set v = 4 where p = 0 and c = 1").get();
+
+        eventually([&] {
+            auto msg = e.execute_cql("select p, v, c from mv").get0();
+            assert_that(msg).is_rows().with_rows_ignore_order({
+                {{int32_type->decompose(0)}, {int32_type->decompose(3)}, {int32_type->decompose(0)}},
+                {{int32_type->decompose(0)}, {int32_type->decompose(4)}, {int32_type->decompose(1)}},
+            });
+        });
+        auto& stats = e.local_db().find_column_family("ks", "cf").get_view_stats();
+        BOOST_REQUIRE_EQUAL(stats.view_updates_coalesced, 0);
+        BOOST_REQUIRE_EQUAL(stats.view_updates_pushed_local, 4);
+    });
+}
+
+SEASTAR_TEST_CASE(test_batched_view_update_reads) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+        e.execute_cql("create materialized view mv as select * from cf "
+                      "where p is not null and c is not null and v is not null primary key (p, v, c)").get();
+        e.execute_cql("insert into cf (p, c, v) values (0, 0, 0)").get();
+        e.execute_cql("insert into cf (p, c, v) values (0, 1, 0)").get();
+
+        // Concurrent writes to different rows of the partition share the read of the existing rows.
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+        auto s = cf.schema();
+        std::vector<frozen_mutation> fms;
+        for (auto c : {0, 1}) {
+            mutation m(s, partition_key::from_singular(*s, 0));
+            m.set_clustered_cell(clustering_key::from_singular(*s, c), "v", data_value(c + 1), api::new_timestamp());
+            fms.push_back(freeze(m));
+        }
+        std::vector<future<>> writes;
+        for (auto& fm : fms) {
+            writes.push_back(e.local_db().apply(s, fm));
+        }
+        when_all_succeed(writes.begin(), writes.end()).get();
+        BOOST_REQUIRE_EQUAL(cf.get_view_stats().view_update_reads_batched, 1);
+
+        eventually([&] {
+            auto msg = e.execute_cql("select p, v, c from mv").get0();
+            assert_that(msg).is_rows().with_rows_ignore_order({
+                {{int32_type->decompose(0)}, {int32_type->decompose(1)}, {int32_type->decompose(0)}},
+                {{int32_type->decompose(0)}, {int32_type->decompose(2)}, {int32_type->decompose(1)}},
+            });
+        });
+    });
+}
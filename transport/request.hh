@@ -276,6 +276,25 @@ class request_reader {
 
         return options;
     }
+
+    // Reads the values bound by position, skipping the other query options.
+    // Returns nothing if the values are bound by name.
+    std::optional<std::vector<cql3::raw_value_view>> read_positional_values(uint8_t version) {
+        std::vector<cql3::raw_value_view> values;
+        if (version == 1) {
+            read_value_view_list(version, values);
+            return values;
+        }
+        read_consistency();
+        auto flags = enum_set<options_flag_enum>::from_mask(read_byte());
+        if (flags.contains<options_flag::NAMES_FOR_VALUES>()) {
+            return std::nullopt;
+        }
+        if (flags.contains<options_flag::VALUES>()) {
+            read_value_view_list(version, values);
+        }
+        return values;
+    }
 };
 
 }
@@ -105,6 +105,7 @@ class response {
     void compress(cql_compression compression);
     void compress_lz4();
     void compress_snappy();
+    void compress_zstd();
 
     template <typename CqlFrameHeaderType>
     sstring make_frame_one(uint8_t version, size_t length) {
@@ -30,6 +30,7 @@
 #include "cql3/statements/batch_statement.hh"
 #include "service/migration_manager.hh"
 #include "service/storage_service.hh"
+#include "database.hh"
 #include "db/consistency_level_type.hh"
 #include "db/write_type.hh"
 #include <seastar/core/future-util.hh>
@@ -53,6 +54,7 @@
 
 #include <snappy-c.h>
 #include <lz4.h>
+#include <zstd.h>
 
 #include "response.hh"
 #include "request.hh"
@@ -150,6 +152,8 @@ cql_load_balance parse_load_balance(sstring value)
         return cql_load_balance::none;
     } else if (value == "round-robin") {
         return cql_load_balance::round_robin;
+    } else if (value == "owning-shard") {
+        return cql_load_balance::owning_shard;
     } else {
         throw std::invalid_argument("Unknown load balancing algorithm: " + value);
     }
@@ -190,6 +194,12 @@ cql_server::cql_server(distributed<service::storage_proxy>& proxy, distributed<c
                             seastar::format("Holds an incrementing counter with the requests that ever blocked due to reaching the memory quota limit ({}B). "
                                             "The first derivative of this value shows how often we block due to memory exhaustion in the \"CQL transport\" component.", _max_request_size))),
 
+        sm::make_derive("requests_forwarded_to_owning_shard", _requests_forwarded_to_owning_shard,
+                        sm::description("Counts requests executing a prepared statement which were forwarded to the shard owning their partition.")),
+
+        sm::make_derive("requests_accepted_on_owning_shard", _requests_accepted_on_owning_shard,
+                        sm::description("Counts requests executing a prepared statement which were accepted by the shard owning their partition.")),
+
     });
 }
 
@@ -608,7 +618,7 @@ future<> cql_server::connection::process_request() {
             // Cause not understood.
             auto istream = buf.get_istream();
             [&] {
-                auto cpu = pick_request_cpu();
+                auto cpu = pick_request_cpu(op, istream);
                 return [&] {
                     if (cpu == engine().cpu_id()) {
                         return _process_request_stage(this, istream, op, stream, service::client_state(service::client_state::request_copy_tag{}, _client_state, _client_state.get_timestamp()), tracing_requested);
@@ -662,6 +672,96 @@ void on_compression_buffer_use() {
 
 }
 
+// Zstandard frames are compressed and decompressed in a streaming fashion,
+// fragment by fragment, so unlike with the other algorithms neither the
+// input nor the output of large frames is linearized.
+namespace zstd_streams {
+
+static constexpr int compression_level = 3;
+
+static ZSTD_CStream* local_cstream() {
+    static thread_local std::unique_ptr<ZSTD_CStream, size_t(*)(ZSTD_CStream*)> stream(ZSTD_createCStream(), ZSTD_freeCStream);
+    return stream.get();
+}
+
+static ZSTD_DStream* local_dstream() {
+    static thread_local std::unique_ptr<ZSTD_DStream, size_t(*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+    return stream.get();
+}
+
+static size_t check(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("CQL frame Zstd {} failure: {}", what, ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+// Decompresses a frame into fragments of at most default_fragment_size.
+// Fails if the decompressed frame is larger than max_length.
+static fragmented_temporary_buffer decompress(fragmented_temporary_buffer::view in, size_t max_length) {
+    auto ds = local_dstream();
+    check(ZSTD_initDStream(ds), "uncompression");
+
+    // Allocate no more than the decompressed size, if the frame header has it.
+    size_t expected_length = fragmented_temporary_buffer::default_fragment_size;
+    if (!in.empty()) {
+        auto first = *in.begin();
+        auto content_size = ZSTD_getFrameContentSize(first.data(), first.size());
+        if (content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR) {
+            expected_length = std::min<unsigned long long>(content_size, max_length);
+        }
+    }
+
+    std::vector<temporary_buffer<char>> fragments;
+    size_t length = 0;
+    temporary_buffer<char> fragment;
+    ZSTD_outBuffer output{nullptr, 0, 0};
+    auto next_fragment = [&] {
+        if (output.pos) {
+            fragment.trim(output.pos);
+            fragments.push_back(std::move(fragment));
+            length += output.pos;
+        }
+        if (length >= max_length) {
+            throw exceptions::protocol_exception(format("CQL frame uncompressed size exceeds {:d} bytes", max_length));
+        }
+        auto size = fragmented_temporary_buffer::default_fragment_size;
+        if (length < expected_length) {
+            size = std::min(size, expected_length - length);
+        }
+        fragment = temporary_buffer<char>(size);
+        output = ZSTD_outBuffer{fragment.get_write(), size, 0};
+    };
+
+    size_t left = 0;
+    for (bytes_view in_fragment : in) {
+        ZSTD_inBuffer input{in_fragment.data(), in_fragment.size(), 0};
+        while (input.pos < input.size) {
+            if (output.pos == output.size) {
+                next_fragment();
+            }
+            left = check(ZSTD_decompressStream(ds, &output, &input), "uncompression");
+        }
+    }
+    // All input was consumed, but the output may not have fit.
+    while (left) {
+        if (output.pos < output.size) {
+            throw exceptions::protocol_exception("Truncated CQL frame Zstd data");
+        }
+        next_fragment();
+        ZSTD_inBuffer input{nullptr, 0, 0};
+        left = check(ZSTD_decompressStream(ds, &output, &input), "uncompression");
+    }
+    if (output.pos) {
+        fragment.trim(output.pos);
+        fragments.push_back(std::move(fragment));
+        length += output.pos;
+    }
+    return fragmented_temporary_buffer(std::move(fragments), length);
+}
+
+}
+
 future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_frame(size_t length, uint8_t flags)
 {
     using namespace compression_buffers;
@@ -706,6 +806,10 @@ future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_
                 on_compression_buffer_use();
                 return uncomp;
             });
+        } else if (_compression == cql_compression::zstd) {
+            return _buffer_reader.read_exactly(_read_buf, length).then([this] (fragmented_temporary_buffer buf) {
+                return zstd_streams::decompress(fragmented_temporary_buffer::view(buf), _server._max_request_size);
+            });
         } else {
             throw exceptions::protocol_exception(format("Unknown compression algorithm"));
         }
@@ -713,14 +817,64 @@ future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_
     return _buffer_reader.read_exactly(_read_buf, length);
 }
 
-unsigned cql_server::connection::pick_request_cpu()
+unsigned cql_server::connection::pick_request_cpu(uint8_t op, fragmented_temporary_buffer::istream is)
 {
     if (_server._lb == cql_load_balance::round_robin) {
         return _request_cpu++ % smp::count;
     }
+    if (_server._lb == cql_load_balance::owning_shard && static_cast<cql_binary_opcode>(op) == cql_binary_opcode::EXECUTE
+            && _client_state.get_auth_state() == service::client_state::auth_state::READY) {
+        std::optional<unsigned> shard;
+        try {
+            shard = owning_shard_of_execute(is);
+        } catch (...) {
+            // The request is malformed or refers to something which doesn't
+            // exist anymore, let processing it report the error.
+        }
+        if (shard) {
+            if (*shard == engine().cpu_id()) {
+                ++_server._requests_accepted_on_owning_shard;
+            } else {
+                ++_server._requests_forwarded_to_owning_shard;
+            }
+            return *shard;
+        }
+    }
     return engine().cpu_id();
 }
 
+// Returns the shard owning the partition of the prepared statement executed
+// by the request, if the request binds all of its partition key columns.
+// Statements which may access several partitions, like batches, are
+// routed by one of them. Only the placement of the request depends on
+// this, not its result.
+std::optional<unsigned> cql_server::connection::owning_shard_of_execute(fragmented_temporary_buffer::istream is)
+{
+    bytes_ostream linearization_buffer;
+    auto in = request_reader(is, linearization_buffer);
+    cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
+    auto prepared = _server._query_processor.local().get_prepared(cache_key);
+    if (!prepared || prepared->partition_key_bind_indices.empty()) {
+        return std::nullopt;
+    }
+    auto values = in.read_positional_values(_version);
+    if (!values) {
+        return std::nullopt;
+    }
+    auto& spec = prepared->bound_names[prepared->partition_key_bind_indices.front()];
+    auto s = _server._proxy.local().get_db().local().find_schema(spec->ks_name, spec->cf_name);
+    std::vector<bytes> components;
+    components.reserve(prepared->partition_key_bind_indices.size());
+    for (auto i : prepared->partition_key_bind_indices) {
+        if (i >= values->size() || !(*values)[i]) {
+            return std::nullopt;
+        }
+        components.push_back(to_bytes((*values)[i]));
+    }
+    auto key = partition_key::from_exploded(*s, components);
+    return dht::shard_of(dht::global_partitioner().get_token(*s, key));
+}
+
 future<response_type> cql_server::connection::process_startup(uint16_t stream, request_reader in, service::client_state client_state)
 {
     auto options = in.read_string_map();
@@ -732,6 +886,8 @@ future<response_type> cql_server::connection::process_startup(uint16_t stream, r
              _compression = cql_compression::lz4;
          } else if (compression == "snappy") {
              _compression = cql_compression::snappy;
+         } else if (compression == "zstd") {
+             _compression = cql_compression::zstd;
          } else {
              throw exceptions::protocol_exception(format("Unknown compression algorithm: {}", compression));
          }
@@ -1128,6 +1284,7 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_supported(int
     opts.insert({"CQL_VERSION", cql3::query_processor::CQL_VERSION});
     opts.insert({"COMPRESSION", "lz4"});
     opts.insert({"COMPRESSION", "snappy"});
+    opts.insert({"COMPRESSION", "zstd"});
     if (_server._config.allow_shard_aware_drivers) {
         auto& part = dht::global_partitioner();
         opts.insert({"SCYLLA_SHARD", format("{:d}", engine().cpu_id())});
@@ -1289,6 +1446,9 @@ void cql_server::response::compress(cql_compression compression)
     case cql_compression::snappy:
         compress_snappy();
         break;
+    case cql_compression::zstd:
+        compress_zstd();
+        break;
     default:
         throw std::invalid_argument("Invalid CQL compression algorithm");
     }
@@ -1340,6 +1500,42 @@ void cql_server::response::compress_snappy()
     on_compression_buffer_use();
 }
 
+void cql_server::response::compress_zstd()
+{
+    auto cs = zstd_streams::local_cstream();
+    zstd_streams::check(ZSTD_initCStream(cs, zstd_streams::compression_level), "compression");
+
+    // The first chunk is allocated large enough for the whole compressed
+    // body of small responses, without wasting memory on them.
+    bytes_ostream compressed;
+    size_t chunk_size = std::min(ZSTD_compressBound(_body.size()), bytes_ostream::max_chunk_size());
+    ZSTD_outBuffer output{nullptr, 0, 0};
+    auto next_chunk = [&] {
+        compressed.remove_suffix(output.size - output.pos);
+        output = ZSTD_outBuffer{compressed.write_place_holder(chunk_size), chunk_size, 0};
+        chunk_size = bytes_ostream::max_chunk_size();
+    };
+
+    for (bytes_view fragment : _body) {
+        ZSTD_inBuffer input{fragment.data(), fragment.size(), 0};
+        while (input.pos < input.size) {
+            if (output.pos == output.size) {
+                next_chunk();
+            }
+            zstd_streams::check(ZSTD_compressStream(cs, &output, &input), "compression");
+        }
+    }
+    size_t left;
+    do {
+        if (output.pos == output.size) {
+            next_chunk();
+        }
+        left = zstd_streams::check(ZSTD_endStream(cs, &output), "compression");
+    } while (left);
+    compressed.remove_suffix(output.size - output.pos);
+    _body = std::move(compressed);
+}
+
 void cql_server::response::serialize(const event::schema_change& event, uint8_t version)
 {
     if (version >= 3) {
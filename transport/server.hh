@@ -55,6 +55,9 @@ enum class cql_compression {
     none,
     lz4,
     snappy,
+    // Not part of the CQL specification. The body of a compressed frame
+    // is a single Zstandard frame.
+    zstd,
 };
 
 enum cql_frame_flags {
@@ -92,6 +95,10 @@ struct [[gnu::packed]] cql_binary_frame_v3 {
 enum class cql_load_balance {
     none,
     round_robin,
+    // Prepared statements are executed on the shard owning the partition
+    // whose key is bound by the request, other requests on the shard
+    // which accepted them.
+    owning_shard,
 };
 
 cql_load_balance parse_load_balance(sstring value);
@@ -131,6 +138,8 @@ class cql_server {
     uint64_t _requests_served = 0;
     uint64_t _requests_serving = 0;
     uint64_t _requests_blocked_memory = 0;
+    uint64_t _requests_forwarded_to_owning_shard = 0;
+    uint64_t _requests_accepted_on_owning_shard = 0;
     cql_load_balance _lb;
     auth::service& _auth_service;
 public:
@@ -139,6 +148,12 @@ class cql_server {
     future<> listen(socket_address addr, std::shared_ptr<seastar::tls::credentials_builder> = {}, bool keepalive = false);
     future<> do_accepts(int which, bool keepalive, socket_address server_addr);
     future<> stop();
+    uint64_t requests_forwarded_to_owning_shard() const {
+        return _requests_forwarded_to_owning_shard;
+    }
+    uint64_t requests_accepted_on_owning_shard() const {
+        return _requests_accepted_on_owning_shard;
+    }
 public:
     using response = cql_transport::response;
     using response_type = std::pair<std::unique_ptr<cql_server::response>, service::client_state>;
@@ -196,7 +211,8 @@ class cql_server {
         friend class process_request_executor;
         future<processing_result> process_request_one(fragmented_temporary_buffer::istream buf, uint8_t op, uint16_t stream, service::client_state client_state, tracing_request_type tracing_request);
         unsigned frame_size() const;
-        unsigned pick_request_cpu();
+        unsigned pick_request_cpu(uint8_t op, fragmented_temporary_buffer::istream is);
+        std::optional<unsigned> owning_shard_of_execute(fragmented_temporary_buffer::istream is);
         void update_client_state(processing_result& r);
         cql_binary_frame_v3 parse_frame(temporary_buffer<char> buf);
         future<fragmented_temporary_buffer> read_and_decompress_frame(size_t length, uint8_t flags);
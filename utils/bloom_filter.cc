@@ -49,6 +49,10 @@
 #include <cstdlib>
 #include "bloom_filter.hh"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace utils {
 namespace filter {
 
@@ -88,6 +92,108 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+// Salts used to derive the bit set in each word of a block from the key
+// hash, as in the Parquet split block bloom filter.
+alignas(32) static constexpr uint32_t split_block_salt[split_block_bloom_filter::words_per_block] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+static inline uint32_t split_block_bit(uint32_t key, int word) {
+    return uint32_t(1) << ((key * split_block_salt[word]) >> 27);
+}
+
+static bool split_block_check_scalar(const uint32_t* block, uint32_t key) {
+    for (int i = 0; i < split_block_bloom_filter::words_per_block; ++i) {
+        if (!(block[i] & split_block_bit(key, i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+[[gnu::target("avx2")]]
+static bool split_block_check_avx2(const uint32_t* block, uint32_t key) {
+    auto salt = _mm256_load_si256(reinterpret_cast<const __m256i*>(split_block_salt));
+    auto shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salt), 27);
+    auto mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+    auto bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    return _mm256_testc_si256(bits, mask);
+}
+
+// SSE has no per-lane variable shift, so 1 << n is computed as the float
+// 2^n (by placing n + 127 in the exponent) converted back to an integer.
+// For n == 31 the conversion overflows into 0x80000000, which happens to
+// be the expected result.
+[[gnu::target("sse4.1")]]
+static inline __m128i split_block_mask_sse41(__m128i key, const uint32_t* salt) {
+    auto shifts = _mm_srli_epi32(_mm_mullo_epi32(key, _mm_load_si128(reinterpret_cast<const __m128i*>(salt))), 27);
+    auto exponent = _mm_slli_epi32(_mm_add_epi32(shifts, _mm_set1_epi32(127)), 23);
+    return _mm_cvttps_epi32(_mm_castsi128_ps(exponent));
+}
+
+[[gnu::target("sse4.1")]]
+static bool split_block_check_sse41(const uint32_t* block, uint32_t key) {
+    auto k = _mm_set1_epi32(key);
+    auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 4));
+    return _mm_testc_si128(lo, split_block_mask_sse41(k, split_block_salt))
+        && _mm_testc_si128(hi, split_block_mask_sse41(k, split_block_salt + 4));
+}
+
+#endif
+
+using split_block_check_fn = bool (*)(const uint32_t* block, uint32_t key);
+
+static split_block_check_fn resolve_split_block_check() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return split_block_check_avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return split_block_check_sse41;
+    }
+#endif
+    return split_block_check_scalar;
+}
+
+static const split_block_check_fn split_block_check = resolve_split_block_check();
+
+split_block_bloom_filter::split_block_bloom_filter(bitmap&& bs)
+    : bloom_filter(hashes, std::move(bs), filter_format::m_format)
+    , _nr_blocks(bits().size() / bits_per_block)
+{
+    assert(_nr_blocks > 0);
+}
+
+uint32_t* split_block_bloom_filter::block(hashed_key key) {
+    // Maps the high half of the first hash uniformly onto [0, _nr_blocks)
+    // without a division.
+    auto idx = ((key.hash()[0] >> 32) * _nr_blocks) >> 32;
+    static constexpr size_t storage_words_per_block = bits_per_block / 64;
+    return reinterpret_cast<uint32_t*>(&bits().word(idx * storage_words_per_block));
+}
+
+bool split_block_bloom_filter::is_present(hashed_key key) {
+    return split_block_check(block(key), uint32_t(key.hash()[1]));
+}
+
+bool split_block_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+void split_block_bloom_filter::add(const bytes_view& key) {
+    auto hk = make_hashed_key(key);
+    auto b = block(hk);
+    auto k = uint32_t(hk.hash()[1]);
+    for (int i = 0; i < words_per_block; ++i) {
+        b[i] |= split_block_bit(k, i);
+    }
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
@@ -98,5 +204,15 @@ filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter
     large_bitset bitset(num_bits);
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
+
+filter_ptr create_split_block_filter(large_bitset&& bitset) {
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
+
+filter_ptr create_split_block_filter(int64_t num_elements, int buckets_per) {
+    int64_t num_bits = align_up<int64_t>(num_elements * buckets_per, split_block_bloom_filter::bits_per_block);
+    large_bitset bitset(std::max<int64_t>(num_bits, split_block_bloom_filter::bits_per_block));
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
 }
 }
@@ -93,6 +93,33 @@ struct murmur3_bloom_filter: public bloom_filter {
     {}
 };
 
+// A split block bloom filter: the bitmap is divided into 256-bit blocks,
+// and all the bits of a key are set in a single block, one bit in each of
+// its eight 32-bit words. A lookup thus costs one cache miss, instead of
+// one per hash function, and the eight words are probed at once with SIMD
+// instructions when the CPU supports them.
+//
+// This is not compatible with Cassandra's filter; sstables using it are
+// marked as such in the Scylla component.
+class split_block_bloom_filter: public bloom_filter {
+public:
+    static constexpr size_t bits_per_block = 256;
+    static constexpr int words_per_block = 8;
+    static constexpr int hashes = words_per_block;
+private:
+    size_t _nr_blocks;
+
+    uint32_t* block(hashed_key key);
+public:
+    explicit split_block_bloom_filter(bitmap&& bs);
+
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+};
+
 struct always_present_filter: public i_filter {
 
     virtual bool is_present(const bytes_view& key) override {
@@ -116,5 +143,8 @@ struct always_present_filter: public i_filter {
 
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format);
 filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter_format format);
+
+filter_ptr create_split_block_filter(large_bitset&& bitset);
+filter_ptr create_split_block_filter(int64_t num_elements, int buckets_per);
 }
 }
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Approximate access frequency of hashed items, as used by TinyLFU.
+//
+// Counts are kept in a count-min sketch of small saturating counters,
+// preceded by a single-bit doorkeeper which absorbs the first occurrence
+// of each item, so that the sketch isn't polluted by one-hit wonders.
+//
+// After sample_size() recorded occurrences all counts are halved and the
+// doorkeeper is cleared, so that the estimates follow changes in the
+// access pattern.
+class frequency_sketch {
+    static constexpr unsigned depth = 4;
+    static constexpr uint8_t max_count = 15;
+
+    std::vector<uint8_t> _counters;
+    std::vector<uint64_t> _doorkeeper;
+    size_t _mask;
+    size_t _additions = 0;
+private:
+    static uint64_t mix(uint64_t h, unsigned seed) noexcept {
+        h += (seed + 1) * 0x9e3779b97f4a7c15ULL;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+    size_t index(uint64_t hash, unsigned row) const noexcept {
+        return row * (_mask + 1) + (mix(hash, row) & _mask);
+    }
+    size_t doorkeeper_bit(uint64_t hash) const noexcept {
+        return mix(hash, depth) & (_doorkeeper.size() * 64 - 1);
+    }
+    bool in_doorkeeper(uint64_t hash) const noexcept {
+        auto bit = doorkeeper_bit(hash);
+        return _doorkeeper[bit / 64] & (uint64_t(1) << (bit % 64));
+    }
+    uint8_t min_count(uint64_t hash) const noexcept {
+        uint8_t result = max_count;
+        for (unsigned row = 0; row < depth; ++row) {
+            result = std::min(result, _counters[index(hash, row)]);
+        }
+        return result;
+    }
+    void age() noexcept {
+        for (auto& c : _counters) {
+            c >>= 1;
+        }
+        std::fill(_doorkeeper.begin(), _doorkeeper.end(), 0);
+        _additions /= 2;
+    }
+public:
+    // width is the number of counters in each of the rows of the sketch,
+    // must be a power of two. It should be comparable to the number of
+    // distinct items whose frequency is of interest.
+    explicit frequency_sketch(size_t width)
+        : _counters(width * depth)
+        , _doorkeeper(std::max<size_t>(width / 64, 1))
+        , _mask(width - 1) {
+        assert(width && (width & (width - 1)) == 0);
+    }
+
+    size_t sample_size() const noexcept {
+        return _counters.size() / depth * 10;
+    }
+
+    // Records an occurrence of the item. Returns true if the sketch was aged
+    // as a result.
+    bool record(uint64_t hash) noexcept {
+        auto bit = doorkeeper_bit(hash);
+        auto& word = _doorkeeper[bit / 64];
+        if (!(word & (uint64_t(1) << (bit % 64)))) {
+            word |= uint64_t(1) << (bit % 64);
+        } else {
+            // Conservative update: only the counters which determine the
+            // estimate are incremented.
+            auto current = min_count(hash);
+            if (current < max_count) {
+                for (unsigned row = 0; row < depth; ++row) {
+                    auto& c = _counters[index(hash, row)];
+                    if (c == current) {
+                        ++c;
+                    }
+                }
+            }
+        }
+        if (++_additions >= sample_size()) {
+            age();
+            return true;
+        }
+        return false;
+    }
+
+    unsigned estimate(uint64_t hash) const noexcept {
+        return min_count(hash) + unsigned(in_doorkeeper(hash));
+    }
+
+    void clear() noexcept {
+        std::fill(_counters.begin(), _counters.end(), 0);
+        std::fill(_doorkeeper.begin(), _doorkeeper.end(), 0);
+        _additions = 0;
+    }
+};
+
+}
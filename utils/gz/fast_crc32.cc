@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Folding CRC32 based on "Fast CRC Computation for Generic Polynomials Using
+ * PCLMULQDQ Instruction" by Gopal et al., Intel, 2009.
+ *
+ * The input is split into 128-bit (or 512-bit) lanes. Each lane L, followed by
+ * d bits of data D, is replaced by a value congruent with it modulo G(x):
+ *
+ *   L(x) * x^d + D(x) = L_hi(x) * x^(d+64) + L_lo(x) * x^d + D(x)
+ *                     = L_hi(x) * (x^(d+64) mod G(x)) + L_lo(x) * (x^d mod G(x)) + D(x)  (mod G(x))
+ *
+ * Both products are carry-less multiplications of 64-bit by 33-bit values, so
+ * several lanes are folded independently until the end of the input, and then
+ * into each other. The remaining 128 bits are reduced to 32 with a final fold
+ * and a Barrett reduction.
+ *
+ * As in crc_combine.cc, polynomials are bit-reversed. The folding constants
+ * are x^(d+32) mod G(x) and x^(d-32) mod G(x) for the folding distance d,
+ * bit-reversed and shifted left by one.
+ */
+
+#include "utils/gz/fast_crc32.hh"
+
+#include <zlib.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+static uint32_t generic_crc32(uint32_t crc, const char* buf, size_t len) {
+    return crc32(crc, reinterpret_cast<const unsigned char*>(buf), len);
+}
+
+#if defined(__x86_64__)
+
+// Folding distance 4 * 128 bits.
+static constexpr uint64_t k_fold_512_lo = 0x154442bd4;
+static constexpr uint64_t k_fold_512_hi = 0x1c6e41596;
+// Folding distance 128 bits.
+static constexpr uint64_t k_fold_128_lo = 0x1751997d0;
+static constexpr uint64_t k_fold_128_hi = 0x0ccaa009e;
+// Folding distance 4 * 512 bits.
+static constexpr uint64_t k_fold_2048_lo = 0x11542778a;
+static constexpr uint64_t k_fold_2048_hi = 0x1322d1430;
+// x^64 mod G(x), for folding 64 bits into 32.
+static constexpr uint64_t k_fold_64 = 0x163cd6124;
+// G(x) and floor(x^64 / G(x)), for the Barrett reduction.
+static constexpr uint64_t k_poly = 0x1db710641;
+static constexpr uint64_t k_mu = 0x1f7011641;
+
+[[gnu::target("pclmul,sse4.1")]]
+static inline __m128i fold_128(__m128i x, __m128i k, __m128i data) {
+    auto lo = _mm_clmulepi64_si128(x, k, 0x00);
+    auto hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(lo, hi), data);
+}
+
+// Folds the remaining 16-byte blocks into x, reduces it and processes the
+// tail shorter than a block. Returns the bit-inverted CRC, as zlib does.
+[[gnu::target("pclmul,sse4.1")]]
+static uint32_t finish_crc32(__m128i x, const char* buf, size_t len) {
+    auto k = _mm_set_epi64x(k_fold_128_hi, k_fold_128_lo);
+    while (len >= 16) {
+        x = fold_128(x, k, _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf)));
+        buf += 16;
+        len -= 16;
+    }
+
+    auto mask32 = _mm_set_epi32(0, 0, 0, ~0);
+
+    // 128 bits to 64, appending 32 zero bits.
+    auto t = _mm_clmulepi64_si128(x, k, 0x10);
+    x = _mm_xor_si128(_mm_srli_si128(x, 8), t);
+
+    // 64 bits to 32.
+    t = _mm_srli_si128(x, 4);
+    x = _mm_and_si128(x, mask32);
+    x = _mm_clmulepi64_si128(x, _mm_set_epi64x(0, k_fold_64), 0x00);
+    x = _mm_xor_si128(x, t);
+
+    // Barrett reduction.
+    auto poly = _mm_set_epi64x(k_mu, k_poly);
+    t = x;
+    x = _mm_and_si128(x, mask32);
+    x = _mm_clmulepi64_si128(x, poly, 0x10);
+    x = _mm_and_si128(x, mask32);
+    x = _mm_clmulepi64_si128(x, poly, 0x00);
+    x = _mm_xor_si128(x, t);
+
+    uint32_t crc = ~uint32_t(_mm_extract_epi32(x, 1));
+    return generic_crc32(crc, buf, len);
+}
+
+[[gnu::target("pclmul,sse4.1")]]
+static uint32_t pclmul_crc32(uint32_t crc, const char* buf, size_t len) {
+    if (len < 64) {
+        return generic_crc32(crc, buf, len);
+    }
+    auto in = reinterpret_cast<const __m128i*>(buf);
+    auto x1 = _mm_xor_si128(_mm_loadu_si128(in), _mm_cvtsi32_si128(~crc));
+    auto x2 = _mm_loadu_si128(in + 1);
+    auto x3 = _mm_loadu_si128(in + 2);
+    auto x4 = _mm_loadu_si128(in + 3);
+    buf += 64;
+    len -= 64;
+
+    auto k = _mm_set_epi64x(k_fold_512_hi, k_fold_512_lo);
+    while (len >= 64) {
+        in = reinterpret_cast<const __m128i*>(buf);
+        x1 = fold_128(x1, k, _mm_loadu_si128(in));
+        x2 = fold_128(x2, k, _mm_loadu_si128(in + 1));
+        x3 = fold_128(x3, k, _mm_loadu_si128(in + 2));
+        x4 = fold_128(x4, k, _mm_loadu_si128(in + 3));
+        buf += 64;
+        len -= 64;
+    }
+
+    k = _mm_set_epi64x(k_fold_128_hi, k_fold_128_lo);
+    x1 = fold_128(x1, k, x2);
+    x1 = fold_128(x1, k, x3);
+    x1 = fold_128(x1, k, x4);
+    return finish_crc32(x1, buf, len);
+}
+
+[[gnu::target("avx512f,vpclmulqdq,pclmul,sse4.1")]]
+static inline __m512i fold_512(__m512i x, __m512i k, __m512i data) {
+    auto lo = _mm512_clmulepi64_epi128(x, k, 0x00);
+    auto hi = _mm512_clmulepi64_epi128(x, k, 0x11);
+    return _mm512_xor_si512(_mm512_xor_si512(lo, hi), data);
+}
+
+[[gnu::target("avx512f,vpclmulqdq,pclmul,sse4.1")]]
+static uint32_t avx512_vpclmul_crc32(uint32_t crc, const char* buf, size_t len) {
+    if (len < 256) {
+        return pclmul_crc32(crc, buf, len);
+    }
+    auto first = _mm512_inserti32x4(_mm512_setzero_si512(), _mm_cvtsi32_si128(~crc), 0);
+    auto x1 = _mm512_xor_si512(_mm512_loadu_si512(buf), first);
+    auto x2 = _mm512_loadu_si512(buf + 64);
+    auto x3 = _mm512_loadu_si512(buf + 128);
+    auto x4 = _mm512_loadu_si512(buf + 192);
+    buf += 256;
+    len -= 256;
+
+    auto k = _mm512_set_epi64(k_fold_2048_hi, k_fold_2048_lo, k_fold_2048_hi, k_fold_2048_lo,
+                              k_fold_2048_hi, k_fold_2048_lo, k_fold_2048_hi, k_fold_2048_lo);
+    while (len >= 256) {
+        x1 = fold_512(x1, k, _mm512_loadu_si512(buf));
+        x2 = fold_512(x2, k, _mm512_loadu_si512(buf + 64));
+        x3 = fold_512(x3, k, _mm512_loadu_si512(buf + 128));
+        x4 = fold_512(x4, k, _mm512_loadu_si512(buf + 192));
+        buf += 256;
+        len -= 256;
+    }
+
+    k = _mm512_set_epi64(k_fold_512_hi, k_fold_512_lo, k_fold_512_hi, k_fold_512_lo,
+                         k_fold_512_hi, k_fold_512_lo, k_fold_512_hi, k_fold_512_lo);
+    x1 = fold_512(x1, k, x2);
+    x1 = fold_512(x1, k, x3);
+    x1 = fold_512(x1, k, x4);
+    while (len >= 64) {
+        x1 = fold_512(x1, k, _mm512_loadu_si512(buf));
+        buf += 64;
+        len -= 64;
+    }
+
+    auto k128 = _mm_set_epi64x(k_fold_128_hi, k_fold_128_lo);
+    auto x = _mm512_maskz_extracti32x4_epi32(0xf, x1, 0);
+    x = fold_128(x, k128, _mm512_maskz_extracti32x4_epi32(0xf, x1, 1));
+    x = fold_128(x, k128, _mm512_maskz_extracti32x4_epi32(0xf, x1, 2));
+    x = fold_128(x, k128, _mm512_maskz_extracti32x4_epi32(0xf, x1, 3));
+    return finish_crc32(x, buf, len);
+}
+
+bool fast_crc32_supported(fast_crc32_implementation impl) {
+    __builtin_cpu_init();
+    switch (impl) {
+    case fast_crc32_implementation::avx512_vpclmul:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("vpclmulqdq");
+    case fast_crc32_implementation::pclmul:
+        return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    case fast_crc32_implementation::generic:
+        return true;
+    }
+    return false;
+}
+
+#else
+
+bool fast_crc32_supported(fast_crc32_implementation impl) {
+    return impl == fast_crc32_implementation::generic;
+}
+
+#endif
+
+static fast_crc32_implementation select_implementation() {
+    if (fast_crc32_supported(fast_crc32_implementation::avx512_vpclmul)) {
+        return fast_crc32_implementation::avx512_vpclmul;
+    }
+    if (fast_crc32_supported(fast_crc32_implementation::pclmul)) {
+        return fast_crc32_implementation::pclmul;
+    }
+    return fast_crc32_implementation::generic;
+}
+
+fast_crc32_implementation fast_crc32_selected_implementation() {
+    static const fast_crc32_implementation selected = select_implementation();
+    return selected;
+}
+
+uint32_t fast_crc32(fast_crc32_implementation impl, uint32_t crc, const char* buf, size_t len) {
+    switch (impl) {
+#if defined(__x86_64__)
+    case fast_crc32_implementation::avx512_vpclmul:
+        return avx512_vpclmul_crc32(crc, buf, len);
+    case fast_crc32_implementation::pclmul:
+        return pclmul_crc32(crc, buf, len);
+#endif
+    default:
+        return generic_crc32(crc, buf, len);
+    }
+}
+
+uint32_t fast_crc32(uint32_t crc, const char* buf, size_t len) {
+    return fast_crc32(fast_crc32_selected_implementation(), crc, buf, len);
+}
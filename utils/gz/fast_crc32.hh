@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2019 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Computes CRC32 (gzip format, RFC 1952) of the buffer, continuing from crc,
+ * which is the CRC32 of the preceding data (0 for none). Same as zlib's crc32().
+ *
+ * On x86 the buffer is folded in several independent streams with carry-less
+ * multiplication, using AVX-512 VPCLMULQDQ or PCLMULQDQ, whichever the CPU
+ * supports. The implementation is chosen at runtime.
+ */
+uint32_t fast_crc32(uint32_t crc, const char* buf, size_t len);
+
+enum class fast_crc32_implementation {
+    generic,
+    pclmul,
+    avx512_vpclmul,
+};
+
+bool fast_crc32_supported(fast_crc32_implementation impl);
+
+// The implementation fast_crc32() uses on this CPU.
+fast_crc32_implementation fast_crc32_selected_implementation();
+
+// Computes the checksum with the given implementation, which must be
+// supported by the CPU. For tests and benchmarks.
+uint32_t fast_crc32(fast_crc32_implementation impl, uint32_t crc, const char* buf, size_t len);
@@ -84,5 +84,11 @@ struct i_filter {
      *         filter.
      */
     static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format);
+
+    /**
+     * @return A split block bloom filter using as many bits per element as
+     *         get_filter() would for the same false positive probability.
+     */
+    static filter_ptr get_split_block_filter(int64_t num_elements, double max_false_pos_prob);
 };
 }
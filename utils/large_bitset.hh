@@ -79,4 +79,14 @@ class large_bitset {
     const utils::chunked_vector<int_type>& get_storage() const {
         return _storage;
     }
+
+    // Gives direct access to the idx-th word of the storage. Runs of
+    // words aligned to a power of two no larger than a storage fragment
+    // are contiguous in memory.
+    int_type& word(size_t idx) {
+        return _storage[idx];
+    }
+    const int_type& word(size_t idx) const {
+        return _storage[idx];
+    }
 };